@@ -11,6 +11,23 @@
                 "src/cpp/element.cpp",
                 "src/cpp/type-conversion.cpp",
                 "src/cpp/pipeline.cpp",
+                "src/cpp/tracing.cpp",
+                "src/cpp/profiler.cpp",
+                "src/cpp/queue-monitor.cpp",
+                "src/cpp/thread-policy.cpp",
+                "src/cpp/audio-meter.cpp",
+                "src/cpp/motion-detector.cpp",
+                "src/cpp/luma.cpp",
+                "src/cpp/fingerprint.cpp",
+                "src/cpp/samples.cpp",
+                "src/cpp/encoder-pool.cpp",
+                "src/cpp/video-frame.cpp",
+                "src/cpp/prerecord-ring.cpp",
+                "src/cpp/keyframe-index.cpp",
+                "src/cpp/memory-source.cpp",
+                "src/cpp/fd-pump.cpp",
+                "src/cpp/buffer-arena.cpp",
+                "src/cpp/sample-dispatcher.cpp",
             ],
             "dependencies": ["<!(node -p \"require('node-addon-api').gyp\")"],
             "defines": [
@@ -32,7 +49,7 @@
                 "VCLinkerTool": {
                     "SetChecksum": "true",
                     "AdditionalLibraryDirectories": [
-                        "<!@(node -p \"require('child_process').execSync('pkg-config --libs-only-L gstreamer-1.0 gstreamer-app-1.0 gstreamer-rtp-1.0 glib-2.0 gobject-2.0').toString().trim().split('-L').slice(1).map(f => f.trim().replace(/\\\\\\\\ /g, ' ')).join(';')\")"
+                        "<!@(node -p \"require('child_process').execSync('pkg-config --libs-only-L gstreamer-1.0 gstreamer-app-1.0 gstreamer-rtp-1.0 gstreamer-controller-1.0 gstreamer-audio-1.0 gstreamer-video-1.0 glib-2.0 gobject-2.0').toString().trim().split('-L').slice(1).map(f => f.trim().replace(/\\\\\\\\ /g, ' ')).join(';')\")"
                     ],
                 },
             },
@@ -42,6 +59,9 @@
                 "<!@(node -p \"require('child_process').execSync('pkg-config --cflags-only-I gstreamer-1.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-I/, '')).join(' ')\")",
                 "<!@(node -p \"require('child_process').execSync('pkg-config --cflags-only-I gstreamer-app-1.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-I/, '')).join(' ')\")",
                 "<!@(node -p \"require('child_process').execSync('pkg-config --cflags-only-I gstreamer-rtp-1.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-I/, '')).join(' ')\")",
+                "<!@(node -p \"require('child_process').execSync('pkg-config --cflags-only-I gstreamer-controller-1.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-I/, '')).join(' ')\")",
+                "<!@(node -p \"require('child_process').execSync('pkg-config --cflags-only-I gstreamer-audio-1.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-I/, '')).join(' ')\")",
+                "<!@(node -p \"require('child_process').execSync('pkg-config --cflags-only-I gstreamer-video-1.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-I/, '')).join(' ')\")",
                 "<!@(node -p \"require('child_process').execSync('pkg-config --cflags-only-I glib-2.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-I/, '')).join(' ')\")",
                 "<!@(node -p \"require('child_process').execSync('pkg-config --cflags-only-I gobject-2.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-I/, '')).join(' ')\")",
             ],
@@ -50,7 +70,7 @@
                     "OS=='win'",
                     {
                         "libraries": [
-                            "<!@(node -p \"require('child_process').execSync('pkg-config --libs-only-l gstreamer-1.0 gstreamer-app-1.0 gstreamer-rtp-1.0 glib-2.0 gobject-2.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-l/, '') + '.lib').filter(f => f !== '.lib').join(' ')\")"
+                            "<!@(node -p \"require('child_process').execSync('pkg-config --libs-only-l gstreamer-1.0 gstreamer-app-1.0 gstreamer-rtp-1.0 gstreamer-controller-1.0 gstreamer-audio-1.0 gstreamer-video-1.0 glib-2.0 gobject-2.0').toString().trim().split(/\\s+/).map(f => f.replace(/^-l/, '') + '.lib').filter(f => f !== '.lib').join(' ')\")"
                         ]
                     },
                 ],
@@ -58,7 +78,7 @@
                     "OS!='win'",
                     {
                         "libraries": [
-                            "<!@(node -p \"require('child_process').execSync('pkg-config --libs-only-l gstreamer-1.0 gstreamer-app-1.0 gstreamer-rtp-1.0 glib-2.0 gobject-2.0').toString().trim()\")"
+                            "<!@(node -p \"require('child_process').execSync('pkg-config --libs-only-l gstreamer-1.0 gstreamer-app-1.0 gstreamer-rtp-1.0 gstreamer-controller-1.0 gstreamer-audio-1.0 gstreamer-video-1.0 glib-2.0 gobject-2.0').toString().trim()\")"
                         ]
                     },
                 ],
@@ -0,0 +1,48 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc is-live=true num-buffers=150 ! video/x-raw,width=640,height=360,framerate=30/1 ! " +
+    "videoconvert ! appsink name=sink"
+);
+const sink = pipeline.getElementByName("sink");
+
+const counts = { recorder: 0, preview: 0, analyzer: 0 };
+let bytes = 0;
+
+// Every frame
+const stopRecorder = sink.onSample(sample => {
+  counts.recorder++;
+  bytes += sample.buffer?.length ?? 0;
+});
+
+// A 5 fps preview of the newest frame, frames in between are never converted
+const stopPreview = sink.onSample(() => counts.preview++, { maxFps: 5, latestOnly: true });
+
+// A slow analyzer that skips frames while it is busy
+const stopAnalyzer = sink.onSample(
+  () => {
+    counts.analyzer++;
+    const until = performance.now() + 50;
+    while (performance.now() < until);
+  },
+  { maxPending: 1 }
+);
+
+await pipeline.play();
+
+while (true) {
+  const message = await pipeline.busPop(5000);
+  if (!message || message.type === "eos" || message.type === "error") break;
+}
+
+// Let callbacks for the last frames run
+await new Promise(resolve => setTimeout(resolve, 200));
+
+stopRecorder();
+stopPreview();
+stopAnalyzer();
+await pipeline.stop();
+
+console.log("Frames per subscriber:", counts);
+console.log(`Recorded ${(bytes / 1024 / 1024).toFixed(1)} MiB`);
@@ -0,0 +1,40 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const width = 1280;
+const height = 720;
+const frames = 300;
+
+// Pushes the same number of frames with and without an arena and compares the timing
+const run = async options => {
+  const pipeline = new Pipeline(
+    `appsrc name=source format=time caps=video/x-raw,format=RGBA,width=${width},height=${height},` +
+      "framerate=30/1 ! videoconvert ! video/x-raw,format=I420 ! fakesink sync=false"
+  );
+  const source = pipeline.getElementByName("source");
+  if (options) source.setAllocator(options);
+
+  await pipeline.play();
+
+  const frame = Buffer.alloc(width * height * 4, 128);
+  const start = performance.now();
+  for (let i = 0; i < frames; i++) {
+    source.push(frame, Math.round((i * 1e9) / 30));
+  }
+  source.endOfStream();
+  while (true) {
+    const message = await pipeline.busPop(5000);
+    if (!message || message.type === "eos" || message.type === "error") break;
+  }
+  const elapsed = performance.now() - start;
+
+  await pipeline.stop();
+  return { elapsed, stats: source.getAllocatorStats() };
+};
+
+const heap = await run(null);
+console.log(`Default allocator: ${heap.elapsed.toFixed(0)} ms`);
+
+const arena = await run({ alignment: "page", hugePages: true });
+console.log(`Arena allocator:   ${arena.elapsed.toFixed(0)} ms`);
+console.log(arena.stats);
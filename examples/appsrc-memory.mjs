@@ -0,0 +1,45 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+import { readFileSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+
+// Any file works, e.g. `node appsrc-memory.mjs clip.mp4`. Without one, a clip is recorded first.
+let path = process.argv[2];
+if (!path) {
+  path = join(tmpdir(), "gst-kit-memory.mkv");
+  const recorder = new Pipeline(
+    "videotestsrc num-buffers=300 ! video/x-raw,width=320,height=240,framerate=30/1 ! " +
+      `timeoverlay ! jpegenc ! matroskamux ! filesink location=${path}`
+  );
+  await recorder.play();
+  while (true) {
+    const message = await recorder.busPop(5000);
+    if (!message || message.type === "eos" || message.type === "error") break;
+  }
+  await recorder.stop();
+}
+
+// Stands in for a download: the whole file as one Buffer
+const data = readFileSync(path);
+console.log(`Serving ${data.length} bytes from memory`);
+
+const pipeline = new Pipeline(
+  "appsrc name=source ! decodebin ! videoconvert ! appsink name=sink sync=false"
+);
+const source = pipeline.getElementByName("source");
+const sink = pipeline.getElementByName("sink");
+
+source.setMemorySource(data);
+
+await pipeline.pause();
+console.log("Duration:", pipeline.queryDuration());
+
+// Jump around without touching the disk
+for (const position of [8, 2, 5]) {
+  pipeline.seek(position);
+  const sample = await sink.getPreroll(2000);
+  console.log(`Seek to ${position}s gave a frame at ${((sample?.pts ?? 0) / 1e9).toFixed(2)}s`);
+}
+
+await pipeline.stop();
@@ -0,0 +1,34 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+import { closeSync, openSync } from "node:fs";
+
+// Plays a raw 320x240 RGB stream from a file or pipe, e.g.
+//   ffmpeg -i clip.mp4 -s 320x240 -pix_fmt rgb24 -f rawvideo - | node appsrc-pump.mjs
+const path = process.argv[2];
+const fd = path ? openSync(path, "r") : 0; // stdin when no path is given
+
+const frameSize = 320 * 240 * 3;
+const pipeline = new Pipeline(
+  "appsrc name=source format=time " +
+    "caps=video/x-raw,format=RGB,width=320,height=240,framerate=30/1 ! " +
+    "rawvideoparse use-sink-caps=true ! videoconvert ! autovideosink"
+);
+const source = pipeline.getElementByName("source");
+
+await pipeline.play();
+
+// One frame per buffer, at most 10 frames waiting in the app source
+const pump = source.pumpFrom(fd, { chunkSize: frameSize, readahead: 10 * frameSize });
+process.on("SIGINT", () => pump.stop());
+
+const { bytes, buffers, stopped } = await pump.done;
+console.log(`Read ${bytes} bytes in ${buffers} buffers${stopped ? " before stopping" : ""}`);
+
+// Let the sink play out what is queued
+while (!stopped) {
+  const message = await pipeline.busPop(5000);
+  if (!message || message.type === "eos" || message.type === "error") break;
+}
+
+await pipeline.stop();
+if (path) closeSync(fd);
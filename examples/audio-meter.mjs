@@ -0,0 +1,31 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "audiotestsrc wave=pink-noise volume=0.3 num-buffers=500 ! audioconvert ! " +
+    "audio/x-raw,format=F32LE,channels=2 ! identity name=meter ! autoaudiosink"
+);
+const meter = pipeline.getElementByName("meter");
+
+const format = value => (value === null ? "  --  " : value.toFixed(1).padStart(6));
+
+const stop = meter.addAudioMeter(
+  "src",
+  levels => {
+    const peaks = Array.from(levels.truePeak, format).join(" ");
+    console.log(
+      `M ${format(levels.momentary)} LUFS | S ${format(levels.shortTerm)} LUFS | TP ${peaks} dBTP`
+    );
+  },
+  { intervalMs: 200 }
+);
+
+await pipeline.play();
+
+while (true) {
+  const message = await pipeline.busPop(15000);
+  if (!message || message.type === "eos" || message.type === "error") break;
+}
+
+stop();
+await pipeline.stop();
@@ -0,0 +1,28 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "audiotestsrc num-buffers=20 wave=sine freq=440 " +
+    "! audio/x-raw,format=S16LE,channels=2,rate=44100 ! appsink name=sink"
+);
+const appsink = pipeline.getElementByName("sink");
+
+await pipeline.play();
+
+while (true) {
+  const sample = await appsink.getSample();
+  if (!sample?.audio?.data) break;
+
+  // Int16Array over the sample buffer, interleaved left/right
+  const { data, frames, channels } = sample.audio;
+  const rms = [];
+  for (let c = 0; c < channels; c++) {
+    let sum = 0;
+    for (let i = c; i < data.length; i += channels) sum += (data[i] / 32768) ** 2;
+    rms.push(Math.sqrt(sum / frames).toFixed(3));
+  }
+
+  console.log(`${frames} frames, RMS per channel: ${rms.join(" / ")}`);
+}
+
+await pipeline.stop();
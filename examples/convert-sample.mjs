@@ -0,0 +1,25 @@
+#!/usr/bin/env node
+import { Pipeline, convertSample } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc num-buffers=30 ! video/x-raw,format=I420,width=1920,height=1080 " +
+    "! appsink name=sink"
+);
+const appsink = pipeline.getElementByName("sink");
+
+await pipeline.play();
+
+while (true) {
+  const sample = await appsink.getSample();
+  if (!sample) break;
+
+  // Scaling and color conversion run on a native worker with multiple threads
+  const thumbnail = await convertSample(sample, { format: "RGBA", width: 320 });
+  console.log(
+    `Converted ${sample.caps.width}x${sample.caps.height} ${sample.caps.format}`,
+    `to ${thumbnail.caps.width}x${thumbnail.caps.height} ${thumbnail.caps.format}`,
+    `(${thumbnail.buffer.length} bytes)`
+  );
+}
+
+await pipeline.stop();
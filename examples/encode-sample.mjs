@@ -0,0 +1,22 @@
+#!/usr/bin/env node
+import { writeFile } from "node:fs/promises";
+import { Pipeline, encodeSample } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc num-buffers=5 pattern=ball ! video/x-raw,width=640,height=480 ! appsink name=sink"
+);
+const appsink = pipeline.getElementByName("sink");
+
+await pipeline.play();
+
+for (let i = 0; ; i++) {
+  const sample = await appsink.getSample();
+  if (!sample) break;
+
+  // Encoding runs in a pooled GStreamer pipeline on a native worker thread
+  const jpeg = await encodeSample(sample, { codec: "jpeg", quality: 80 });
+  await writeFile(`snapshot-${i}.jpg`, jpeg);
+  console.log(`snapshot-${i}.jpg: ${jpeg.length} bytes`);
+}
+
+await pipeline.stop();
@@ -0,0 +1,43 @@
+#!/usr/bin/env node
+import { Pipeline, hammingDistance } from "../dist/esm/index.mjs";
+
+// Alternate between two patterns so some frames repeat earlier ones
+const pipeline = new Pipeline(
+  "videotestsrc name=src num-buffers=120 ! video/x-raw,format=I420,width=640,height=360 ! " +
+    "identity name=hash ! fakesink sync=false"
+);
+const source = pipeline.getElementByName("src");
+const hash = pipeline.getElementByName("hash");
+
+const seen = new Map();
+
+hash.addFingerprinter(
+  "src",
+  ({ hashes, pts }) => {
+    hashes.forEach((fingerprint, i) => {
+      const seconds = (pts[i] / 1e9).toFixed(2);
+      const match = [...seen].find(([known]) => hammingDistance(known, fingerprint) <= 6);
+      if (match) {
+        console.log(`${seconds}s matches the frame first seen at ${match[1]}s`);
+      } else {
+        seen.set(fingerprint, seconds);
+        console.log(`${seconds}s new content ${fingerprint.toString(16).padStart(16, "0")}`);
+      }
+    });
+  },
+  { batchSize: 10 }
+);
+
+const patterns = ["smpte", "snow", "smpte", "checkers-8"];
+let index = 0;
+const timer = setInterval(() => source.setElementProperty("pattern", patterns[++index % 4]), 20);
+
+await pipeline.play();
+
+while (true) {
+  const message = await pipeline.busPop(5000);
+  if (!message || message.type === "eos" || message.type === "error") break;
+}
+
+clearInterval(timer);
+await pipeline.stop();
@@ -0,0 +1,22 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc num-buffers=100 ! video/x-raw,framerate=30/1 ! timeoverlay ! videoconvert ! appsink name=sink"
+);
+const appsink = pipeline.getElementByName("sink");
+
+await pipeline.pause();
+
+const first = await appsink.getPreroll();
+console.log("Prerolled frame", first?.buffer?.length, "bytes");
+
+for (let i = 0; i < 5; i++) {
+  const frame = await appsink.step(1);
+  console.log(`Stepped to frame ${i + 1}:`, frame?.buffer?.length, "bytes");
+}
+
+const skipped = await appsink.step(1, { format: "time" });
+console.log("Stepped one second ahead:", skipped?.buffer?.length, "bytes");
+
+await pipeline.stop();
@@ -0,0 +1,25 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc is-live=true ! timeoverlay ! tee name=t ! queue ! autovideosink"
+);
+await pipeline.play();
+
+await new Promise(r => setTimeout(r, 2000));
+
+console.log("Start recording");
+pipeline.addBin(
+  "queue ! videoconvert ! x264enc tune=zerolatency ! mp4mux ! filesink location=clip.mp4",
+  "rec"
+);
+await pipeline.link("t", "rec");
+
+await new Promise(r => setTimeout(r, 5000));
+
+console.log("Stop recording");
+await pipeline.removeElement("rec", { eos: true, timeoutMs: 5000 });
+console.log("clip.mp4 finalized, preview still running");
+
+await new Promise(r => setTimeout(r, 2000));
+await pipeline.stop();
@@ -0,0 +1,40 @@
+#!/usr/bin/env node
+import { Pipeline, loadKeyframeIndex } from "../dist/esm/index.mjs";
+
+const path = "keyframe-index.ts";
+
+// Record 10 seconds with a keyframe every second, indexing what reaches the file
+const recorder = new Pipeline(
+  "videotestsrc num-buffers=300 ! video/x-raw,width=640,height=360,framerate=30/1 ! " +
+    "timeoverlay ! x264enc key-int-max=30 ! h264parse ! mpegtsmux ! " +
+    `filesink name=file location=${path}`
+);
+const indexer = recorder.getElementByName("file").addKeyframeIndexer("sink");
+
+await recorder.play();
+while (true) {
+  const message = await recorder.busPop(5000);
+  if (!message || message.type === "eos" || message.type === "error") break;
+}
+await recorder.stop();
+
+const { entries, bytes } = await indexer.save(`${path}.gkfi`);
+console.log(`Indexed ${entries} keyframes, sidecar is ${bytes} bytes`);
+
+// Load the sidecar and seek with it
+const index = await loadKeyframeIndex(`${path}.gkfi`);
+for (let i = 0; i < index.count; i++) {
+  console.log(
+    `${index.pts[i].toFixed(3)}s at byte ${index.offsets[i]} (${index.sizes[i]} bytes)`
+  );
+}
+
+const player = new Pipeline(
+  `filesrc location=${path} ! tsdemux ! h264parse ! avdec_h264 ! videoconvert ! autovideosink`
+);
+await player.pause();
+console.log("Seek to 6.5s lands on the keyframe at 6s:", player.seek(6.5, { index }));
+await player.play();
+
+await new Promise(resolve => setTimeout(resolve, 2000));
+await player.stop();
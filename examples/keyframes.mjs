@@ -0,0 +1,47 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "compositor name=mix ! videoconvert ! autovideosink " +
+    "videotestsrc num-buffers=300 ! video/x-raw,width=640,height=360 ! mix.sink_0 " +
+    "videotestsrc pattern=ball num-buffers=300 ! video/x-raw,width=160,height=120 ! mix.sink_1 " +
+    "audiotestsrc num-buffers=500 ! volume name=vol ! audioconvert ! autoaudiosink"
+);
+
+const mixer = pipeline.getElementByName("mix");
+const volume = pipeline.getElementByName("vol");
+
+// Slide the small picture across and fade it in, all applied per frame by GStreamer
+mixer.setKeyframes(
+  "xpos",
+  [
+    { time: 0, value: 0 },
+    { time: 10, value: 480 },
+  ],
+  { pad: "sink_1", mode: "cubic" }
+);
+mixer.setKeyframes(
+  "alpha",
+  [
+    { time: 0, value: 0 },
+    { time: 2, value: 1 },
+  ],
+  { pad: "sink_1" }
+);
+
+// Fade the tone in and out
+volume.setKeyframes("volume", [
+  { time: 0, value: 0 },
+  { time: 2, value: 0.5 },
+  { time: 8, value: 0.5 },
+  { time: 10, value: 0 },
+]);
+
+await pipeline.play();
+
+while (true) {
+  const message = await pipeline.busPop(15000);
+  if (!message || message.type === "eos" || message.type === "error") break;
+}
+
+await pipeline.stop();
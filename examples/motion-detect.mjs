@@ -0,0 +1,35 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+// Swap videotestsrc for v4l2src or an RTSP source to watch a real camera
+const pipeline = new Pipeline(
+  "videotestsrc name=src pattern=ball is-live=true ! video/x-raw,width=640,height=360 ! " +
+    "identity name=analyze ! videoconvert ! autovideosink"
+);
+const analyze = pipeline.getElementByName("analyze");
+
+const stop = analyze.addMotionDetector(
+  "src",
+  event => {
+    const seconds = event.pts !== undefined ? (event.pts / 1e9).toFixed(2) : "?";
+    if (event.type === "motion-start") {
+      const moving = event.mask.filter(block => block === 1).length;
+      console.log(`[${seconds}s] motion started, ${moving}/${event.mask.length} blocks moving`);
+    } else if (event.type === "motion-end") {
+      console.log(`[${seconds}s] motion ended`);
+    } else {
+      console.log(`[${seconds}s] scene change (${event.score.toFixed(2)})`);
+    }
+  },
+  { motionThreshold: 0.01, holdMs: 2000 }
+);
+
+await pipeline.play();
+
+// Cut to a static picture after 5 seconds: a scene change, then motion ends
+const source = pipeline.getElementByName("src");
+setTimeout(() => source.setElementProperty("pattern", "smpte"), 5000);
+await new Promise(resolve => setTimeout(resolve, 10000));
+
+stop();
+await pipeline.stop();
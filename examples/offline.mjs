@@ -0,0 +1,22 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc num-buffers=600 ! video/x-raw,framerate=30/1 ! videoconvert ! autovideosink",
+  { offline: true }
+);
+
+await pipeline.play();
+
+while (true) {
+  const message = await pipeline.busPop(1000);
+  if (message?.type === "eos" || message?.type === "error") break;
+}
+
+const report = pipeline.getThroughput();
+console.log(
+  `Processed ${report.mediaSeconds}s of media in ${report.wallSeconds.toFixed(2)}s ` +
+    `(${report.realtimeFactor.toFixed(1)}x realtime)`
+);
+
+await pipeline.stop();
@@ -0,0 +1,26 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+import { statSync } from "node:fs";
+
+// Keep the last 3 seconds of an MPEG-TS stream and save it when "something happens"
+const pipeline = new Pipeline(
+  "videotestsrc is-live=true ! video/x-raw,width=640,height=360,framerate=30/1 ! " +
+    "x264enc tune=zerolatency key-int-max=30 ! h264parse ! mpegtsmux ! " +
+    "identity name=tap ! fakesink"
+);
+const tap = pipeline.getElementByName("tap");
+
+const ring = tap.addPreRecordBuffer("src", { seconds: 3 });
+await pipeline.play();
+
+// Let the ring fill up, then trigger a recording
+await new Promise(resolve => setTimeout(resolve, 5000));
+console.log("Buffered:", ring.getStats());
+
+const path = "prerecord.ts";
+const { buffers, bytes, duration } = await ring.flushTo(path);
+console.log(`Saved ${duration.toFixed(2)}s (${buffers} buffers, ${bytes} bytes) to ${path}`);
+console.log(`File size: ${statSync(path).size} bytes`);
+
+ring.stop();
+await pipeline.stop();
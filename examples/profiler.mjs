@@ -0,0 +1,32 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc num-buffers=300 ! video/x-raw,width=1280,height=720 ! videoconvert ! " +
+    "videoscale ! video/x-raw,width=640,height=360 ! videoflip method=clockwise ! " +
+    "queue ! fakesink",
+  { offline: true }
+);
+
+const profiler = pipeline.startProfiler();
+await pipeline.play();
+
+while (true) {
+  const message = await pipeline.busPop(1000);
+  if (message?.type === "eos" || message?.type === "error") break;
+}
+
+const { elapsedSeconds, elements } = profiler.snapshot();
+profiler.stop();
+await pipeline.stop();
+
+console.log(`Profiled ${elapsedSeconds.toFixed(2)}s`);
+for (const element of elements) {
+  const cost = element.processing
+    ? `${(element.share * 100).toFixed(1)}% p50=${(element.processing.p50 / 1000).toFixed(0)}us ` +
+      `p99=${(element.processing.p99 / 1000).toFixed(0)}us`
+    : "throughput only";
+  console.log(
+    `${element.name.padEnd(16)} ${element.buffersPerSecond.toFixed(0).padStart(6)} buf/s  ${cost}`
+  );
+}
@@ -0,0 +1,26 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+// The identity element simulates a consumer that can't keep up
+const pipeline = new Pipeline(
+  "videotestsrc is-live=true ! queue name=capture ! videoconvert ! " +
+    "queue name=process max-size-buffers=10 ! identity name=slow sleep-time=50000 ! " +
+    "fakesink sync=false"
+);
+
+const stop = pipeline.monitorQueues(
+  ({ queues, bottleneck }) => {
+    const levels = queues.map(({ name, fill }) => `${name}=${(fill * 100).toFixed(0)}%`);
+    console.log(levels.join(" "));
+    if (bottleneck) {
+      console.log(`  bottleneck: ${bottleneck.queue} -> ${bottleneck.suspect}`);
+    }
+  },
+  { intervalMs: 500 }
+);
+
+await pipeline.play();
+await new Promise(resolve => setTimeout(resolve, 5000));
+
+stop();
+await pipeline.stop();
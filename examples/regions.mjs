@@ -0,0 +1,29 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc num-buffers=5 pattern=ball ! video/x-raw,width=3840,height=2160 " +
+    "! appsink name=sink"
+);
+const appsink = pipeline.getElementByName("sink");
+
+// Regions of interest, e.g. from a previous detection pass
+const rects = [
+  { x: 100, y: 200, width: 320, height: 96 },
+  { x: 2400, y: 1500, width: 640, height: 192 },
+];
+
+await pipeline.play();
+
+while (true) {
+  // Only the rectangles are copied out of the 4K frame, converted to RGB at half size
+  const batch = await appsink.getRegions(rects, { format: "RGB", scale: 0.5 });
+  if (!batch) break;
+
+  for (const region of batch.regions) {
+    const pixels = batch.buffer.subarray(region.offset, region.offset + region.size);
+    console.log(`${region.width}x${region.height} ${region.format}: ${pixels.length} bytes`);
+  }
+}
+
+await pipeline.stop();
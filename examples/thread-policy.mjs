@@ -0,0 +1,24 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc is-live=true name=src ! queue name=encode ! x264enc tune=zerolatency ! fakesink"
+);
+
+// Keep capture on CPU 0 and give the encoder its own cores at lower priority
+pipeline.setThreadPolicy({
+  cpus: [0],
+  namePrefix: "gk-",
+  elements: { encode: { cpus: [1, 2, 3], nice: 5, namePrefix: "gk-" } },
+});
+
+await pipeline.play();
+await new Promise(resolve => setTimeout(resolve, 500));
+
+for (const thread of pipeline.getThreadAssignments()) {
+  const { tid, name, element, pad, cpus, nice, policy, errors } = thread;
+  console.log(`${tid} ${name} (${element}:${pad}) cpus=${cpus.join(",")} nice=${nice} ${policy}`);
+  if (errors.length > 0) console.log(`  ${errors.join("; ")}`);
+}
+
+await pipeline.stop();
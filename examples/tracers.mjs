@@ -0,0 +1,30 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc name=src num-buffers=300 ! videoconvert name=convert ! videoscale name=scale ! " +
+    "video/x-raw,width=320,height=240 ! fakesink name=sink",
+  { offline: true }
+);
+
+pipeline.enableTracers(["latency", "proctime"]);
+
+await pipeline.play();
+
+while (true) {
+  const message = await pipeline.busPop(1000);
+  if (message?.type === "eos" || message?.type === "error") break;
+}
+
+const stats = pipeline.getTracerStats();
+
+// Time spent inside each element, in microseconds
+for (const [element, fields] of Object.entries(stats["element-latency"] ?? {})) {
+  const { count, p50, p99, max } = fields.time;
+  console.log(
+    `${element}: ${count} buffers, p50 ${(p50 / 1000).toFixed(1)}us, ` +
+      `p99 ${(p99 / 1000).toFixed(1)}us, max ${(max / 1000).toFixed(1)}us`
+  );
+}
+
+await pipeline.stop();
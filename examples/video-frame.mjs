@@ -0,0 +1,33 @@
+#!/usr/bin/env node
+import { Pipeline } from "../dist/esm/index.mjs";
+
+const pipeline = new Pipeline(
+  "videotestsrc num-buffers=10 ! video/x-raw,format=NV12,width=1280,height=720 ! appsink name=sink"
+);
+const appsink = pipeline.getElementByName("sink");
+
+await pipeline.play();
+
+while (true) {
+  const frame = await appsink.getVideoFrame();
+  if (!frame) break;
+
+  // Planes are views of the mapped frame, nothing is copied into JS
+  const [luma] = frame.planes;
+  let sum = 0;
+  for (let y = 0; y < luma.height; y++) {
+    const row = luma.data.subarray(y * luma.stride, y * luma.stride + luma.width);
+    for (const value of row) sum += value;
+  }
+
+  console.log(
+    `${frame.format} ${frame.width}x${frame.height}`,
+    frame.planes.map(plane => `stride ${plane.stride} @ ${plane.offset}`).join(", "),
+    `mean luma ${(sum / (luma.width * luma.height)).toFixed(1)}`
+  );
+
+  // Unmap as soon as possible so the buffer can return to its pool
+  frame.release();
+}
+
+await pipeline.stop();
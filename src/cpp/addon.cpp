@@ -1,9 +1,13 @@
 #include "element.hpp"
+#include "keyframe-index.hpp"
 #include "pipeline.hpp"
+#include "samples.hpp"
 #include <napi.h>
 
 Napi::Object InitAll(Napi::Env env, Napi::Object exports) {
   Pipeline::Init(env, exports);
+  Samples::Init(env, exports);
+  KeyframeIndex::Init(env, exports);
   return exports;
 }
 
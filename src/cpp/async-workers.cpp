@@ -1,6 +1,19 @@
 #include "async-workers.hpp"
+#include "encoder-pool.hpp"
+#include "memory-source.hpp"
 #include "type-conversion.hpp"
+#include "video-frame.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <functional>
 #include <gst/gst.h>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 // BusPopWorker implementation
 BusPopWorker::BusPopWorker(const Napi::Env &env, GstPipeline *pipeline, GstClockTime timeout) :
@@ -143,9 +156,11 @@ Napi::Object BusPopWorker::ConvertMessageToJs(const Napi::Env &env, GstMessage *
 }
 
 // PullSampleWorker implementation
-PullSampleWorker::PullSampleWorker(const Napi::Env &env, GstAppSink *app_sink, guint64 timeout_ms) :
-    Napi::AsyncWorker(env), app_sink(app_sink), timeout_ms(timeout_ms), sample(nullptr),
-    deferred(env) {
+PullSampleWorker::PullSampleWorker(
+  const Napi::Env &env, GstAppSink *app_sink, guint64 timeout_ms, bool preroll, bool video_frame
+) :
+    Napi::AsyncWorker(env), app_sink(app_sink), timeout_ms(timeout_ms), preroll(preroll),
+    video_frame(video_frame), sample(nullptr), deferred(env) {
   // Increase reference count since we'll be using this in another thread
   gst_object_ref(app_sink);
 }
@@ -157,7 +172,11 @@ void PullSampleWorker::Execute() {
   GstClockTime timeout = timeout_ms * GST_MSECOND;
 
   // Use GStreamer's built-in timeout mechanism
-  sample = gst_app_sink_try_pull_sample(app_sink, timeout);
+  if (preroll) {
+    sample = gst_app_sink_try_pull_preroll(app_sink, timeout);
+  } else {
+    sample = gst_app_sink_try_pull_sample(app_sink, timeout);
+  }
   // sample will be NULL if timeout expires or on EOS/error
 }
 
@@ -166,6 +185,17 @@ Napi::Promise::Deferred PullSampleWorker::GetPromise() { return deferred; }
 void PullSampleWorker::OnOK() {
   Napi::HandleScope scope(Env());
 
+  if (sample && video_frame) {
+    std::string error;
+    Napi::Value frame = VideoFrame::to_js(Env(), sample, error);
+    if (frame.IsEmpty()) {
+      deferred.Reject(Napi::Error::New(Env(), error).Value());
+    } else {
+      deferred.Resolve(frame);
+    }
+    return;
+  }
+
   if (sample) {
     Napi::Object result = TypeConversion::gst_sample_to_js(Env(), sample);
     deferred.Resolve(result);
@@ -193,6 +223,71 @@ void PullSampleWorker::cleanup() {
   }
 }
 
+// StepWorker implementation
+StepWorker::StepWorker(
+  const Napi::Env &env, GstAppSink *app_sink, GstFormat format, guint64 amount, gdouble rate,
+  guint64 timeout_ms
+) :
+    Napi::AsyncWorker(env), app_sink(app_sink), format(format), amount(amount), rate(rate),
+    timeout_ms(timeout_ms), sample(nullptr), deferred(env) {
+  // Increase reference count since we'll be using this in another thread
+  gst_object_ref(app_sink);
+}
+
+StepWorker::~StepWorker() { cleanup(); }
+
+void StepWorker::Execute() {
+  // Drop a preroll sample nobody pulled yet, otherwise the wait below would return
+  // the frame we are stepping away from instead of the one the step lands on
+  GstSample *stale = gst_app_sink_try_pull_preroll(app_sink, 0);
+  if (stale) {
+    gst_sample_unref(stale);
+  }
+
+  // A step event advances the paused sink without flushing the pipeline, so each
+  // frame costs one decode instead of a full seek and preroll. Not intermediate: that would
+  // mark it as part of a larger step and the sink would not preroll on the frame it lands on.
+  GstEvent *event = gst_event_new_step(format, amount, rate, TRUE, FALSE);
+  if (!gst_element_send_event(GST_ELEMENT(app_sink), event)) {
+    SetError("Failed to send step event");
+    return;
+  }
+
+  // The sink prerolls again on the first buffer after the step
+  sample = gst_app_sink_try_pull_preroll(app_sink, timeout_ms * GST_MSECOND);
+}
+
+Napi::Promise::Deferred StepWorker::GetPromise() { return deferred; }
+
+void StepWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+
+  if (sample) {
+    Napi::Object result = TypeConversion::gst_sample_to_js(Env(), sample);
+    deferred.Resolve(result);
+    return;
+  }
+
+  // Timeout, EOS or the pipeline is not paused
+  deferred.Resolve(Env().Null());
+}
+
+void StepWorker::OnError(const Napi::Error &error) {
+  Napi::HandleScope scope(Env());
+  deferred.Reject(error.Value());
+}
+
+void StepWorker::cleanup() {
+  if (sample) {
+    gst_sample_unref(sample);
+    sample = nullptr;
+  }
+  if (app_sink) {
+    gst_object_unref(app_sink);
+    app_sink = nullptr;
+  }
+}
+
 // StateChangeWorker implementation
 StateChangeWorker::StateChangeWorker(
   const Napi::Env &env, GstPipeline *pipeline, GstState target_state, GstClockTime timeout
@@ -271,3 +366,971 @@ void StateChangeWorker::cleanup() {
     pipeline = nullptr;
   }
 }
+
+// ReconfigureWorker implementation
+
+// Shared between a worker waiting for an idle probe and the probe callback, which can still
+// fire on a streaming thread after the worker gave up waiting
+struct IdleAction {
+  std::function<void(GstPad *)> action;
+  std::mutex mutex;
+  std::condition_variable cond;
+  bool done = false;
+  bool cancelled = false;
+  bool removed = false; // The probe has returned GST_PAD_PROBE_REMOVE
+};
+
+static GstPadProbeReturn idle_probe_callback(GstPad *pad, GstPadProbeInfo *, gpointer user_data) {
+  IdleAction *idle = static_cast<std::shared_ptr<IdleAction> *>(user_data)->get();
+
+  std::lock_guard<std::mutex> lock(idle->mutex);
+  if (!idle->cancelled && !idle->done) {
+    idle->action(pad);
+    idle->done = true;
+    idle->cond.notify_all();
+  }
+
+  idle->removed = true;
+  return GST_PAD_PROBE_REMOVE;
+}
+
+// Run an action on a pad once no buffer is in flight through it and wait for it to finish.
+// The probe fires immediately when the pad is already idle.
+static bool
+run_when_idle(GstPad *pad, std::function<void(GstPad *)> action, GstClockTime timeout) {
+  auto idle = std::make_shared<IdleAction>();
+  idle->action = std::move(action);
+
+  gulong probe_id = gst_pad_add_probe(
+    pad, GST_PAD_PROBE_TYPE_IDLE, idle_probe_callback, new std::shared_ptr<IdleAction>(idle),
+    [](gpointer data) { delete static_cast<std::shared_ptr<IdleAction> *>(data); }
+  );
+
+  std::unique_lock<std::mutex> lock(idle->mutex);
+  if (timeout == GST_CLOCK_TIME_NONE) {
+    idle->cond.wait(lock, [&idle] { return idle->done; });
+  } else {
+    idle->cond.wait_for(lock, std::chrono::nanoseconds(timeout), [&idle] { return idle->done; });
+  }
+
+  if (!idle->done) {
+    idle->cancelled = true;
+    // Removed under the lock: a callback waiting for it sees cancelled and its REMOVE is
+    // ignored for a probe that is already gone, one that already ran must not be removed twice
+    if (probe_id && !idle->removed) {
+      gst_pad_remove_probe(pad, probe_id);
+    }
+    return false;
+  }
+
+  return true;
+}
+
+static GstPad *request_pad_by_name(GstElement *element, const char *name) {
+#if GST_CHECK_VERSION(1, 20, 0)
+  return gst_element_request_pad_simple(element, name);
+#else
+  return gst_element_get_request_pad(element, name);
+#endif
+}
+
+// Find a pad to link: the named pad (static or request), otherwise the first unlinked pad
+// in the given direction, otherwise a new request pad (tee src_%u, muxer sink_%u, ...)
+static GstPad *
+acquire_pad(GstElement *element, const std::string &name, GstPadDirection direction) {
+  if (!name.empty()) {
+    GstPad *pad = gst_element_get_static_pad(element, name.c_str());
+    return pad ? pad : request_pad_by_name(element, name.c_str());
+  }
+
+  GstIterator *it = direction == GST_PAD_SRC ? gst_element_iterate_src_pads(element)
+                                             : gst_element_iterate_sink_pads(element);
+  GValue item = G_VALUE_INIT;
+  GstPad *found = nullptr;
+  bool done = false;
+
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK: {
+        GstPad *pad = GST_PAD(g_value_get_object(&item));
+        if (!gst_pad_is_linked(pad)) {
+          found = GST_PAD(gst_object_ref(pad));
+          done = true;
+        }
+        g_value_reset(&item);
+        break;
+      }
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync(it);
+        break;
+      default:
+        done = true;
+        break;
+    }
+  }
+
+  g_value_unset(&item);
+  gst_iterator_free(it);
+
+  if (found) {
+    return found;
+  }
+
+  GList *templates = gst_element_class_get_pad_template_list(GST_ELEMENT_GET_CLASS(element));
+  for (GList *l = templates; l != nullptr; l = l->next) {
+    GstPadTemplate *templ = GST_PAD_TEMPLATE(l->data);
+    if (GST_PAD_TEMPLATE_DIRECTION(templ) == direction
+        && GST_PAD_TEMPLATE_PRESENCE(templ) == GST_PAD_REQUEST) {
+      GstPad *pad = gst_element_request_pad(element, templ, nullptr, nullptr);
+      if (pad) {
+        return pad;
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+// Give request pads (tee src_%u, funnel sink_%u, ...) back to their element
+static void release_if_requested(GstPad *pad) {
+  GstPadTemplate *templ = gst_pad_get_pad_template(pad);
+  if (!templ) {
+    return;
+  }
+  bool is_request = GST_PAD_TEMPLATE_PRESENCE(templ) == GST_PAD_REQUEST;
+  gst_object_unref(templ);
+
+  if (is_request) {
+    GstElement *parent = gst_pad_get_parent_element(pad);
+    if (parent) {
+      gst_element_release_request_pad(parent, pad);
+      gst_object_unref(parent);
+    }
+  }
+}
+
+// Collect (pad, peer) pairs for the linked pads of an element in one direction.
+// Both pads of each pair are returned with a reference held.
+static std::vector<std::pair<GstPad *, GstPad *>>
+linked_pads(GstElement *element, GstPadDirection direction) {
+  std::vector<std::pair<GstPad *, GstPad *>> pairs;
+
+  GstIterator *it = direction == GST_PAD_SRC ? gst_element_iterate_src_pads(element)
+                                             : gst_element_iterate_sink_pads(element);
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK: {
+        GstPad *pad = GST_PAD(g_value_get_object(&item));
+        GstPad *peer = gst_pad_get_peer(pad);
+        if (peer) {
+          pairs.emplace_back(GST_PAD(gst_object_ref(pad)), peer);
+        }
+        g_value_reset(&item);
+        break;
+      }
+      case GST_ITERATOR_RESYNC:
+        for (auto &pair : pairs) {
+          gst_object_unref(pair.first);
+          gst_object_unref(pair.second);
+        }
+        pairs.clear();
+        gst_iterator_resync(it);
+        break;
+      default:
+        done = true;
+        break;
+    }
+  }
+
+  g_value_unset(&item);
+  gst_iterator_free(it);
+
+  return pairs;
+}
+
+static void unref_pad_pairs(std::vector<std::pair<GstPad *, GstPad *>> &pairs) {
+  for (auto &pair : pairs) {
+    gst_object_unref(pair.first);
+    gst_object_unref(pair.second);
+  }
+  pairs.clear();
+}
+
+// Collect the sink pads of every sink element in (or equal to) the given element
+static void collect_sink_element_pads(GstElement *element, std::vector<GstPad *> &pads) {
+  if (GST_IS_BIN(element)) {
+    for (GList *l = GST_BIN_CHILDREN(GST_BIN(element)); l != nullptr; l = l->next) {
+      collect_sink_element_pads(GST_ELEMENT(l->data), pads);
+    }
+  } else if (GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK)) {
+    GstPad *pad = gst_element_get_static_pad(element, "sink");
+    if (pad) {
+      pads.push_back(pad);
+    }
+  }
+}
+
+struct EosWait {
+  std::mutex mutex;
+  std::condition_variable cond;
+  size_t remaining = 0;
+};
+
+static GstPadProbeReturn eos_probe_callback(GstPad *, GstPadProbeInfo *info, gpointer user_data) {
+  if (GST_EVENT_TYPE(GST_PAD_PROBE_INFO_EVENT(info)) != GST_EVENT_EOS) {
+    return GST_PAD_PROBE_OK;
+  }
+
+  EosWait *wait = static_cast<std::shared_ptr<EosWait> *>(user_data)->get();
+  std::lock_guard<std::mutex> lock(wait->mutex);
+  if (wait->remaining > 0) {
+    wait->remaining--;
+  }
+  wait->cond.notify_all();
+
+  // Let the EOS through so sinks finish writing
+  return GST_PAD_PROBE_REMOVE;
+}
+
+ReconfigureWorker::ReconfigureWorker(
+  const Napi::Env &env, GstPipeline *pipeline, Operation operation, const std::string &src_name,
+  const std::string &sink_name, const std::string &src_pad_name, const std::string &sink_pad_name,
+  bool send_eos, GstClockTime timeout
+) :
+    Napi::AsyncWorker(env), pipeline(pipeline), operation(operation), src_name(src_name),
+    sink_name(sink_name), src_pad_name(src_pad_name), sink_pad_name(sink_pad_name),
+    send_eos(send_eos), timeout(timeout), deferred(env) {
+  // Increase reference count since we'll be using this in another thread
+  gst_object_ref(pipeline);
+}
+
+ReconfigureWorker::~ReconfigureWorker() { cleanup(); }
+
+void ReconfigureWorker::Execute() {
+  switch (operation) {
+    case Operation::Link:
+      link();
+      break;
+    case Operation::Unlink:
+      unlink();
+      break;
+    case Operation::Remove:
+      remove();
+      break;
+  }
+}
+
+GstElement *ReconfigureWorker::find_element(const std::string &name) {
+  GstElement *element = gst_bin_get_by_name(GST_BIN(pipeline), name.c_str());
+  if (!element) {
+    SetError("Element not found: " + name);
+  }
+  return element;
+}
+
+void ReconfigureWorker::link() {
+  GstElement *src = find_element(src_name);
+  if (!src) {
+    return;
+  }
+  GstElement *sink = find_element(sink_name);
+  if (!sink) {
+    gst_object_unref(src);
+    return;
+  }
+
+  GstPad *src_pad = acquire_pad(src, src_pad_name, GST_PAD_SRC);
+  GstPad *sink_pad = acquire_pad(sink, sink_pad_name, GST_PAD_SINK);
+
+  if (!src_pad || !sink_pad) {
+    SetError("No free pad to link " + src_name + " to " + sink_name);
+  } else if (gst_pad_is_linked(src_pad) || gst_pad_is_linked(sink_pad)) {
+    std::string pads = std::string(GST_PAD_NAME(src_pad)) + " -> " + GST_PAD_NAME(sink_pad);
+    SetError("Pad is already linked: " + pads);
+  } else {
+    // Hold back data on the new path until the downstream pads are activated, otherwise the
+    // first buffer would hit a flushing pad and stop the upstream branch. Pads are activated
+    // within the state change call even when it returns ASYNC; the rest of the change (a sink
+    // prerolling) needs the very data we hold, so the block ends there rather than waiting.
+    gulong block_id = gst_pad_add_probe(
+      src_pad, GST_PAD_PROBE_TYPE_BLOCK_DOWNSTREAM,
+      [](GstPad *, GstPadProbeInfo *, gpointer) { return GST_PAD_PROBE_OK; }, nullptr, nullptr
+    );
+
+    GstPadLinkReturn ret = gst_pad_link(src_pad, sink_pad);
+    if (GST_PAD_LINK_FAILED(ret)) {
+      std::string reason = gst_pad_link_get_name(ret);
+      SetError("Failed to link " + src_name + " to " + sink_name + ": " + reason);
+    } else if (!gst_element_sync_state_with_parent(sink)
+               || !gst_element_sync_state_with_parent(src)) {
+      // Linked but not running, leave the link for the caller to unlink or retry
+      SetError(
+        "Failed to bring " + src_name + " and " + sink_name + " to the pipeline's state"
+      );
+    }
+
+    gst_pad_remove_probe(src_pad, block_id);
+  }
+
+  // Hand back request pads we took for a link that did not happen
+  if (src_pad) {
+    if (!gst_pad_is_linked(src_pad)) {
+      release_if_requested(src_pad);
+    }
+    gst_object_unref(src_pad);
+  }
+  if (sink_pad) {
+    if (!gst_pad_is_linked(sink_pad)) {
+      release_if_requested(sink_pad);
+    }
+    gst_object_unref(sink_pad);
+  }
+  gst_object_unref(src);
+  gst_object_unref(sink);
+}
+
+void ReconfigureWorker::unlink() {
+  GstElement *src = find_element(src_name);
+  if (!src) {
+    return;
+  }
+  GstElement *sink = find_element(sink_name);
+  if (!sink) {
+    gst_object_unref(src);
+    return;
+  }
+
+  auto pairs = linked_pads(src, GST_PAD_SRC);
+  bool found = false;
+
+  for (auto &[src_pad, peer] : pairs) {
+    GstElement *peer_element = gst_pad_get_parent_element(peer);
+    bool matches = peer_element == sink;
+    if (peer_element) {
+      gst_object_unref(peer_element);
+    }
+    if (!matches) {
+      continue;
+    }
+
+    found = true;
+    GstPad *sink_pad = peer;
+    auto detach = [sink_pad](GstPad *pad) { gst_pad_unlink(pad, sink_pad); };
+    if (!run_when_idle(src_pad, detach, timeout)) {
+      SetError("Timed out waiting for " + src_name + " to become idle");
+      break;
+    }
+    release_if_requested(src_pad);
+    release_if_requested(sink_pad);
+  }
+
+  if (!found) {
+    SetError(src_name + " is not linked to " + sink_name);
+  }
+
+  unref_pad_pairs(pairs);
+  gst_object_unref(src);
+  gst_object_unref(sink);
+}
+
+void ReconfigureWorker::remove() {
+  GstElement *element = find_element(src_name);
+  if (!element) {
+    return;
+  }
+
+  // Detach from upstream while no buffer is in flight
+  auto upstream = linked_pads(element, GST_PAD_SINK);
+  for (auto &[pad, peer] : upstream) {
+    GstPad *sink_pad = pad;
+    auto detach = [sink_pad](GstPad *src_pad) { gst_pad_unlink(src_pad, sink_pad); };
+    if (!run_when_idle(peer, detach, timeout)) {
+      SetError("Timed out waiting for the upstream of " + src_name + " to become idle");
+      unref_pad_pairs(upstream);
+      gst_object_unref(element);
+      return;
+    }
+    release_if_requested(peer);
+  }
+  unref_pad_pairs(upstream);
+
+  // Drain the branch so muxers and file sinks finish their output
+  bool drained = true;
+  if (send_eos) {
+    std::vector<GstPad *> sink_pads;
+    collect_sink_element_pads(element, sink_pads);
+
+    auto wait = std::make_shared<EosWait>();
+    wait->remaining = sink_pads.size();
+    for (GstPad *pad : sink_pads) {
+      gst_pad_add_probe(
+        pad, GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM, eos_probe_callback,
+        new std::shared_ptr<EosWait>(wait),
+        [](gpointer data) { delete static_cast<std::shared_ptr<EosWait> *>(data); }
+      );
+    }
+
+    GstIterator *it = gst_element_iterate_sink_pads(element);
+    GValue item = G_VALUE_INIT;
+    while (gst_iterator_next(it, &item) == GST_ITERATOR_OK) {
+      gst_pad_send_event(GST_PAD(g_value_get_object(&item)), gst_event_new_eos());
+      g_value_reset(&item);
+    }
+    g_value_unset(&item);
+    gst_iterator_free(it);
+
+    {
+      std::unique_lock<std::mutex> lock(wait->mutex);
+      auto all_eos = [&wait] { return wait->remaining == 0; };
+      if (timeout == GST_CLOCK_TIME_NONE) {
+        wait->cond.wait(lock, all_eos);
+      } else {
+        drained = wait->cond.wait_for(lock, std::chrono::nanoseconds(timeout), all_eos);
+      }
+    }
+
+    for (GstPad *pad : sink_pads) {
+      gst_object_unref(pad);
+    }
+  }
+
+  gst_element_set_state(element, GST_STATE_NULL);
+
+  // Detach from downstream now that the element no longer pushes
+  auto downstream = linked_pads(element, GST_PAD_SRC);
+  for (auto &[pad, peer] : downstream) {
+    gst_pad_unlink(pad, peer);
+    release_if_requested(peer);
+  }
+  unref_pad_pairs(downstream);
+
+  GstObject *parent = gst_object_get_parent(GST_OBJECT(element));
+  if (parent) {
+    gst_bin_remove(GST_BIN(parent), element);
+    gst_object_unref(parent);
+  }
+
+  gst_object_unref(element);
+
+  // Already detached from upstream, so the element is removed anyway and the caller told
+  if (!drained) {
+    SetError("Timed out draining " + src_name + ", it was removed without finishing its output");
+  }
+}
+
+Napi::Promise::Deferred ReconfigureWorker::GetPromise() { return deferred; }
+
+void ReconfigureWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+  deferred.Resolve(Napi::Boolean::New(Env(), true));
+}
+
+void ReconfigureWorker::OnError(const Napi::Error &error) {
+  Napi::HandleScope scope(Env());
+  deferred.Reject(error.Value());
+}
+
+void ReconfigureWorker::cleanup() {
+  if (pipeline) {
+    gst_object_unref(pipeline);
+    pipeline = nullptr;
+  }
+}
+
+// ConvertSampleWorker implementation
+ConvertSampleWorker::ConvertSampleWorker(
+  const Napi::Env &env, const Napi::Buffer<uint8_t> &input_buffer, const GstVideoInfo &in_info,
+  const GstVideoInfo &out_info, GstStructure *config, guint32 flags
+) :
+    Napi::AsyncWorker(env), in_info(in_info), out_info(out_info), config(config), flags(flags),
+    deferred(env) {
+  // Allocate the result on the JS thread so Execute only touches raw memory
+  Napi::Buffer<uint8_t> output_buffer =
+    Napi::Buffer<uint8_t>::New(env, GST_VIDEO_INFO_SIZE(&out_info));
+  input = Napi::Persistent(input_buffer);
+  output = Napi::Persistent(output_buffer);
+  input_data = input_buffer.Data();
+  output_data = output_buffer.Data();
+}
+
+ConvertSampleWorker::~ConvertSampleWorker() { cleanup(); }
+
+void ConvertSampleWorker::Execute() {
+  // Wrap the JS memory without copying, the references keep it alive until OnOK
+  GstBuffer *in_buffer = gst_buffer_new_wrapped_full(
+    GST_MEMORY_FLAG_READONLY, input_data, GST_VIDEO_INFO_SIZE(&in_info), 0,
+    GST_VIDEO_INFO_SIZE(&in_info), nullptr, nullptr
+  );
+  GstBuffer *out_buffer = gst_buffer_new_wrapped_full(
+    static_cast<GstMemoryFlags>(0), output_data, GST_VIDEO_INFO_SIZE(&out_info), 0,
+    GST_VIDEO_INFO_SIZE(&out_info), nullptr, nullptr
+  );
+
+  GstVideoFrame in_frame, out_frame;
+  bool in_mapped = gst_video_frame_map(&in_frame, &in_info, in_buffer, GST_MAP_READ);
+  bool out_mapped =
+    in_mapped && gst_video_frame_map(&out_frame, &out_info, out_buffer, GST_MAP_WRITE);
+
+  if (!in_mapped || !out_mapped) {
+    SetError("Failed to map video frame");
+  } else {
+    // The converter takes ownership of the config
+    GstVideoConverter *converter = gst_video_converter_new(&in_info, &out_info, config);
+    config = nullptr;
+    if (!converter) {
+      SetError("Unsupported conversion");
+    } else {
+      gst_video_converter_frame(converter, &in_frame, &out_frame);
+      gst_video_converter_free(converter);
+    }
+  }
+
+  if (out_mapped) {
+    gst_video_frame_unmap(&out_frame);
+  }
+  if (in_mapped) {
+    gst_video_frame_unmap(&in_frame);
+  }
+  gst_buffer_unref(out_buffer);
+  gst_buffer_unref(in_buffer);
+}
+
+Napi::Promise::Deferred ConvertSampleWorker::GetPromise() { return deferred; }
+
+void ConvertSampleWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+
+  Napi::Object result = Napi::Object::New(Env());
+  result.Set("buffer", output.Value());
+  result.Set("flags", Napi::Number::New(Env(), flags));
+
+  GstCaps *caps = gst_video_info_to_caps(&out_info);
+  if (caps && gst_caps_get_size(caps) > 0) {
+    result.Set("caps", TypeConversion::gst_structure_to_js(Env(), gst_caps_get_structure(caps, 0)));
+  }
+  if (caps) {
+    gst_caps_unref(caps);
+  }
+
+  deferred.Resolve(result);
+}
+
+void ConvertSampleWorker::OnError(const Napi::Error &error) {
+  Napi::HandleScope scope(Env());
+  deferred.Reject(error.Value());
+}
+
+void ConvertSampleWorker::cleanup() {
+  if (config) {
+    gst_structure_free(config);
+    config = nullptr;
+  }
+  input.Reset();
+  output.Reset();
+}
+
+// EncodeSampleWorker implementation
+EncodeSampleWorker::EncodeSampleWorker(
+  const Napi::Env &env, const Napi::Buffer<uint8_t> &input_buffer, const GstVideoInfo &info,
+  const std::string &codec, int quality
+) :
+    Napi::AsyncWorker(env),
+    input(MemorySource::wrap(env, input_buffer, input_buffer.Data(), GST_VIDEO_INFO_SIZE(&info))),
+    info(info), codec(codec), quality(quality), encoded(nullptr), deferred(env) {}
+
+EncodeSampleWorker::~EncodeSampleWorker() { cleanup(); }
+
+void EncodeSampleWorker::Execute() {
+  // The raw frame is read straight from the JS buffer. The encoder pipeline may hold on to it
+  // after encode() returns, the wrapper keeps the JS buffer pinned until it lets go.
+  GstCaps *caps = gst_video_info_to_caps(&info);
+  GstSample *sample = gst_sample_new(input, caps, nullptr, nullptr);
+  gst_caps_unref(caps);
+
+  std::string error;
+  encoded = EncoderPool::encode(codec, quality, sample, error);
+  gst_sample_unref(sample);
+
+  if (!encoded) {
+    SetError(error);
+  }
+}
+
+Napi::Promise::Deferred EncodeSampleWorker::GetPromise() { return deferred; }
+
+void EncodeSampleWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+
+  GstMapInfo map;
+  if (!gst_buffer_map(encoded, &map, GST_MAP_READ)) {
+    deferred.Reject(Napi::Error::New(Env(), "Failed to map encoded buffer").Value());
+    return;
+  }
+  Napi::Buffer<uint8_t> result = Napi::Buffer<uint8_t>::Copy(Env(), map.data, map.size);
+  gst_buffer_unmap(encoded, &map);
+
+  deferred.Resolve(result);
+}
+
+void EncodeSampleWorker::OnError(const Napi::Error &error) {
+  Napi::HandleScope scope(Env());
+  deferred.Reject(error.Value());
+}
+
+void EncodeSampleWorker::cleanup() {
+  if (encoded) {
+    gst_buffer_unref(encoded);
+    encoded = nullptr;
+  }
+  if (input) {
+    gst_buffer_unref(input);
+    input = nullptr;
+  }
+}
+
+// PullRegionsWorker implementation
+PullRegionsWorker::PullRegionsWorker(
+  const Napi::Env &env, GstAppSink *app_sink, guint64 timeout_ms, std::vector<Rect> rects,
+  GstVideoFormat format, double scale
+) :
+    Napi::AsyncWorker(env), app_sink(app_sink), timeout_ms(timeout_ms), rects(std::move(rects)),
+    format(format), scale(scale), sample(nullptr), deferred(env) {
+  gst_object_ref(app_sink);
+}
+
+PullRegionsWorker::~PullRegionsWorker() { cleanup(); }
+
+void PullRegionsWorker::Execute() {
+  sample = gst_app_sink_try_pull_sample(app_sink, timeout_ms * GST_MSECOND);
+  if (!sample) {
+    return;
+  }
+
+  GstVideoInfo info;
+  GstCaps *caps = gst_sample_get_caps(sample);
+  GstBuffer *buffer = gst_sample_get_buffer(sample);
+  if (!caps || !buffer || !gst_video_info_from_caps(&info, caps)) {
+    SetError("Sample is not raw video");
+    return;
+  }
+
+  GstVideoFrame frame;
+  if (!gst_video_frame_map(&frame, &info, buffer, GST_MAP_READ)) {
+    SetError("Failed to map video frame");
+    return;
+  }
+  bool extracted = extract(&frame);
+  gst_video_frame_unmap(&frame);
+
+  if (!extracted) {
+    regions.clear();
+    data.clear();
+  }
+}
+
+bool PullRegionsWorker::extract(GstVideoFrame *frame) {
+  GstVideoInfo *in_info = &frame->info;
+  GstVideoFormat out_format =
+    format != GST_VIDEO_FORMAT_UNKNOWN ? format : GST_VIDEO_INFO_FORMAT(in_info);
+
+  // Lay out all regions first so the output is allocated once
+  size_t total = 0;
+  for (size_t i = 0; i < rects.size(); i++) {
+    const Rect &rect = rects[i];
+    // Checked one value at a time, sums of unchecked input could overflow
+    gint frame_width = GST_VIDEO_INFO_WIDTH(in_info);
+    gint frame_height = GST_VIDEO_INFO_HEIGHT(in_info);
+    if (rect.x >= frame_width || rect.width > frame_width - rect.x || rect.y >= frame_height
+        || rect.height > frame_height - rect.y) {
+      SetError(
+        "Region " + std::to_string(i) + " lies outside the "
+        + std::to_string(GST_VIDEO_INFO_WIDTH(in_info)) + "x"
+        + std::to_string(GST_VIDEO_INFO_HEIGHT(in_info)) + " frame"
+      );
+      return false;
+    }
+
+    Region region;
+    gst_video_info_set_format(
+      &region.info, out_format, std::max(1L, std::lround(rect.width * scale)),
+      std::max(1L, std::lround(rect.height * scale))
+    );
+    region.offset = total;
+    region.size = GST_VIDEO_INFO_SIZE(&region.info);
+    total += region.size;
+    regions.push_back(region);
+  }
+  data.resize(total);
+
+  for (size_t i = 0; i < rects.size(); i++) {
+    const Rect &rect = rects[i];
+    Region &region = regions[i];
+
+    // The converter only reads the lines of the source rectangle, honoring plane strides
+    GstStructure *config = gst_structure_new(
+      "GstVideoConverter", GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, rect.x,
+      GST_VIDEO_CONVERTER_OPT_SRC_Y, G_TYPE_INT, rect.y, GST_VIDEO_CONVERTER_OPT_SRC_WIDTH,
+      G_TYPE_INT, rect.width, GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, rect.height, NULL
+    );
+    GstVideoConverter *converter = gst_video_converter_new(in_info, &region.info, config);
+    if (!converter) {
+      SetError("Unsupported conversion");
+      return false;
+    }
+
+    GstBuffer *out_buffer = gst_buffer_new_wrapped_full(
+      static_cast<GstMemoryFlags>(0), data.data() + region.offset, region.size, 0, region.size,
+      nullptr, nullptr
+    );
+    GstVideoFrame out_frame;
+    bool mapped = gst_video_frame_map(&out_frame, &region.info, out_buffer, GST_MAP_WRITE);
+    if (mapped) {
+      gst_video_converter_frame(converter, frame, &out_frame);
+      gst_video_frame_unmap(&out_frame);
+    }
+    gst_buffer_unref(out_buffer);
+    gst_video_converter_free(converter);
+
+    if (!mapped) {
+      SetError("Failed to map region");
+      return false;
+    }
+  }
+  return true;
+}
+
+Napi::Promise::Deferred PullRegionsWorker::GetPromise() { return deferred; }
+
+void PullRegionsWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+  Napi::Env env = Env();
+
+  if (!sample) {
+    deferred.Resolve(env.Null());
+    return;
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("buffer", Napi::Buffer<uint8_t>::Copy(env, data.data(), data.size()));
+
+  GstBuffer *buffer = gst_sample_get_buffer(sample);
+  if (GST_BUFFER_PTS_IS_VALID(buffer)) {
+    result.Set("pts", Napi::Number::New(env, static_cast<double>(GST_BUFFER_PTS(buffer))));
+  }
+  result.Set("flags", Napi::Number::New(env, static_cast<uint32_t>(GST_BUFFER_FLAGS(buffer))));
+
+  Napi::Array js_regions = Napi::Array::New(env, regions.size());
+  for (size_t i = 0; i < regions.size(); i++) {
+    const GstVideoInfo &info = regions[i].info;
+    Napi::Object region = Napi::Object::New(env);
+    region.Set("format", Napi::String::New(env, GST_VIDEO_INFO_NAME(&info)));
+    region.Set("width", Napi::Number::New(env, GST_VIDEO_INFO_WIDTH(&info)));
+    region.Set("height", Napi::Number::New(env, GST_VIDEO_INFO_HEIGHT(&info)));
+    region.Set("offset", Napi::Number::New(env, static_cast<double>(regions[i].offset)));
+    region.Set("size", Napi::Number::New(env, static_cast<double>(regions[i].size)));
+
+    Napi::Array strides = Napi::Array::New(env, GST_VIDEO_INFO_N_PLANES(&info));
+    for (guint p = 0; p < GST_VIDEO_INFO_N_PLANES(&info); p++) {
+      strides.Set(p, Napi::Number::New(env, GST_VIDEO_INFO_PLANE_STRIDE(&info, p)));
+    }
+    region.Set("strides", strides);
+    js_regions.Set(static_cast<uint32_t>(i), region);
+  }
+  result.Set("regions", js_regions);
+
+  deferred.Resolve(result);
+}
+
+void PullRegionsWorker::OnError(const Napi::Error &error) {
+  Napi::HandleScope scope(Env());
+  deferred.Reject(error.Value());
+}
+
+void PullRegionsWorker::cleanup() {
+  if (sample) {
+    gst_sample_unref(sample);
+    sample = nullptr;
+  }
+  if (app_sink) {
+    gst_object_unref(app_sink);
+    app_sink = nullptr;
+  }
+}
+
+// PreRecordFlushWorker implementation
+PreRecordFlushWorker::PreRecordFlushWorker(
+  const Napi::Env &env, std::unique_ptr<PreRecordSnapshot> snapshot, const std::string &path,
+  GstAppSrc *app_src
+) :
+    Napi::AsyncWorker(env), snapshot(std::move(snapshot)), path(path), app_src(app_src),
+    written_bytes(0), deferred(env) {
+  if (app_src) {
+    gst_object_ref(app_src);
+  }
+}
+
+PreRecordFlushWorker::~PreRecordFlushWorker() { cleanup(); }
+
+void PreRecordFlushWorker::Execute() {
+  if (app_src) {
+    push_to_app_src();
+  } else {
+    write_file();
+  }
+}
+
+void PreRecordFlushWorker::write_file() {
+  FILE *file = std::fopen(path.c_str(), "wb");
+  if (!file) {
+    SetError("Failed to open " + path + ": " + std::strerror(errno));
+    return;
+  }
+
+  // Headers first so the dump can be decoded on its own
+  for (const std::vector<GstBuffer *> *list : {&snapshot->headers, &snapshot->buffers}) {
+    for (GstBuffer *buffer : *list) {
+      GstMapInfo map;
+      if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+        continue;
+      }
+      size_t written = std::fwrite(map.data, 1, map.size, file);
+      gst_buffer_unmap(buffer, &map);
+      written_bytes += written;
+
+      if (written != map.size) {
+        SetError("Failed to write " + path + ": " + std::strerror(errno));
+        std::fclose(file);
+        return;
+      }
+    }
+  }
+
+  if (std::fclose(file) != 0) {
+    SetError("Failed to write " + path + ": " + std::strerror(errno));
+  }
+}
+
+void PreRecordFlushWorker::push_to_app_src() {
+  if (snapshot->caps) {
+    gst_app_src_set_caps(app_src, snapshot->caps);
+  }
+
+  // The receiving pipeline starts at 0, so timestamps are rebased onto the earliest one in the
+  // snapshot. Otherwise its sinks would wait out the time the source had been running.
+  GstClockTime base = GST_CLOCK_TIME_NONE;
+  for (GstBuffer *buffer : snapshot->buffers) {
+    for (GstClockTime time : {GST_BUFFER_DTS(buffer), GST_BUFFER_PTS(buffer)}) {
+      if (GST_CLOCK_TIME_IS_VALID(time) && (!GST_CLOCK_TIME_IS_VALID(base) || time < base)) {
+        base = time;
+      }
+    }
+  }
+  auto rebase = [base](GstClockTime time) {
+    if (!GST_CLOCK_TIME_IS_VALID(time) || !GST_CLOCK_TIME_IS_VALID(base)) {
+      return time;
+    }
+    return time > base ? time - base : 0;
+  };
+
+  for (const std::vector<GstBuffer *> *list : {&snapshot->headers, &snapshot->buffers}) {
+    for (GstBuffer *buffer : *list) {
+      size_t size = gst_buffer_get_size(buffer);
+      // Shallow copy for the new timestamps, the memory stays shared with the ring.
+      // push_buffer takes ownership of it.
+      GstBuffer *copy = gst_buffer_copy(buffer);
+      GST_BUFFER_PTS(copy) = rebase(GST_BUFFER_PTS(copy));
+      GST_BUFFER_DTS(copy) = rebase(GST_BUFFER_DTS(copy));
+      GstFlowReturn ret = gst_app_src_push_buffer(app_src, copy);
+      if (ret != GST_FLOW_OK) {
+        SetError(std::string("Failed to push buffer: ") + gst_flow_get_name(ret));
+        return;
+      }
+      written_bytes += size;
+    }
+  }
+}
+
+Napi::Promise::Deferred PreRecordFlushWorker::GetPromise() { return deferred; }
+
+void PreRecordFlushWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+
+  size_t buffers = snapshot->headers.size() + snapshot->buffers.size();
+  Napi::Object result = Napi::Object::New(Env());
+  result.Set("buffers", Napi::Number::New(Env(), static_cast<double>(buffers)));
+  result.Set("bytes", Napi::Number::New(Env(), static_cast<double>(written_bytes)));
+  result.Set(
+    "duration", Napi::Number::New(Env(), static_cast<double>(snapshot->duration) / GST_SECOND)
+  );
+  deferred.Resolve(result);
+}
+
+void PreRecordFlushWorker::OnError(const Napi::Error &error) {
+  Napi::HandleScope scope(Env());
+  deferred.Reject(error.Value());
+}
+
+void PreRecordFlushWorker::cleanup() {
+  snapshot.reset();
+  if (app_src) {
+    gst_object_unref(app_src);
+    app_src = nullptr;
+  }
+}
+
+// KeyframeIndexSaveWorker implementation
+KeyframeIndexSaveWorker::KeyframeIndexSaveWorker(
+  const Napi::Env &env, std::vector<KeyframeEntry> entries, const std::string &path
+) :
+    Napi::AsyncWorker(env), entries(std::move(entries)), path(path), written_bytes(0),
+    deferred(env) {}
+
+void KeyframeIndexSaveWorker::Execute() {
+  std::string error;
+  written_bytes = KeyframeIndex::write_file(path, entries, error);
+  if (!error.empty()) {
+    SetError(error);
+  }
+}
+
+Napi::Promise::Deferred KeyframeIndexSaveWorker::GetPromise() { return deferred; }
+
+void KeyframeIndexSaveWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+
+  Napi::Object result = Napi::Object::New(Env());
+  result.Set("entries", Napi::Number::New(Env(), static_cast<double>(entries.size())));
+  result.Set("bytes", Napi::Number::New(Env(), static_cast<double>(written_bytes)));
+  deferred.Resolve(result);
+}
+
+void KeyframeIndexSaveWorker::OnError(const Napi::Error &error) {
+  Napi::HandleScope scope(Env());
+  deferred.Reject(error.Value());
+}
+
+// KeyframeIndexLoadWorker implementation
+KeyframeIndexLoadWorker::KeyframeIndexLoadWorker(const Napi::Env &env, const std::string &path) :
+    Napi::AsyncWorker(env), path(path), deferred(env) {}
+
+void KeyframeIndexLoadWorker::Execute() {
+  std::string error;
+  if (!KeyframeIndex::read_file(path, entries, error)) {
+    SetError(error);
+  }
+}
+
+Napi::Promise::Deferred KeyframeIndexLoadWorker::GetPromise() { return deferred; }
+
+void KeyframeIndexLoadWorker::OnOK() {
+  Napi::HandleScope scope(Env());
+  deferred.Resolve(KeyframeIndex::to_js(Env(), entries));
+}
+
+void KeyframeIndexLoadWorker::OnError(const Napi::Error &error) {
+  Napi::HandleScope scope(Env());
+  deferred.Reject(error.Value());
+}
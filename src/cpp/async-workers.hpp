@@ -1,9 +1,15 @@
 #pragma once
 
+#include "keyframe-index.hpp"
+#include "prerecord-ring.hpp"
 #include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
 #include <gst/gst.h>
+#include <gst/video/video.h>
 #include <memory>
 #include <napi.h>
+#include <string>
+#include <vector>
 
 // Forward declarations
 namespace TypeConversion {
@@ -32,10 +38,14 @@ private:
   Napi::Promise::Deferred deferred;
 };
 
-// AsyncWorker for pulling samples with timeout
+// AsyncWorker for pulling samples (or the preroll sample) with timeout. With video_frame the
+// result is a mapped VideoFrame instead of a copied sample.
 class PullSampleWorker : public Napi::AsyncWorker {
 public:
-  PullSampleWorker(const Napi::Env &env, GstAppSink *app_sink, guint64 timeout_ms);
+  PullSampleWorker(
+    const Napi::Env &env, GstAppSink *app_sink, guint64 timeout_ms, bool preroll = false,
+    bool video_frame = false
+  );
   ~PullSampleWorker();
 
   void Execute() override;
@@ -49,6 +59,35 @@ private:
 
   GstAppSink *app_sink;
   guint64 timeout_ms;
+  bool preroll;
+  bool video_frame;
+  GstSample *sample;
+  Napi::Promise::Deferred deferred;
+};
+
+// AsyncWorker for stepping an app sink and pulling the frame it prerolls on
+class StepWorker : public Napi::AsyncWorker {
+public:
+  StepWorker(
+    const Napi::Env &env, GstAppSink *app_sink, GstFormat format, guint64 amount, gdouble rate,
+    guint64 timeout_ms
+  );
+  ~StepWorker();
+
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &error) override;
+
+  Napi::Promise::Deferred GetPromise();
+
+private:
+  void cleanup();
+
+  GstAppSink *app_sink;
+  GstFormat format;
+  guint64 amount;
+  gdouble rate;
+  guint64 timeout_ms;
   GstSample *sample;
   Napi::Promise::Deferred deferred;
 };
@@ -77,3 +116,200 @@ private:
   GstState final_state;
   Napi::Promise::Deferred deferred;
 };
+
+// AsyncWorker for changing the graph of a running pipeline. Pads carrying data are only
+// touched from idle pad probes, so branches can be added and removed while PLAYING.
+class ReconfigureWorker : public Napi::AsyncWorker {
+public:
+  enum class Operation { Link, Unlink, Remove };
+
+  ReconfigureWorker(
+    const Napi::Env &env, GstPipeline *pipeline, Operation operation, const std::string &src_name,
+    const std::string &sink_name, const std::string &src_pad_name,
+    const std::string &sink_pad_name, bool send_eos, GstClockTime timeout
+  );
+  ~ReconfigureWorker();
+
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &error) override;
+
+  Napi::Promise::Deferred GetPromise();
+
+private:
+  void cleanup();
+  void link();
+  void unlink();
+  void remove();
+  GstElement *find_element(const std::string &name);
+
+  GstPipeline *pipeline;
+  Operation operation;
+  std::string src_name;
+  std::string sink_name;
+  std::string src_pad_name;
+  std::string sink_pad_name;
+  bool send_eos;
+  GstClockTime timeout;
+  Napi::Promise::Deferred deferred;
+};
+
+// AsyncWorker converting a raw video frame with GstVideoConverter. Both buffers are owned by
+// JS and kept alive by references; the converter writes straight into the output buffer.
+class ConvertSampleWorker : public Napi::AsyncWorker {
+public:
+  ConvertSampleWorker(
+    const Napi::Env &env, const Napi::Buffer<uint8_t> &input, const GstVideoInfo &in_info,
+    const GstVideoInfo &out_info, GstStructure *config, guint32 flags
+  );
+  ~ConvertSampleWorker();
+
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &error) override;
+
+  Napi::Promise::Deferred GetPromise();
+
+private:
+  void cleanup();
+
+  Napi::Reference<Napi::Buffer<uint8_t>> input;
+  Napi::Reference<Napi::Buffer<uint8_t>> output;
+  uint8_t *input_data;
+  uint8_t *output_data;
+  GstVideoInfo in_info;
+  GstVideoInfo out_info;
+  GstStructure *config;
+  guint32 flags;
+  Napi::Promise::Deferred deferred;
+};
+
+// AsyncWorker encoding a raw video frame to JPEG/PNG/WebP through the EncoderPool
+class EncodeSampleWorker : public Napi::AsyncWorker {
+public:
+  EncodeSampleWorker(
+    const Napi::Env &env, const Napi::Buffer<uint8_t> &input, const GstVideoInfo &info,
+    const std::string &codec, int quality
+  );
+  ~EncodeSampleWorker();
+
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &error) override;
+
+  Napi::Promise::Deferred GetPromise();
+
+private:
+  void cleanup();
+
+  GstBuffer *input; // Wraps the JS buffer, which stays pinned while anything references it
+  GstVideoInfo info;
+  std::string codec;
+  int quality;
+  GstBuffer *encoded;
+  Napi::Promise::Deferred deferred;
+};
+
+// AsyncWorker pulling a raw video sample and copying only the requested rectangles out of it,
+// optionally scaled and converted, packed one after another into a single buffer
+class PullRegionsWorker : public Napi::AsyncWorker {
+public:
+  struct Rect {
+    gint x, y, width, height;
+  };
+
+  PullRegionsWorker(
+    const Napi::Env &env, GstAppSink *app_sink, guint64 timeout_ms, std::vector<Rect> rects,
+    GstVideoFormat format, double scale
+  );
+  ~PullRegionsWorker();
+
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &error) override;
+
+  Napi::Promise::Deferred GetPromise();
+
+private:
+  void cleanup();
+  bool extract(GstVideoFrame *frame);
+
+  struct Region {
+    size_t offset, size;
+    GstVideoInfo info;
+  };
+
+  GstAppSink *app_sink;
+  guint64 timeout_ms;
+  std::vector<Rect> rects;
+  GstVideoFormat format;
+  double scale;
+  GstSample *sample;
+  std::vector<uint8_t> data;
+  std::vector<Region> regions;
+  Napi::Promise::Deferred deferred;
+};
+
+// AsyncWorker writing a pre-record snapshot to a file, or pushing it into an app source
+class PreRecordFlushWorker : public Napi::AsyncWorker {
+public:
+  PreRecordFlushWorker(
+    const Napi::Env &env, std::unique_ptr<PreRecordSnapshot> snapshot, const std::string &path,
+    GstAppSrc *app_src
+  );
+  ~PreRecordFlushWorker();
+
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &error) override;
+
+  Napi::Promise::Deferred GetPromise();
+
+private:
+  void cleanup();
+  void write_file();
+  void push_to_app_src();
+
+  std::unique_ptr<PreRecordSnapshot> snapshot;
+  std::string path;
+  GstAppSrc *app_src;
+  size_t written_bytes;
+  Napi::Promise::Deferred deferred;
+};
+
+// AsyncWorker writing a keyframe index sidecar file
+class KeyframeIndexSaveWorker : public Napi::AsyncWorker {
+public:
+  KeyframeIndexSaveWorker(
+    const Napi::Env &env, std::vector<KeyframeEntry> entries, const std::string &path
+  );
+
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &error) override;
+
+  Napi::Promise::Deferred GetPromise();
+
+private:
+  std::vector<KeyframeEntry> entries;
+  std::string path;
+  size_t written_bytes;
+  Napi::Promise::Deferred deferred;
+};
+
+// AsyncWorker reading a keyframe index sidecar file
+class KeyframeIndexLoadWorker : public Napi::AsyncWorker {
+public:
+  KeyframeIndexLoadWorker(const Napi::Env &env, const std::string &path);
+
+  void Execute() override;
+  void OnOK() override;
+  void OnError(const Napi::Error &error) override;
+
+  Napi::Promise::Deferred GetPromise();
+
+private:
+  std::string path;
+  std::vector<KeyframeEntry> entries;
+  Napi::Promise::Deferred deferred;
+};
@@ -0,0 +1,289 @@
+#include "audio-meter.hpp"
+#include "simd.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// EBU R128 / ITU-R BS.1770 windows, built from 100ms blocks
+static const size_t MOMENTARY_BLOCKS = 4;
+static const size_t SHORT_TERM_BLOCKS = 30;
+
+static double to_db(double amplitude) {
+  return amplitude > 0 ? 20.0 * std::log10(amplitude) : -std::numeric_limits<double>::infinity();
+}
+
+// BS.1770 channel weights: surround channels count 1.41x, LFE is ignored
+static double channel_weight(GstAudioChannelPosition position) {
+  switch (position) {
+    case GST_AUDIO_CHANNEL_POSITION_LFE1:
+    case GST_AUDIO_CHANNEL_POSITION_LFE2:
+      return 0.0;
+    case GST_AUDIO_CHANNEL_POSITION_REAR_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_REAR_RIGHT:
+    case GST_AUDIO_CHANNEL_POSITION_SIDE_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_SIDE_RIGHT:
+    case GST_AUDIO_CHANNEL_POSITION_SURROUND_LEFT:
+    case GST_AUDIO_CHANNEL_POSITION_SURROUND_RIGHT:
+      return 1.41;
+    default:
+      return 1.0;
+  }
+}
+
+AudioMeter::AudioMeter(double interval_seconds) : interval_seconds(interval_seconds) {}
+
+bool AudioMeter::configure(GstCaps *caps) {
+  configured = false;
+
+  GstAudioInfo info;
+  if (!caps || !gst_audio_info_from_caps(&info, caps)) {
+    return false;
+  }
+
+  GstAudioFormat caps_format = GST_AUDIO_INFO_FORMAT(&info);
+  if (caps_format != GST_AUDIO_FORMAT_S16 && caps_format != GST_AUDIO_FORMAT_S32
+      && caps_format != GST_AUDIO_FORMAT_F32) {
+    return false;
+  }
+  if (GST_AUDIO_INFO_CHANNELS(&info) > 1
+      && GST_AUDIO_INFO_LAYOUT(&info) != GST_AUDIO_LAYOUT_INTERLEAVED) {
+    return false;
+  }
+
+  format = caps_format;
+  rate = GST_AUDIO_INFO_RATE(&info);
+  channels = static_cast<size_t>(GST_AUDIO_INFO_CHANNELS(&info));
+
+  weights.assign(channels, 1.0);
+  if (!GST_AUDIO_INFO_IS_UNPOSITIONED(&info)) {
+    for (size_t c = 0; c < channels; c++) {
+      weights[c] = channel_weight(info.position[c]);
+    }
+  }
+
+  window_frames = std::max<size_t>(1, static_cast<size_t>(std::lround(rate * interval_seconds)));
+  block_frames = std::max<size_t>(1, static_cast<size_t>(rate / 10));
+
+  design_filters();
+  configured = true;
+  reset();
+  return true;
+}
+
+void AudioMeter::design_filters() {
+  // K-weighting pre-filter (high shelf) and RLB high-pass, bilinear transform of the
+  // BS.1770 analog prototypes so any sample rate gets the reference response
+  const double pi = 3.14159265358979323846;
+
+  double f0 = 1681.974450955533;
+  double gain = 3.999843853973347;
+  double q = 0.7071752369554196;
+  double k = std::tan(pi * f0 / rate);
+  double vh = std::pow(10.0, gain / 20.0);
+  double vb = std::pow(vh, 0.4996667741545416);
+  double a0 = 1.0 + k / q + k * k;
+  shelf.b0 = (vh + vb * k / q + k * k) / a0;
+  shelf.b1 = 2.0 * (k * k - vh) / a0;
+  shelf.b2 = (vh - vb * k / q + k * k) / a0;
+  shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+  shelf.a2 = (1.0 - k / q + k * k) / a0;
+
+  f0 = 38.13547087602444;
+  q = 0.5003270373238773;
+  k = std::tan(pi * f0 / rate);
+  a0 = 1.0 + k / q + k * k;
+  highpass.b0 = 1.0;
+  highpass.b1 = -2.0;
+  highpass.b2 = 1.0;
+  highpass.a1 = 2.0 * (k * k - 1.0) / a0;
+  highpass.a2 = (1.0 - k / q + k * k) / a0;
+
+  // True-peak: 4x oversampling below 96kHz, 2x below 192kHz, sample peak above
+  size_t factor = rate < 96000 ? 4 : rate < 192000 ? 2 : 1;
+  phases.clear();
+  taps_per_phase = 0;
+  if (factor == 1) {
+    return;
+  }
+
+  // Hann-windowed sinc low-pass at the original Nyquist frequency, split into phases and
+  // reversed so each phase is a plain dot product over the most recent samples
+  taps_per_phase = 12;
+  size_t length = factor * taps_per_phase;
+  double center = (length - 1) / 2.0;
+  std::vector<double> prototype(length);
+  for (size_t m = 0; m < length; m++) {
+    double x = (m - center) / factor;
+    double sinc = x == 0 ? 1.0 : std::sin(pi * x) / (pi * x);
+    double window = 0.5 - 0.5 * std::cos(2.0 * pi * (m + 1) / (length + 1));
+    prototype[m] = sinc * window;
+  }
+
+  phases.assign(factor, std::vector<float>(taps_per_phase));
+  for (size_t p = 0; p < factor; p++) {
+    for (size_t j = 0; j < taps_per_phase; j++) {
+      phases[p][j] = static_cast<float>(prototype[p + (taps_per_phase - 1 - j) * factor]);
+    }
+  }
+}
+
+void AudioMeter::reset() {
+  filter_state.assign(channels * 4, 0.0);
+  history.assign(channels, std::vector<float>(taps_per_phase > 0 ? taps_per_phase - 1 : 0, 0.0f));
+
+  window_fill = 0;
+  window_end = GST_CLOCK_TIME_NONE;
+  peak.assign(channels, 0.0f);
+  true_peak.assign(channels, 0.0f);
+  energy.assign(channels, 0.0);
+
+  block_fill = 0;
+  block_energy.assign(channels, 0.0);
+  blocks.clear();
+}
+
+bool AudioMeter::process(GstBuffer *buffer) {
+  if (!configured) {
+    return false;
+  }
+
+  GstMapInfo map;
+  if (!gst_buffer_map(buffer, &map, GST_MAP_READ)) {
+    return false;
+  }
+
+  size_t frames = map.size / (channels * (format == GST_AUDIO_FORMAT_S16 ? 2 : 4));
+  size_t samples = frames * channels;
+  const float *interleaved = reinterpret_cast<const float *>(map.data);
+  if (format != GST_AUDIO_FORMAT_F32) {
+    converted.resize(samples);
+    if (format == GST_AUDIO_FORMAT_S16) {
+      Simd::s16_to_f32(reinterpret_cast<const int16_t *>(map.data), converted.data(), samples);
+    } else {
+      Simd::s32_to_f32(reinterpret_cast<const int32_t *>(map.data), converted.data(), samples);
+    }
+    interleaved = converted.data();
+  }
+
+  // Each channel is deinterleaved behind the tail of the previous buffer so the true-peak
+  // filter sees a continuous signal
+  size_t history_length = taps_per_phase > 0 ? taps_per_phase - 1 : 0;
+  planar.resize(history_length + frames);
+  weighted.resize(channels * frames);
+
+  for (size_t c = 0; c < channels; c++) {
+    std::copy(history[c].begin(), history[c].end(), planar.begin());
+    float *channel = planar.data() + history_length;
+    for (size_t i = 0; i < frames; i++) {
+      channel[i] = interleaved[i * channels + c];
+    }
+
+    Simd::PeakEnergy levels = Simd::peak_energy(channel, frames);
+    peak[c] = std::max(peak[c], levels.peak);
+    energy[c] += levels.energy;
+
+    // Interpolated peaks can only exceed the sample peak, never undershoot it
+    float channel_true_peak = levels.peak;
+    for (const std::vector<float> &taps : phases) {
+      channel_true_peak = std::max(
+        channel_true_peak, Simd::max_abs_fir(planar.data(), frames, taps.data(), taps.size())
+      );
+    }
+    true_peak[c] = std::max(true_peak[c], channel_true_peak);
+
+    if (history_length > 0 && frames > 0) {
+      std::copy(planar.end() - history_length, planar.end(), history[c].begin());
+    }
+
+    // The IIR filters depend on their previous output, so this part stays scalar
+    double *state = filter_state.data() + c * 4;
+    float *out = weighted.data() + c * frames;
+    for (size_t i = 0; i < frames; i++) {
+      double x = channel[i];
+      double y = shelf.b0 * x + state[0];
+      state[0] = shelf.b1 * x - shelf.a1 * y + state[1];
+      state[1] = shelf.b2 * x - shelf.a2 * y;
+
+      double z = highpass.b0 * y + state[2];
+      state[2] = highpass.b1 * y - highpass.a1 * z + state[3];
+      state[3] = highpass.b2 * y - highpass.a2 * z;
+      out[i] = static_cast<float>(z);
+    }
+  }
+
+  gst_buffer_unmap(buffer, &map);
+
+  // Split the K-weighted signal into 100ms loudness blocks
+  size_t offset = 0;
+  while (offset < frames) {
+    size_t count = std::min(frames - offset, block_frames - block_fill);
+    for (size_t c = 0; c < channels; c++) {
+      block_energy[c] += Simd::peak_energy(weighted.data() + c * frames + offset, count).energy;
+    }
+    block_fill += count;
+    offset += count;
+
+    if (block_fill == block_frames) {
+      for (double &value : block_energy) {
+        value /= static_cast<double>(block_frames);
+      }
+      blocks.push_back(block_energy);
+      if (blocks.size() > SHORT_TERM_BLOCKS) {
+        blocks.pop_front();
+      }
+      block_energy.assign(channels, 0.0);
+      block_fill = 0;
+    }
+  }
+
+  if (GST_BUFFER_PTS_IS_VALID(buffer)) {
+    window_end = GST_BUFFER_PTS(buffer)
+                 + (GST_BUFFER_DURATION_IS_VALID(buffer)
+                      ? GST_BUFFER_DURATION(buffer)
+                      : gst_util_uint64_scale_int(frames, GST_SECOND, rate));
+  }
+  window_fill += frames;
+  return window_fill >= window_frames;
+}
+
+std::optional<double> AudioMeter::loudness(size_t count) const {
+  if (blocks.size() < count) {
+    return std::nullopt;
+  }
+
+  double sum = 0;
+  for (size_t c = 0; c < channels; c++) {
+    double mean_square = 0;
+    for (size_t b = blocks.size() - count; b < blocks.size(); b++) {
+      mean_square += blocks[b][c];
+    }
+    sum += weights[c] * mean_square / static_cast<double>(count);
+  }
+
+  if (sum <= 0) {
+    return -std::numeric_limits<double>::infinity();
+  }
+  return -0.691 + 10.0 * std::log10(sum);
+}
+
+AudioLevels AudioMeter::take() {
+  AudioLevels levels;
+  levels.pts = window_end;
+  levels.duration = rate > 0 ? static_cast<double>(window_fill) / rate : 0;
+
+  for (size_t c = 0; c < channels; c++) {
+    levels.peak.push_back(to_db(peak[c]));
+    levels.true_peak.push_back(to_db(true_peak[c]));
+    levels.rms.push_back(
+      to_db(window_fill > 0 ? std::sqrt(energy[c] / static_cast<double>(window_fill)) : 0)
+    );
+  }
+  levels.momentary = loudness(MOMENTARY_BLOCKS);
+  levels.short_term = loudness(SHORT_TERM_BLOCKS);
+
+  window_fill = 0;
+  peak.assign(channels, 0.0f);
+  true_peak.assign(channels, 0.0f);
+  energy.assign(channels, 0.0);
+  return levels;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <deque>
+#include <gst/audio/audio.h>
+#include <gst/gst.h>
+#include <optional>
+#include <vector>
+
+// Levels of one window. dB values are -Infinity for digital silence.
+struct AudioLevels {
+  GstClockTime pts = GST_CLOCK_TIME_NONE; // End of the last buffer in the window
+  double duration = 0;                    // Seconds of audio in the window
+  std::vector<double> peak;               // dBFS per channel
+  std::vector<double> rms;                // dBFS per channel
+  std::vector<double> true_peak;          // dBTP per channel, 4x oversampled below 96kHz
+  std::optional<double> momentary;        // LUFS over the last 400ms
+  std::optional<double> short_term;       // LUFS over the last 3s
+};
+
+// Peak, RMS, true-peak and EBU R128 loudness of interleaved S16, S32 or F32 audio.
+// Not thread safe; driven from the streaming thread of a single pad.
+class AudioMeter {
+public:
+  explicit AudioMeter(double interval_seconds);
+
+  // Returns false for formats the meter cannot read
+  bool configure(GstCaps *caps);
+  // Returns true once a window is complete and take() has levels to report
+  bool process(GstBuffer *buffer);
+  AudioLevels take();
+  // Drop filter state and loudness history, e.g. after a flush
+  void reset();
+
+private:
+  // K-weighting stage, transposed direct form II
+  struct Biquad {
+    double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+  };
+
+  void design_filters();
+  std::optional<double> loudness(size_t blocks) const;
+
+  double interval_seconds;
+  bool configured = false;
+  GstAudioFormat format = GST_AUDIO_FORMAT_UNKNOWN;
+  int rate = 0;
+  size_t channels = 0;
+  std::vector<double> weights;
+
+  Biquad shelf, highpass;
+  // Two delay elements per stage and channel
+  std::vector<double> filter_state;
+
+  // Polyphase interpolation filter for true-peak, one tap set per phase
+  size_t taps_per_phase = 0;
+  std::vector<std::vector<float>> phases;
+  std::vector<std::vector<float>> history;
+
+  // Current window
+  size_t window_frames = 0, window_fill = 0;
+  GstClockTime window_end = GST_CLOCK_TIME_NONE;
+  std::vector<float> peak, true_peak;
+  std::vector<double> energy;
+
+  // 100ms loudness blocks, mean square per channel
+  size_t block_frames = 0, block_fill = 0;
+  std::vector<double> block_energy;
+  std::deque<std::vector<double>> blocks;
+
+  // Scratch space reused between buffers
+  std::vector<float> converted, planar, weighted;
+};
@@ -0,0 +1,205 @@
+#include "buffer-arena.hpp"
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static GQuark arena_quark() {
+  static GQuark quark = g_quark_from_static_string("gst-kit-buffer-arena");
+  return quark;
+}
+
+BufferArena::BufferArena(const BufferArenaOptions &options) : options(options) {
+  min_class_size = 256;
+  while (min_class_size < options.alignment) {
+    min_class_size <<= 1;
+  }
+  counters.alignment = options.alignment;
+}
+
+BufferArena::~BufferArena() {
+  for (const Region &region : regions) {
+    unmap_region(region);
+  }
+}
+
+size_t BufferArena::page_size() {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwPageSize;
+#else
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+void BufferArena::attach(GstElement *element, std::shared_ptr<BufferArena> arena) {
+  if (!arena) {
+    g_object_set_qdata(G_OBJECT(element), arena_quark(), nullptr);
+    return;
+  }
+  g_object_set_qdata_full(
+    G_OBJECT(element), arena_quark(), new std::shared_ptr<BufferArena>(std::move(arena)),
+    [](gpointer data) { delete static_cast<std::shared_ptr<BufferArena> *>(data); }
+  );
+}
+
+std::shared_ptr<BufferArena> BufferArena::from_element(GstElement *element) {
+  gpointer data = g_object_get_qdata(G_OBJECT(element), arena_quark());
+  return data ? *static_cast<std::shared_ptr<BufferArena> *>(data) : nullptr;
+}
+
+int BufferArena::class_for(gsize size) const {
+  for (size_t size_class = 0; size_class < class_count; size_class++) {
+    if (size <= class_size(static_cast<int>(size_class))) {
+      return static_cast<int>(size_class);
+    }
+  }
+  return -1;
+}
+
+size_t BufferArena::class_size(int size_class) const { return min_class_size << size_class; }
+
+// Page-aligned memory straight from the system, which also satisfies the block alignment
+guint8 *BufferArena::map_region(size_t size, bool &huge) {
+  huge = false;
+#ifdef _WIN32
+  return static_cast<guint8 *>(
+    VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE)
+  );
+#else
+  void *data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  // Explicit huge pages need a reserved pool (vm.nr_hugepages), so this often fails
+  if (options.huge_pages && size % slab_size == 0) {
+    data = mmap(
+      nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0
+    );
+    huge = data != MAP_FAILED;
+  }
+#endif
+  if (data == MAP_FAILED) {
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      return nullptr;
+    }
+#ifdef MADV_HUGEPAGE
+    // Fall back to transparent huge pages
+    if (options.huge_pages) {
+      huge = madvise(data, size, MADV_HUGEPAGE) == 0;
+    }
+#endif
+  }
+  return static_cast<guint8 *>(data);
+#endif
+}
+
+void BufferArena::unmap_region(const Region &region) {
+#ifdef _WIN32
+  VirtualFree(region.data, 0, MEM_RELEASE);
+#else
+  munmap(region.data, region.size);
+#endif
+}
+
+void BufferArena::refill(int size_class) {
+  size_t block_size = class_size(size_class);
+  size_t region_size = std::max(block_size, slab_size);
+  bool huge;
+  guint8 *data = map_region(region_size, huge);
+  if (!data) {
+    return;
+  }
+
+  regions.push_back({data, region_size});
+  counters.slabs++;
+  counters.bytes_reserved += region_size;
+  if (huge) {
+    counters.huge_page_bytes += region_size;
+  }
+
+  // Last block pushed first, so the start of the slab is handed out first
+  std::vector<guint8 *> &free_list = free_lists[size_class];
+  for (size_t blocks = region_size / block_size; blocks > 0; blocks--) {
+    free_list.push_back(data + (blocks - 1) * block_size);
+  }
+}
+
+GstBuffer *BufferArena::new_buffer(gsize size) {
+  int size_class = class_for(std::max<gsize>(size, 1));
+  guint8 *data = nullptr;
+  size_t block_size;
+
+  if (size_class < 0) {
+    // Rare and huge, a dedicated mapping that is returned right away
+    size_t page = page_size();
+    block_size = (size + page - 1) / page * page;
+    bool huge;
+    std::lock_guard<std::mutex> lock(mutex);
+    data = map_region(block_size, huge);
+    if (data) {
+      counters.large_allocations++;
+    }
+  } else {
+    block_size = class_size(size_class);
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<guint8 *> &free_list = free_lists[size_class];
+    if (free_list.empty()) {
+      refill(size_class);
+    } else {
+      counters.recycled++;
+    }
+    if (!free_list.empty()) {
+      data = free_list.back();
+      free_list.pop_back();
+    }
+  }
+
+  if (!data) {
+    // Out of address space or mappings, keep pushing with the default allocator
+    return gst_buffer_new_allocate(nullptr, size, nullptr);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    counters.allocations++;
+    counters.bytes_in_use += block_size;
+    counters.peak_bytes_in_use = std::max(counters.peak_bytes_in_use, counters.bytes_in_use);
+  }
+
+  GstBuffer *buffer = gst_buffer_new();
+  gst_buffer_append_memory(
+    buffer, gst_memory_new_wrapped(
+              static_cast<GstMemoryFlags>(0), data, block_size, 0, size,
+              new Block{shared_from_this(), data, block_size, size_class}, release_block
+            )
+  );
+  return buffer;
+}
+
+void BufferArena::release_block(gpointer user_data) {
+  Block *block = static_cast<Block *>(user_data);
+  BufferArena *arena = block->arena.get();
+  {
+    std::lock_guard<std::mutex> lock(arena->mutex);
+    arena->counters.bytes_in_use -= block->size;
+    if (block->size_class >= 0) {
+      arena->free_lists[block->size_class].push_back(block->data);
+    }
+  }
+  if (block->size_class < 0) {
+    arena->unmap_region({block->data, block->size});
+  }
+  // May drop the last reference to the arena
+  delete block;
+}
+
+BufferArenaStats BufferArena::stats() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return counters;
+}
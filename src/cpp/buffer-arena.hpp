@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <gst/gst.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+struct BufferArenaOptions {
+  size_t alignment = 64; // Power of two, at most the page size
+  bool huge_pages = false; // Back slabs with huge pages where the system allows it
+};
+
+struct BufferArenaStats {
+  size_t alignment = 0;
+  guint64 allocations = 0;
+  guint64 recycled = 0; // Allocations served from a free list
+  guint64 slabs = 0;
+  guint64 large_allocations = 0; // Beyond the largest size class, never recycled
+  guint64 bytes_in_use = 0;
+  guint64 peak_bytes_in_use = 0;
+  guint64 bytes_reserved = 0; // Slab memory, kept until the arena is gone
+  guint64 huge_page_bytes = 0;
+};
+
+// Buffer memory for app sources. Sizes are rounded up to power-of-two classes, each class is
+// carved out of 2 MiB slabs (or one slab per block for big classes) and freed blocks go back to
+// their class's free list instead of the heap. Every block starts at the configured alignment.
+// Attached to an element with attach(), the arena lives until the element drops it and the last
+// buffer using its memory is freed.
+class BufferArena : public std::enable_shared_from_this<BufferArena> {
+public:
+  explicit BufferArena(const BufferArenaOptions &options);
+  ~BufferArena();
+
+  static size_t page_size();
+
+  // Store an arena on an element, or remove it with nullptr
+  static void attach(GstElement *element, std::shared_ptr<BufferArena> arena);
+  static std::shared_ptr<BufferArena> from_element(GstElement *element);
+
+  /**
+   * A buffer of the given size backed by arena memory. The content is uninitialized.
+   */
+  GstBuffer *new_buffer(gsize size);
+
+  BufferArenaStats stats();
+
+private:
+  static constexpr size_t class_count = 20;
+  static constexpr size_t slab_size = 2 * 1024 * 1024;
+
+  struct Block {
+    std::shared_ptr<BufferArena> arena;
+    guint8 *data;
+    size_t size;
+    int size_class; // -1 for large allocations
+  };
+
+  struct Region {
+    guint8 *data;
+    size_t size;
+  };
+
+  static void release_block(gpointer user_data);
+  int class_for(gsize size) const;
+  size_t class_size(int size_class) const;
+  guint8 *map_region(size_t size, bool &huge);
+  void unmap_region(const Region &region);
+  void refill(int size_class);
+
+  BufferArenaOptions options;
+  size_t min_class_size;
+  std::mutex mutex;
+  std::array<std::vector<guint8 *>, class_count> free_lists;
+  std::vector<Region> regions;
+  BufferArenaStats counters;
+};
@@ -1,12 +1,26 @@
 #include "element.hpp"
 #include "async-workers.hpp"
+#include "audio-meter.hpp"
+#include "buffer-arena.hpp"
+#include "fd-pump.hpp"
+#include "fingerprint.hpp"
+#include "keyframe-index.hpp"
+#include "memory-source.hpp"
+#include "motion-detector.hpp"
+#include "prerecord-ring.hpp"
+#include "sample-dispatcher.hpp"
 #include "type-conversion.hpp"
 #include <chrono>
+#include <cmath>
 #include <cstring>
+#include <gst/controller/controller.h>
 #include <gst/rtp/gstrtpbuffer.h>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 Napi::Object Element::CreateFromGstElement(const Napi::Env &env, GstElement *element) {
   Napi::Function func = DefineClass(env, "Element", {});
@@ -39,6 +53,23 @@ Element::Element(const Napi::CallbackInfo &info) :
     env, [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->on_sample(info); },
     "onSample"
   );
+  auto get_preroll_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->get_preroll(info); },
+    "getPreroll"
+  );
+  auto get_video_frame_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->get_video_frame(info); },
+    "getVideoFrame"
+  );
+  auto get_regions_method = Napi::Function::New(
+    env, [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->get_regions(info); },
+    "getRegions"
+  );
+  auto step_method = Napi::Function::New(
+    env, [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->step(info); }, "step"
+  );
   auto get_element_property_method = Napi::Function::New(
     env,
     [this](const Napi::CallbackInfo &info) -> Napi::Value {
@@ -53,6 +84,68 @@ Element::Element(const Napi::CallbackInfo &info) :
     },
     "setElementProperty"
   );
+  auto property_method = Napi::Function::New(
+    env, [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->property(info); },
+    "property"
+  );
+  auto get_properties_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->get_properties(info); },
+    "getProperties"
+  );
+  auto set_properties_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->set_properties(info); },
+    "setProperties"
+  );
+  auto on_property_change_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value {
+      return this->on_property_change(info);
+    },
+    "onPropertyChange"
+  );
+  auto add_audio_meter_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->add_audio_meter(info); },
+    "addAudioMeter"
+  );
+  auto add_motion_detector_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value {
+      return this->add_motion_detector(info);
+    },
+    "addMotionDetector"
+  );
+  auto add_fingerprinter_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->add_fingerprinter(info); },
+    "addFingerprinter"
+  );
+  auto add_prerecord_buffer_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value {
+      return this->add_prerecord_buffer(info);
+    },
+    "addPreRecordBuffer"
+  );
+  auto add_keyframe_indexer_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value {
+      return this->add_keyframe_indexer(info);
+    },
+    "addKeyframeIndexer"
+  );
+  auto set_keyframes_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->set_keyframes(info); },
+    "setKeyframes"
+  );
+  auto clear_keyframes_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->clear_keyframes(info); },
+    "clearKeyframes"
+  );
   auto add_pad_probe_method = Napi::Function::New(
     env,
     [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->add_pad_probe(info); },
@@ -74,6 +167,27 @@ Element::Element(const Napi::CallbackInfo &info) :
     [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->end_of_stream(info); },
     "endOfStream"
   );
+  auto set_memory_source_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->set_memory_source(info); },
+    "setMemorySource"
+  );
+  auto set_allocator_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->set_allocator(info); },
+    "setAllocator"
+  );
+  auto get_allocator_stats_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value {
+      return this->get_allocator_stats(info);
+    },
+    "getAllocatorStats"
+  );
+  auto pump_from_method = Napi::Function::New(
+    env, [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->pump_from(info); },
+    "pumpFrom"
+  );
 
   std::vector property_descriptors = {
     Napi::PropertyDescriptor::Value("type", Napi::String::New(env, element_type), napi_enumerable),
@@ -83,6 +197,23 @@ Element::Element(const Napi::CallbackInfo &info) :
     Napi::PropertyDescriptor::Value(
       "setElementProperty", set_element_property_method, napi_enumerable
     ),
+    Napi::PropertyDescriptor::Value("property", property_method, napi_enumerable),
+    Napi::PropertyDescriptor::Value("getProperties", get_properties_method, napi_enumerable),
+    Napi::PropertyDescriptor::Value("setProperties", set_properties_method, napi_enumerable),
+    Napi::PropertyDescriptor::Value("onPropertyChange", on_property_change_method, napi_enumerable),
+    Napi::PropertyDescriptor::Value("addAudioMeter", add_audio_meter_method, napi_enumerable),
+    Napi::PropertyDescriptor::Value(
+      "addMotionDetector", add_motion_detector_method, napi_enumerable
+    ),
+    Napi::PropertyDescriptor::Value("addFingerprinter", add_fingerprinter_method, napi_enumerable),
+    Napi::PropertyDescriptor::Value(
+      "addPreRecordBuffer", add_prerecord_buffer_method, napi_enumerable
+    ),
+    Napi::PropertyDescriptor::Value(
+      "addKeyframeIndexer", add_keyframe_indexer_method, napi_enumerable
+    ),
+    Napi::PropertyDescriptor::Value("setKeyframes", set_keyframes_method, napi_enumerable),
+    Napi::PropertyDescriptor::Value("clearKeyframes", clear_keyframes_method, napi_enumerable),
     Napi::PropertyDescriptor::Value("addPadProbe", add_pad_probe_method, napi_enumerable),
     Napi::PropertyDescriptor::Value("setPad", set_pad_method, napi_enumerable),
     Napi::PropertyDescriptor::Value("getPad", get_pad_method, napi_enumerable)
@@ -95,6 +226,18 @@ Element::Element(const Napi::CallbackInfo &info) :
     property_descriptors.push_back(
       Napi::PropertyDescriptor::Value("onSample", on_sample_method, napi_enumerable)
     );
+    property_descriptors.push_back(
+      Napi::PropertyDescriptor::Value("getPreroll", get_preroll_method, napi_enumerable)
+    );
+    property_descriptors.push_back(
+      Napi::PropertyDescriptor::Value("getVideoFrame", get_video_frame_method, napi_enumerable)
+    );
+    property_descriptors.push_back(
+      Napi::PropertyDescriptor::Value("getRegions", get_regions_method, napi_enumerable)
+    );
+    property_descriptors.push_back(
+      Napi::PropertyDescriptor::Value("step", step_method, napi_enumerable)
+    );
   }
 
   if (element && GST_IS_APP_SRC(element.get())) {
@@ -104,6 +247,18 @@ Element::Element(const Napi::CallbackInfo &info) :
     property_descriptors.push_back(
       Napi::PropertyDescriptor::Value("endOfStream", end_of_stream_method, napi_enumerable)
     );
+    property_descriptors.push_back(
+      Napi::PropertyDescriptor::Value("setMemorySource", set_memory_source_method, napi_enumerable)
+    );
+    property_descriptors.push_back(
+      Napi::PropertyDescriptor::Value("pumpFrom", pump_from_method, napi_enumerable)
+    );
+    property_descriptors.push_back(
+      Napi::PropertyDescriptor::Value("setAllocator", set_allocator_method, napi_enumerable)
+    );
+    property_descriptors.push_back(Napi::PropertyDescriptor::Value(
+      "getAllocatorStats", get_allocator_stats_method, napi_enumerable
+    ));
   }
 
   thisObj.DefineProperties(property_descriptors);
@@ -140,6 +295,17 @@ Napi::Value Element::get_element_property(const Napi::CallbackInfo &info) {
   return result;
 }
 
+// Error for a value that couldn't be converted to a property's type
+static std::string conversion_error(GType prop_type, const Napi::Value &property_value) {
+  if (prop_type == gst_caps_get_type() && property_value.IsString()) {
+    return "Invalid caps string";
+  } else if (G_TYPE_IS_ENUM(prop_type) && property_value.IsString()) {
+    std::string enum_str = property_value.As<Napi::String>().Utf8Value();
+    return "Invalid enum value: " + enum_str;
+  }
+  return TypeConversion::get_conversion_error_message(prop_type, property_value);
+}
+
 Napi::Value Element::set_element_property(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
   if (info.Length() < 2) {
@@ -182,17 +348,8 @@ Napi::Value Element::set_element_property(const Napi::CallbackInfo &info) {
 
   // Convert JavaScript value to GValue
   if (!TypeConversion::js_to_gvalue(env, property_value, prop_type, &value)) {
-    std::string error_msg = TypeConversion::get_conversion_error_message(prop_type, property_value);
-
-    // Handle special error cases
-    if (prop_type == gst_caps_get_type() && property_value.IsString()) {
-      error_msg = "Invalid caps string";
-    } else if (G_TYPE_IS_ENUM(prop_type) && property_value.IsString()) {
-      std::string enum_str = property_value.As<Napi::String>().Utf8Value();
-      error_msg = "Invalid enum value: " + enum_str;
-    }
-
-    Napi::TypeError::New(env, error_msg.c_str()).ThrowAsJavaScriptException();
+    Napi::TypeError::New(env, conversion_error(prop_type, property_value).c_str())
+      .ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
@@ -203,6 +360,251 @@ Napi::Value Element::set_element_property(const Napi::CallbackInfo &info) {
   return env.Undefined();
 }
 
+// Whether a property can be accessed through its param spec, skipping the lookup by name
+// g_object_get_property() and g_object_set_property() repeat on every call. Only when the
+// class and every class up to the spec's owner share one get/set implementation, so none of
+// them can have overridden the property; interface properties always go by name.
+static bool has_direct_access(GObject *object, GParamSpec *spec) {
+  if (!G_TYPE_IS_OBJECT(spec->owner_type)) {
+    return false;
+  }
+  GObjectClass *klass = G_OBJECT_GET_CLASS(object);
+  GObjectClass *owner = G_OBJECT_CLASS(g_type_class_peek(spec->owner_type));
+  return owner && klass->get_property == owner->get_property
+         && klass->set_property == owner->set_property;
+}
+
+// A property resolved once: the param spec, the way to reach it and the conversions are
+// reused on every access
+struct PropertyHandle {
+  GstElement *element;
+  GParamSpec *spec;
+  bool direct;
+  TypeConversion::GValueReader read;
+  TypeConversion::GValueWriter write;
+
+  PropertyHandle(GstElement *element, GParamSpec *spec) :
+      element(GST_ELEMENT(gst_object_ref(element))), spec(g_param_spec_ref(spec)),
+      direct(has_direct_access(G_OBJECT(element), spec)),
+      read(TypeConversion::reader_for_type(G_PARAM_SPEC_VALUE_TYPE(spec))),
+      write(TypeConversion::writer_for_type(G_PARAM_SPEC_VALUE_TYPE(spec))) {}
+
+  ~PropertyHandle() {
+    g_param_spec_unref(spec);
+    gst_object_unref(element);
+  }
+
+  Napi::Value get(const Napi::Env &env) const {
+    GObject *object = G_OBJECT(element);
+    GValue value = G_VALUE_INIT;
+    g_value_init(&value, G_PARAM_SPEC_VALUE_TYPE(spec));
+    if (direct) {
+      G_OBJECT_GET_CLASS(object)->get_property(object, spec->param_id, &value, spec);
+    } else {
+      g_object_get_property(object, spec->name, &value);
+    }
+    Napi::Value result = read(env, &value);
+    g_value_unset(&value);
+    return result;
+  }
+
+  // False when the value is out of the property's range, which leaves the property untouched
+  bool set(GValue *value) const {
+    GObject *object = G_OBJECT(element);
+    if (!direct || (spec->flags & G_PARAM_CONSTRUCT_ONLY)) {
+      // GObject reports writes to construct-only properties itself
+      g_object_set_property(object, spec->name, value);
+      return true;
+    }
+
+    // What g_object_set_property() does once it has found the spec
+    if (g_param_value_validate(spec, value) && !(spec->flags & G_PARAM_LAX_VALIDATION)) {
+      return false;
+    }
+    g_object_freeze_notify(object);
+    G_OBJECT_GET_CLASS(object)->set_property(object, spec->param_id, value, spec);
+    if ((spec->flags & (G_PARAM_EXPLICIT_NOTIFY | G_PARAM_READABLE)) == G_PARAM_READABLE) {
+      g_object_notify_by_pspec(object, spec);
+    }
+    g_object_thaw_notify(object);
+    return true;
+  }
+};
+
+Napi::Value Element::property(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "Property name must be a string").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!element.get()) {
+    Napi::TypeError::New(env, "Element is null or not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string property_name = info[0].As<Napi::String>().Utf8Value();
+  GParamSpec *spec =
+    g_object_class_find_property(G_OBJECT_GET_CLASS(element.get()), property_name.c_str());
+  if (!spec) {
+    return env.Null();
+  }
+
+  auto handle = std::make_shared<PropertyHandle>(element.get(), spec);
+
+  auto get_method = Napi::Function::New(
+    env,
+    [handle](const Napi::CallbackInfo &info) -> Napi::Value {
+      if (!(handle->spec->flags & G_PARAM_READABLE)) {
+        Napi::TypeError::New(info.Env(), "Property is not readable").ThrowAsJavaScriptException();
+        return info.Env().Undefined();
+      }
+      return handle->get(info.Env());
+    },
+    "get"
+  );
+  auto set_method = Napi::Function::New(
+    env,
+    [handle](const Napi::CallbackInfo &info) -> Napi::Value {
+      Napi::Env env = info.Env();
+      if (!(handle->spec->flags & G_PARAM_WRITABLE)) {
+        Napi::TypeError::New(env, "Property is not writable").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      GType prop_type = G_PARAM_SPEC_VALUE_TYPE(handle->spec);
+      Napi::Value property_value = info.Length() > 0 ? info[0] : env.Undefined();
+      GValue value = G_VALUE_INIT;
+      if (!handle->write(env, property_value, prop_type, &value)) {
+        Napi::TypeError::New(env, conversion_error(prop_type, property_value).c_str())
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      bool in_range = handle->set(&value);
+      g_value_unset(&value);
+      if (!in_range) {
+        Napi::TypeError::New(env, "Value is out of range for the property")
+          .ThrowAsJavaScriptException();
+      }
+      return env.Undefined();
+    },
+    "set"
+  );
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("name", Napi::String::New(env, handle->spec->name));
+  result.Set("type", Napi::String::New(env, g_type_name(G_PARAM_SPEC_VALUE_TYPE(spec))));
+  result.Set("readable", Napi::Boolean::New(env, (spec->flags & G_PARAM_READABLE) != 0));
+  result.Set("writable", Napi::Boolean::New(env, (spec->flags & G_PARAM_WRITABLE) != 0));
+  result.Set("get", get_method);
+  result.Set("set", set_method);
+
+  return result;
+}
+
+Napi::Value Element::get_properties(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "getProperties() requires an array of property names")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!element.get()) {
+    Napi::TypeError::New(env, "Element is null or not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Array names = info[0].As<Napi::Array>();
+  GObjectClass *klass = G_OBJECT_GET_CLASS(element.get());
+  Napi::Object result = Napi::Object::New(env);
+
+  for (uint32_t i = 0; i < names.Length(); i++) {
+    Napi::Value name_value = names.Get(i);
+    if (!name_value.IsString()) {
+      Napi::TypeError::New(env, "Property name must be a string").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    std::string property_name = name_value.As<Napi::String>().Utf8Value();
+    GParamSpec *spec = g_object_class_find_property(klass, property_name.c_str());
+    if (!spec || !(spec->flags & G_PARAM_READABLE)) {
+      result.Set(property_name, env.Null());
+      continue;
+    }
+
+    // The same access and conversion a property handle caches
+    result.Set(property_name, PropertyHandle(element.get(), spec).get(env));
+
+    if (env.IsExceptionPending()) {
+      return env.Undefined();
+    }
+  }
+
+  return result;
+}
+
+Napi::Value Element::set_properties(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+  if (info.Length() < 1 || !info[0].IsObject()) {
+    Napi::TypeError::New(env, "setProperties() requires an object of property values")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!element.get()) {
+    Napi::TypeError::New(env, "Element is null or not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Object values = info[0].As<Napi::Object>();
+  Napi::Array names = values.GetPropertyNames();
+  GObjectClass *klass = G_OBJECT_GET_CLASS(element.get());
+
+  // Convert everything first so an invalid value leaves the element untouched
+  std::vector<std::string> property_names;
+  std::vector<GValue> converted(names.Length(), G_VALUE_INIT);
+  std::string error;
+
+  for (uint32_t i = 0; i < names.Length() && error.empty(); i++) {
+    std::string property_name = names.Get(i).As<Napi::String>().Utf8Value();
+    Napi::Value property_value = values.Get(property_name);
+    GParamSpec *spec = g_object_class_find_property(klass, property_name.c_str());
+
+    if (!spec) {
+      error = "Property '" + property_name + "' not found";
+    } else if (!(spec->flags & G_PARAM_WRITABLE)) {
+      error = "Property '" + property_name + "' is not writable";
+    } else {
+      GType prop_type = G_PARAM_SPEC_VALUE_TYPE(spec);
+      if (TypeConversion::js_to_gvalue(env, property_value, prop_type, &converted[i])) {
+        property_names.push_back(spec->name);
+      } else {
+        error = "Property '" + property_name + "': " + conversion_error(prop_type, property_value);
+      }
+    }
+  }
+
+  if (error.empty()) {
+    // Listeners see a single batch of notifications once everything is set
+    g_object_freeze_notify(G_OBJECT(element.get()));
+    for (size_t i = 0; i < property_names.size(); i++) {
+      g_object_set_property(G_OBJECT(element.get()), property_names[i].c_str(), &converted[i]);
+    }
+    g_object_thaw_notify(G_OBJECT(element.get()));
+  }
+
+  for (size_t i = 0; i < property_names.size(); i++) {
+    g_value_unset(&converted[i]);
+  }
+
+  if (!error.empty()) {
+    Napi::TypeError::New(env, error.c_str()).ThrowAsJavaScriptException();
+  }
+  return env.Undefined();
+}
+
 Napi::Value Element::get_sample(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
@@ -231,94 +633,321 @@ Napi::Value Element::get_sample(const Napi::CallbackInfo &info) {
   return promise;
 }
 
-// Structure to hold sample callback data
-struct SampleCallbackContext {
-  Napi::ThreadSafeFunction callback;
-  gulong signal_id;
-  GstAppSink *app_sink;
-};
+Napi::Value Element::get_preroll(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  // Validate that we have an app sink element
+  if (!element || !GST_IS_APP_SINK(element.get())) {
+    Napi::TypeError::New(env, "getPreroll() can only be called on app-sink-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Default timeout is 1000ms (1 second)
+  guint64 timeout_ms = 1000;
+
+  // Check if timeout parameter is provided
+  if (info.Length() > 0 && info[0].IsNumber()) {
+    timeout_ms = info[0].As<Napi::Number>().Uint32Value();
+  }
 
-// Signal callback for new-sample
-static void new_sample_callback(GstAppSink *app_sink, gpointer user_data) {
-  SampleCallbackContext *context = static_cast<SampleCallbackContext *>(user_data);
+  PullSampleWorker *worker =
+    new PullSampleWorker(env, GST_APP_SINK(element.get()), timeout_ms, true);
+  Napi::Promise promise = worker->GetPromise().Promise();
+  worker->Queue();
 
-  // Try to pull the sample
-  GstSample *sample = gst_app_sink_try_pull_sample(app_sink, 0); // Non-blocking
+  return promise;
+}
 
-  if (sample) {
-    // Call the JavaScript callback with the sample
-    context->callback.NonBlockingCall([=](Napi::Env env, Napi::Function js_callback) {
-      Napi::Object sampleData = TypeConversion::gst_sample_to_js(env, sample);
-      js_callback.Call({sampleData});
+Napi::Value Element::get_video_frame(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
 
-      // Unref the sample when done
-      gst_sample_unref(sample);
-    });
+  if (!element || !GST_IS_APP_SINK(element.get())) {
+    Napi::TypeError::New(env, "getVideoFrame() can only be called on app-sink-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  guint64 timeout_ms = 1000;
+  if (info.Length() > 0 && info[0].IsNumber()) {
+    timeout_ms = info[0].As<Napi::Number>().Uint32Value();
   }
+
+  PullSampleWorker *worker =
+    new PullSampleWorker(env, GST_APP_SINK(element.get()), timeout_ms, false, true);
+  Napi::Promise promise = worker->GetPromise().Promise();
+  worker->Queue();
+
+  return promise;
 }
 
-Napi::Value Element::on_sample(const Napi::CallbackInfo &info) {
+Napi::Value Element::get_regions(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  // Validate that we have an app sink element
   if (!element || !GST_IS_APP_SINK(element.get())) {
-    Napi::TypeError::New(env, "onSample() can only be called on app-sink-element")
+    Napi::TypeError::New(env, "getRegions() can only be called on app-sink-element")
       .ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
-  if (info.Length() < 1 || !info[0].IsFunction()) {
-    Napi::TypeError::New(env, "Expected 1 argument: callback function")
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "getRegions() requires an array of rectangles")
       .ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
-  Napi::Function callback = info[0].As<Napi::Function>();
+  // Regions starting past the negotiated frame are rejected right away, the worker checks the
+  // full extent against the frame it actually pulls
+  GstVideoInfo negotiated;
+  bool has_size = false;
+  GstPad *sink_pad = gst_element_get_static_pad(element.get(), "sink");
+  if (sink_pad) {
+    GstCaps *caps = gst_pad_get_current_caps(sink_pad);
+    if (caps) {
+      has_size = gst_video_info_from_caps(&negotiated, caps);
+      gst_caps_unref(caps);
+    }
+    gst_object_unref(sink_pad);
+  }
 
-  // Enable signal emission on the appsink
-  g_object_set(element.get(), "emit-signals", TRUE, NULL);
+  std::vector<PullRegionsWorker::Rect> rects;
+  Napi::Array js_rects = info[0].As<Napi::Array>();
+  for (uint32_t i = 0; i < js_rects.Length(); i++) {
+    Napi::Value value = js_rects.Get(i);
+    Napi::Object rect = value.IsObject() ? value.As<Napi::Object>() : Napi::Object::New(env);
+    if (!rect.Get("x").IsNumber() || !rect.Get("y").IsNumber() || !rect.Get("width").IsNumber()
+        || !rect.Get("height").IsNumber()) {
+      Napi::TypeError::New(env, "Each region needs numeric x, y, width and height")
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
 
-  // Create a thread-safe function for the callback
-  Napi::ThreadSafeFunction tsfn =
-    Napi::ThreadSafeFunction::New(env, callback, "SampleCallback", 0, 1);
+    PullRegionsWorker::Rect parsed = {
+      rect.Get("x").As<Napi::Number>().Int32Value(),
+      rect.Get("y").As<Napi::Number>().Int32Value(),
+      rect.Get("width").As<Napi::Number>().Int32Value(),
+      rect.Get("height").As<Napi::Number>().Int32Value()
+    };
+    if (parsed.x < 0 || parsed.y < 0 || parsed.width < 1 || parsed.height < 1) {
+      Napi::TypeError::New(env, "Regions need x, y >= 0 and width, height >= 1")
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    if (has_size
+        && (parsed.x >= GST_VIDEO_INFO_WIDTH(&negotiated)
+            || parsed.y >= GST_VIDEO_INFO_HEIGHT(&negotiated))) {
+      Napi::TypeError::New(
+        env, "Region " + std::to_string(i) + " starts outside the "
+               + std::to_string(GST_VIDEO_INFO_WIDTH(&negotiated)) + "x"
+               + std::to_string(GST_VIDEO_INFO_HEIGHT(&negotiated)) + " frame"
+      )
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    rects.push_back(parsed);
+  }
 
-  // Create context for the signal
-  SampleCallbackContext *context = new SampleCallbackContext{tsfn, 0, GST_APP_SINK(element.get())};
+  guint64 timeout_ms = 1000;
+  GstVideoFormat format = GST_VIDEO_FORMAT_UNKNOWN;
+  double scale = 1.0;
 
-  // Connect to the "new-sample" signal
-  context->signal_id =
-    g_signal_connect(element.get(), "new-sample", G_CALLBACK(new_sample_callback), context);
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
 
-  // Return an unsubscribe function
-  return Napi::Function::New(env, [context](const Napi::CallbackInfo &info) -> Napi::Value {
-    // Disconnect the signal (this will stop the callbacks)
-    g_signal_handler_disconnect(context->app_sink, context->signal_id);
+    if (options.Get("timeoutMs").IsNumber()) {
+      timeout_ms = options.Get("timeoutMs").As<Napi::Number>().Uint32Value();
+    }
+    if (options.Get("format").IsString()) {
+      std::string format_name = options.Get("format").As<Napi::String>().Utf8Value();
+      format = gst_video_format_from_string(format_name.c_str());
+      if (format == GST_VIDEO_FORMAT_UNKNOWN) {
+        Napi::TypeError::New(env, "Unknown video format: " + format_name)
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+    if (options.Get("scale").IsNumber()) {
+      scale = options.Get("scale").As<Napi::Number>().DoubleValue();
+      if (!(scale > 0 && scale <= 1)) {
+        Napi::TypeError::New(env, "scale must be > 0 and <= 1").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+  }
 
-    // Clean up the thread-safe function
-    context->callback.Release();
-    delete context;
+  PullRegionsWorker *worker = new PullRegionsWorker(
+    env, GST_APP_SINK(element.get()), timeout_ms, std::move(rects), format, scale
+  );
+  Napi::Promise promise = worker->GetPromise().Promise();
+  worker->Queue();
 
-    return info.Env().Undefined();
-  });
+  return promise;
 }
 
-// Structure to hold probe data
-struct PadProbeContext {
-  Napi::ThreadSafeFunction callback;
-  gulong probe_id;
-  GstPad *pad;
-  GstElement *element;
-};
+Napi::Value Element::step(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
 
-// Pad probe callback for comprehensive buffer data extraction
-static GstPadProbeReturn
-pad_probe_callback(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
-  PadProbeContext *context = static_cast<PadProbeContext *>(user_data);
+  // Validate that we have an app sink element
+  if (!element || !GST_IS_APP_SINK(element.get())) {
+    Napi::TypeError::New(env, "step() can only be called on app-sink-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
 
-  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
-    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+  if (info.Length() < 1 || !info[0].IsNumber()) {
+    Napi::TypeError::New(env, "step() requires a number argument (frames or seconds)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
 
-    if (buffer) {
+  double amount = info[0].As<Napi::Number>().DoubleValue();
+  if (!(amount > 0) || !std::isfinite(amount)) {
+    Napi::TypeError::New(env, "Step amount must be > 0").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  GstFormat format = GST_FORMAT_BUFFERS;
+  gdouble rate = 1.0;
+  guint64 timeout_ms = 1000;
+
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+
+    if (options.Has("format")) {
+      std::string format_str = options.Get("format").ToString().Utf8Value();
+      if (format_str == "buffers") {
+        format = GST_FORMAT_BUFFERS;
+      } else if (format_str == "time") {
+        format = GST_FORMAT_TIME;
+      } else {
+        Napi::TypeError::New(env, "Step format must be 'buffers' or 'time'")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+    if (options.Get("rate").IsNumber()) {
+      rate = options.Get("rate").As<Napi::Number>().DoubleValue();
+      if (rate <= 0) {
+        Napi::TypeError::New(env, "Step rate must be > 0").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+    if (options.Get("timeoutMs").IsNumber()) {
+      timeout_ms = options.Get("timeoutMs").As<Napi::Number>().Uint32Value();
+    }
+  }
+
+  // Frames are stepped as whole buffers, durations are given in seconds like seek()
+  if (format == GST_FORMAT_BUFFERS && std::floor(amount) != amount) {
+    Napi::TypeError::New(env, "Step amount must be a whole number of buffers")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  guint64 step_amount = format == GST_FORMAT_TIME ? static_cast<guint64>(amount * GST_SECOND)
+                                                  : static_cast<guint64>(amount);
+  if (step_amount == 0) {
+    Napi::TypeError::New(env, "Step amount must be at least one nanosecond")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  StepWorker *worker =
+    new StepWorker(env, GST_APP_SINK(element.get()), format, step_amount, rate, timeout_ms);
+  Napi::Promise promise = worker->GetPromise().Promise();
+  worker->Queue();
+
+  return promise;
+}
+
+Napi::Value Element::on_sample(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  // Validate that we have an app sink element
+  if (!element || !GST_IS_APP_SINK(element.get())) {
+    Napi::TypeError::New(env, "onSample() can only be called on app-sink-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "Expected 1 argument: callback function")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Function callback = info[0].As<Napi::Function>();
+
+  SampleSubscriptionOptions options;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object js_options = info[1].As<Napi::Object>();
+    if (js_options.Get("maxFps").IsNumber()) {
+      options.max_fps = js_options.Get("maxFps").As<Napi::Number>().DoubleValue();
+      if (!(options.max_fps > 0)) {
+        Napi::TypeError::New(env, "maxFps must be a positive number")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+    if (js_options.Get("maxPending").IsNumber()) {
+      double max_pending = js_options.Get("maxPending").As<Napi::Number>().DoubleValue();
+      if (max_pending < 1) {
+        Napi::TypeError::New(env, "maxPending must be a positive number of samples")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      options.max_pending = static_cast<size_t>(max_pending);
+    }
+    Napi::Value drop = js_options.Get("drop");
+    if (!drop.IsUndefined()) {
+      std::string policy = drop.IsString() ? drop.As<Napi::String>().Utf8Value() : "";
+      if (policy != "newest" && policy != "oldest") {
+        Napi::TypeError::New(env, "drop must be \"newest\" or \"oldest\"")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      options.drop_oldest = policy == "oldest";
+    }
+    if (js_options.Get("latestOnly").IsBoolean()) {
+      options.latest_only = js_options.Get("latestOnly").As<Napi::Boolean>().Value();
+    }
+  }
+
+  // One dispatcher per sink pulls each sample once for all subscribers
+  std::shared_ptr<SampleDispatcher> dispatcher =
+    SampleDispatcher::for_app_sink(GST_APP_SINK(element.get()));
+  guint64 id = dispatcher->subscribe(env, callback, options);
+
+  // The sink must outlive the subscription so unsubscribing can disconnect from it
+  std::shared_ptr<GstElement> sink(
+    GST_ELEMENT(gst_object_ref(element.get())), [](GstElement *sink) { gst_object_unref(sink); }
+  );
+
+  // Return an unsubscribe function
+  return Napi::Function::New(
+    env, [dispatcher, sink, id](const Napi::CallbackInfo &info) -> Napi::Value {
+      dispatcher->unsubscribe(id);
+      return info.Env().Undefined();
+    }
+  );
+}
+
+// Structure to hold probe data
+struct PadProbeContext {
+  Napi::ThreadSafeFunction callback;
+  gulong probe_id;
+  GstPad *pad;
+  GstElement *element;
+};
+
+// Pad probe callback for comprehensive buffer data extraction
+static GstPadProbeReturn
+pad_probe_callback(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+  PadProbeContext *context = static_cast<PadProbeContext *>(user_data);
+
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+
+    if (buffer) {
       // Copy buffer data immediately to avoid lifetime issues
       GstMapInfo map;
       uint8_t *buffer_data_copy = nullptr;
@@ -482,129 +1111,1442 @@ Napi::Value Element::add_pad_probe(const Napi::CallbackInfo &info) {
   });
 }
 
-Napi::Value Element::push(const Napi::CallbackInfo &info) {
+// Shared by the meter probe and the unsubscribe function
+struct AudioMeterContext {
+  Napi::ThreadSafeFunction callback;
+  AudioMeter meter;
+  GstPad *pad;
+  gulong probe_id = 0;
+
+  AudioMeterContext(Napi::ThreadSafeFunction callback, double interval_seconds, GstPad *pad) :
+      callback(callback), meter(interval_seconds), pad(pad) {}
+  ~AudioMeterContext() {
+    callback.Release();
+    gst_object_unref(pad);
+  }
+};
+
+static void deliver_audio_levels(AudioMeterContext *context) {
+  AudioLevels *levels = new AudioLevels(context->meter.take());
+  napi_status status = context->callback.NonBlockingCall(
+    levels,
+    [](Napi::Env env, Napi::Function js_callback, AudioLevels *levels) {
+      auto to_array = [&env](const std::vector<double> &values) {
+        Napi::Float64Array array = Napi::Float64Array::New(env, values.size());
+        for (size_t i = 0; i < values.size(); i++) {
+          array[i] = values[i];
+        }
+        return array;
+      };
+
+      Napi::Object result = Napi::Object::New(env);
+      if (levels->pts != GST_CLOCK_TIME_NONE) {
+        result.Set("pts", Napi::Number::New(env, static_cast<double>(levels->pts)));
+      }
+      result.Set("duration", Napi::Number::New(env, levels->duration));
+      result.Set("peak", to_array(levels->peak));
+      result.Set("rms", to_array(levels->rms));
+      result.Set("truePeak", to_array(levels->true_peak));
+      result.Set(
+        "momentary",
+        levels->momentary ? Napi::Number::New(env, *levels->momentary) : env.Null()
+      );
+      result.Set(
+        "shortTerm",
+        levels->short_term ? Napi::Number::New(env, *levels->short_term) : env.Null()
+      );
+
+      delete levels;
+      js_callback.Call({result});
+    }
+  );
+  if (status != napi_ok) {
+    delete levels;
+  }
+}
+
+static GstPadProbeReturn
+audio_meter_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+  AudioMeterContext *context = static_cast<std::shared_ptr<AudioMeterContext> *>(user_data)->get();
+
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    if (context->meter.process(GST_PAD_PROBE_INFO_BUFFER(info))) {
+      deliver_audio_levels(context);
+    }
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+    GstCaps *caps;
+    gst_event_parse_caps(event, &caps);
+    if (!context->meter.configure(caps)) {
+      GST_WARNING_OBJECT(pad, "Audio meter needs interleaved S16, S32 or F32 audio");
+    }
+  } else if (GST_EVENT_TYPE(event) == GST_EVENT_FLUSH_STOP) {
+    context->meter.reset();
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+Napi::Value Element::add_audio_meter(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  // Validate that we have an app source element
-  if (!element || !GST_IS_APP_SRC(element.get())) {
-    Napi::TypeError::New(env, "push() can only be called on app-src-element")
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "addAudioMeter() requires a pad name and a callback function")
       .ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
-  if (info.Length() < 1) {
-    Napi::TypeError::New(env, "push() requires at least 1 argument: buffer")
-      .ThrowAsJavaScriptException();
+  double interval_ms = 100;
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+    if (options.Get("intervalMs").IsNumber()) {
+      interval_ms = options.Get("intervalMs").As<Napi::Number>().DoubleValue();
+    }
+  }
+  if (interval_ms < 1) {
+    Napi::TypeError::New(env, "intervalMs must be >= 1").ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
-  if (!info[0].IsBuffer()) {
-    Napi::TypeError::New(env, "First argument must be a Buffer").ThrowAsJavaScriptException();
+  std::string pad_name = info[0].As<Napi::String>().Utf8Value();
+  GstPad *pad = gst_element_get_static_pad(element.get(), pad_name.c_str());
+  if (!pad) {
+    Napi::Error::New(env, "Failed to get pad: " + pad_name).ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
-  // Get buffer data from Node.js Buffer
-  Napi::Buffer<uint8_t> node_buffer = info[0].As<Napi::Buffer<uint8_t>>();
-  uint8_t *buffer_data = node_buffer.Data();
-  size_t buffer_length = node_buffer.Length();
+  Napi::ThreadSafeFunction tsfn =
+    Napi::ThreadSafeFunction::New(env, info[1].As<Napi::Function>(), "AudioMeterCallback", 0, 1);
+  auto context = std::make_shared<AudioMeterContext>(tsfn, interval_ms / 1000.0, pad);
 
-  // Create GStreamer buffer
-  GstBuffer *gst_buffer = gst_buffer_new_allocate(nullptr, buffer_length, nullptr);
-  if (!gst_buffer) {
-    Napi::Error::New(env, "Failed to allocate GStreamer buffer").ThrowAsJavaScriptException();
-    return env.Undefined();
+  // Pick up caps negotiated before the meter was attached, later changes arrive as events
+  GstCaps *caps = gst_pad_get_current_caps(pad);
+  if (caps) {
+    context->meter.configure(caps);
+    gst_caps_unref(caps);
   }
 
-  // Fill the buffer with data
-  gst_buffer_fill(gst_buffer, 0, buffer_data, buffer_length);
+  context->probe_id = gst_pad_add_probe(
+    pad,
+    static_cast<GstPadProbeType>(
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM
+      | GST_PAD_PROBE_TYPE_EVENT_FLUSH
+    ),
+    audio_meter_probe, new std::shared_ptr<AudioMeterContext>(context),
+    [](gpointer data) { delete static_cast<std::shared_ptr<AudioMeterContext> *>(data); }
+  );
 
-  // Handle optional PTS (presentation timestamp) parameter
-  if (info.Length() > 1) {
-    if (info[1].IsBuffer()) {
-      // Handle PTS as buffer (compatible with original NAN implementation)
-      Napi::Buffer<uint8_t> pts_buffer = info[1].As<Napi::Buffer<uint8_t>>();
-      if (pts_buffer.Length() >= 8) {
-        uint8_t *pts_data = pts_buffer.Data();
-        // Read as big-endian uint64
-        guint64 pts = GST_READ_UINT64_BE(pts_data);
-        GST_BUFFER_PTS(gst_buffer) = pts;
-      }
-    } else if (info[1].IsNumber()) {
-      // Handle PTS as number (more convenient JavaScript API)
-      guint64 pts = static_cast<guint64>(info[1].As<Napi::Number>().Int64Value());
-      GST_BUFFER_PTS(gst_buffer) = pts;
+  return Napi::Function::New(env, [context](const Napi::CallbackInfo &info) -> Napi::Value {
+    if (context->probe_id != 0) {
+      gst_pad_remove_probe(context->pad, context->probe_id);
+      context->probe_id = 0;
     }
+    return info.Env().Undefined();
+  });
+}
+
+// Shared by the detector probe and the unsubscribe function
+struct MotionDetectorContext {
+  Napi::ThreadSafeFunction callback;
+  MotionDetector detector;
+  GstPad *pad;
+  gulong probe_id = 0;
+
+  MotionDetectorContext(
+    Napi::ThreadSafeFunction callback, const MotionOptions &options, GstPad *pad
+  ) :
+      callback(callback), detector(options), pad(pad) {}
+  ~MotionDetectorContext() {
+    callback.Release();
+    gst_object_unref(pad);
   }
+};
 
-  // Push buffer to app source
-  GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(element.get()), gst_buffer);
+static const char *motion_event_type(MotionEvent::Type type) {
+  switch (type) {
+    case MotionEvent::MOTION_START:
+      return "motion-start";
+    case MotionEvent::MOTION_END:
+      return "motion-end";
+    case MotionEvent::SCENE_CHANGE:
+      return "scene-change";
+  }
+  return "unknown";
+}
 
-  // Check for errors
-  if (ret != GST_FLOW_OK) {
-    // Buffer is consumed by push_buffer even on error, so don't unref it
-    std::string error_msg = "Failed to push buffer: ";
-    switch (ret) {
-      case GST_FLOW_FLUSHING:
-        error_msg += "Element is flushing";
-        break;
-      case GST_FLOW_EOS:
-        error_msg += "End of stream";
-        break;
-      case GST_FLOW_NOT_LINKED:
-        error_msg += "Source pad not linked";
-        break;
-      case GST_FLOW_ERROR:
-        error_msg += "Generic error";
-        break;
-      default:
-        error_msg += "Unknown error (" + std::to_string(ret) + ")";
-        break;
+static GstPadProbeReturn
+motion_detector_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+  MotionDetectorContext *context =
+    static_cast<std::shared_ptr<MotionDetectorContext> *>(user_data)->get();
+
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    // Frames only cross into JavaScript as events, and only when a threshold is crossed
+    for (MotionEvent &event : context->detector.process(GST_PAD_PROBE_INFO_BUFFER(info))) {
+      MotionEvent *data = new MotionEvent(std::move(event));
+      napi_status status = context->callback.NonBlockingCall(
+        data,
+        [](Napi::Env env, Napi::Function js_callback, MotionEvent *event) {
+          Napi::Object result = Napi::Object::New(env);
+          result.Set("type", Napi::String::New(env, motion_event_type(event->type)));
+          if (event->pts != GST_CLOCK_TIME_NONE) {
+            result.Set("pts", Napi::Number::New(env, static_cast<double>(event->pts)));
+          }
+          result.Set("score", Napi::Number::New(env, event->score));
+          result.Set("difference", Napi::Number::New(env, event->difference));
+          if (event->type == MotionEvent::MOTION_START) {
+            result.Set(
+              "mask", Napi::Buffer<uint8_t>::Copy(env, event->mask.data(), event->mask.size())
+            );
+            result.Set("columns", Napi::Number::New(env, static_cast<double>(event->columns)));
+            result.Set("rows", Napi::Number::New(env, static_cast<double>(event->rows)));
+          }
+
+          delete event;
+          js_callback.Call({result});
+        }
+      );
+      if (status != napi_ok) {
+        delete data;
+      }
     }
-    Napi::Error::New(env, error_msg).ThrowAsJavaScriptException();
-    return env.Undefined();
+    return GST_PAD_PROBE_OK;
   }
 
-  return env.Undefined();
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+    GstCaps *caps;
+    gst_event_parse_caps(event, &caps);
+    if (!context->detector.configure(caps)) {
+      GST_WARNING_OBJECT(pad, "Motion detector needs 8-bit planar YUV, GRAY8 or RGBx video");
+    }
+  } else if (GST_EVENT_TYPE(event) == GST_EVENT_FLUSH_STOP) {
+    context->detector.reset();
+  }
+  return GST_PAD_PROBE_OK;
 }
 
-Napi::Value Element::end_of_stream(const Napi::CallbackInfo &info) {
+Napi::Value Element::add_motion_detector(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
-  // Validate that we have an app source element
-  if (!element || !GST_IS_APP_SRC(element.get())) {
-    Napi::TypeError::New(env, "endOfStream() can only be called on app-src-element")
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "addMotionDetector() requires a pad name and a callback function")
       .ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
-  // Send end-of-stream signal to app source
-  GstFlowReturn ret = gst_app_src_end_of_stream(GST_APP_SRC(element.get()));
-
-  // Check for errors
-  if (ret != GST_FLOW_OK) {
-    std::string error_msg = "Failed to send end-of-stream: ";
-    switch (ret) {
-      case GST_FLOW_FLUSHING:
-        error_msg += "Element is flushing";
-        break;
-      case GST_FLOW_EOS:
-        error_msg += "Already at end of stream";
-        break;
-      case GST_FLOW_NOT_LINKED:
-        error_msg += "Source pad not linked";
-        break;
-      case GST_FLOW_ERROR:
-        error_msg += "Generic error";
-        break;
-      default:
-        error_msg += "Unknown error (" + std::to_string(ret) + ")";
-        break;
+  MotionOptions options;
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Object options_obj = info[2].As<Napi::Object>();
+    auto read = [&options_obj](const char *key, double fallback) {
+      Napi::Value value = options_obj.Get(key);
+      return value.IsNumber() ? value.As<Napi::Number>().DoubleValue() : fallback;
+    };
+
+    double analysis_width = read("analysisWidth", static_cast<double>(options.analysis_width));
+    double block_size = read("blockSize", static_cast<double>(options.block_size));
+    options.pixel_threshold = read("pixelThreshold", options.pixel_threshold);
+    options.motion_threshold = read("motionThreshold", options.motion_threshold);
+    options.scene_threshold = read("sceneThreshold", options.scene_threshold);
+    double hold_ms = read("holdMs", static_cast<double>(options.hold / GST_MSECOND));
+
+    if (analysis_width < 16 || block_size < 1 || hold_ms < 0) {
+      Napi::TypeError::New(env, "analysisWidth must be >= 16, blockSize >= 1 and holdMs >= 0")
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
     }
-    Napi::Error::New(env, error_msg).ThrowAsJavaScriptException();
+    if (options.pixel_threshold < 0 || options.pixel_threshold > 1
+        || options.motion_threshold < 0 || options.motion_threshold > 1
+        || options.scene_threshold < 0 || options.scene_threshold > 1) {
+      Napi::TypeError::New(env, "Thresholds must be between 0 and 1").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    options.analysis_width = static_cast<size_t>(analysis_width);
+    options.block_size = static_cast<size_t>(block_size);
+    options.hold = static_cast<GstClockTime>(hold_ms * GST_MSECOND);
+  }
+
+  std::string pad_name = info[0].As<Napi::String>().Utf8Value();
+  GstPad *pad = gst_element_get_static_pad(element.get(), pad_name.c_str());
+  if (!pad) {
+    Napi::Error::New(env, "Failed to get pad: " + pad_name).ThrowAsJavaScriptException();
     return env.Undefined();
   }
 
-  return env.Undefined();
+  Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+    env, info[1].As<Napi::Function>(), "MotionDetectorCallback", 0, 1
+  );
+  auto context = std::make_shared<MotionDetectorContext>(tsfn, options, pad);
+
+  GstCaps *caps = gst_pad_get_current_caps(pad);
+  if (caps) {
+    context->detector.configure(caps);
+    gst_caps_unref(caps);
+  }
+
+  context->probe_id = gst_pad_add_probe(
+    pad,
+    static_cast<GstPadProbeType>(
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM
+      | GST_PAD_PROBE_TYPE_EVENT_FLUSH
+    ),
+    motion_detector_probe, new std::shared_ptr<MotionDetectorContext>(context),
+    [](gpointer data) { delete static_cast<std::shared_ptr<MotionDetectorContext> *>(data); }
+  );
+
+  return Napi::Function::New(env, [context](const Napi::CallbackInfo &info) -> Napi::Value {
+    if (context->probe_id != 0) {
+      gst_pad_remove_probe(context->pad, context->probe_id);
+      context->probe_id = 0;
+    }
+    return info.Env().Undefined();
+  });
+}
+
+// Hashes collected on the streaming thread until the batch is full or the stream ends
+struct FingerprintBatch {
+  std::vector<uint64_t> hashes;
+  std::vector<double> pts;
+};
+
+// Shared by the fingerprint probe and the unsubscribe function, which both hand out the batch
+struct FingerprintContext {
+  Napi::ThreadSafeFunction callback;
+  Fingerprinter fingerprinter;
+  size_t batch_size;
+  std::mutex mutex;
+  FingerprintBatch batch;
+  bool stopped = false;
+  GstPad *pad;
+  gulong probe_id = 0;
+
+  FingerprintContext(
+    Napi::ThreadSafeFunction callback, FingerprintAlgorithm algorithm, size_t batch_size,
+    GstPad *pad
+  ) :
+      callback(callback), fingerprinter(algorithm), batch_size(batch_size), pad(pad) {}
+  ~FingerprintContext() {
+    callback.Release();
+    gst_object_unref(pad);
+  }
+};
+
+// Called with the context's mutex held
+static void deliver_fingerprints(FingerprintContext *context) {
+  if (context->batch.hashes.empty()) {
+    return;
+  }
+
+  FingerprintBatch *batch = new FingerprintBatch(std::move(context->batch));
+  context->batch = FingerprintBatch();
+  context->batch.hashes.reserve(context->batch_size);
+  context->batch.pts.reserve(context->batch_size);
+
+  napi_status status = context->callback.NonBlockingCall(
+    batch,
+    [](Napi::Env env, Napi::Function js_callback, FingerprintBatch *batch) {
+      size_t count = batch->hashes.size();
+      Napi::BigUint64Array hashes = Napi::BigUint64Array::New(env, count);
+      Napi::Float64Array pts = Napi::Float64Array::New(env, count);
+      std::memcpy(hashes.Data(), batch->hashes.data(), count * sizeof(uint64_t));
+      std::memcpy(pts.Data(), batch->pts.data(), count * sizeof(double));
+
+      Napi::Object result = Napi::Object::New(env);
+      result.Set("hashes", hashes);
+      result.Set("pts", pts);
+
+      delete batch;
+      js_callback.Call({result});
+    }
+  );
+  if (status != napi_ok) {
+    delete batch;
+  }
+}
+
+static GstPadProbeReturn
+fingerprint_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+  FingerprintContext *context =
+    static_cast<std::shared_ptr<FingerprintContext> *>(user_data)->get();
+
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    GstBuffer *buffer = GST_PAD_PROBE_INFO_BUFFER(info);
+    uint64_t hash;
+    if (context->fingerprinter.hash(buffer, hash)) {
+      std::lock_guard<std::mutex> lock(context->mutex);
+      if (context->stopped) {
+        return GST_PAD_PROBE_OK;
+      }
+      context->batch.hashes.push_back(hash);
+      context->batch.pts.push_back(
+        GST_BUFFER_PTS_IS_VALID(buffer) ? static_cast<double>(GST_BUFFER_PTS(buffer)) : -1
+      );
+      if (context->batch.hashes.size() >= context->batch_size) {
+        deliver_fingerprints(context);
+      }
+    }
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+    GstCaps *caps;
+    gst_event_parse_caps(event, &caps);
+    if (!context->fingerprinter.configure(caps)) {
+      GST_WARNING_OBJECT(pad, "Fingerprints need 8-bit planar YUV, GRAY8 or RGBx video");
+    }
+  } else if (GST_EVENT_TYPE(event) == GST_EVENT_EOS) {
+    // Hand out the partial batch, nothing else will fill it
+    std::lock_guard<std::mutex> lock(context->mutex);
+    deliver_fingerprints(context);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+Napi::Value Element::add_fingerprinter(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "addFingerprinter() requires a pad name and a callback function")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  FingerprintAlgorithm algorithm = FingerprintAlgorithm::PHASH;
+  double batch_size = 30;
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Object options = info[2].As<Napi::Object>();
+    if (options.Get("algorithm").IsString()) {
+      std::string name = options.Get("algorithm").As<Napi::String>().Utf8Value();
+      if (name == "dhash") {
+        algorithm = FingerprintAlgorithm::DHASH;
+      } else if (name != "phash") {
+        Napi::TypeError::New(env, "algorithm must be 'phash' or 'dhash'")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+    if (options.Get("batchSize").IsNumber()) {
+      batch_size = options.Get("batchSize").As<Napi::Number>().DoubleValue();
+    }
+  }
+  if (batch_size < 1) {
+    Napi::TypeError::New(env, "batchSize must be >= 1").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string pad_name = info[0].As<Napi::String>().Utf8Value();
+  GstPad *pad = gst_element_get_static_pad(element.get(), pad_name.c_str());
+  if (!pad) {
+    Napi::Error::New(env, "Failed to get pad: " + pad_name).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::ThreadSafeFunction tsfn =
+    Napi::ThreadSafeFunction::New(env, info[1].As<Napi::Function>(), "FingerprintCallback", 0, 1);
+  auto context = std::make_shared<FingerprintContext>(
+    tsfn, algorithm, static_cast<size_t>(batch_size), pad
+  );
+
+  GstCaps *caps = gst_pad_get_current_caps(pad);
+  if (caps) {
+    context->fingerprinter.configure(caps);
+    gst_caps_unref(caps);
+  }
+
+  context->probe_id = gst_pad_add_probe(
+    pad,
+    static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM),
+    fingerprint_probe, new std::shared_ptr<FingerprintContext>(context),
+    [](gpointer data) { delete static_cast<std::shared_ptr<FingerprintContext> *>(data); }
+  );
+
+  return Napi::Function::New(env, [context](const Napi::CallbackInfo &info) -> Napi::Value {
+    if (context->probe_id != 0) {
+      gst_pad_remove_probe(context->pad, context->probe_id);
+      context->probe_id = 0;
+
+      // The probe may still be running on the streaming thread, so close the batch under the
+      // lock before handing out what it has so far
+      std::lock_guard<std::mutex> lock(context->mutex);
+      context->stopped = true;
+      deliver_fingerprints(context);
+    }
+    return info.Env().Undefined();
+  });
+}
+
+// Shared by the pre-record probe and the handle returned to JS
+struct PreRecordContext {
+  PreRecordRing ring;
+  GstPad *pad;
+  gulong probe_id = 0;
+
+  PreRecordContext(const PreRecordLimits &limits, GstPad *pad) : ring(limits), pad(pad) {}
+  ~PreRecordContext() { gst_object_unref(pad); }
+};
+
+static GstPadProbeReturn
+prerecord_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+  PreRecordContext *context = static_cast<std::shared_ptr<PreRecordContext> *>(user_data)->get();
+
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    context->ring.push(GST_PAD_PROBE_INFO_BUFFER(info));
+    return GST_PAD_PROBE_OK;
+  }
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    for (guint i = 0; i < gst_buffer_list_length(list); i++) {
+      context->ring.push(gst_buffer_list_get(list, i));
+    }
+    return GST_PAD_PROBE_OK;
+  }
+
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_CAPS) {
+    GstCaps *caps;
+    gst_event_parse_caps(event, &caps);
+    context->ring.set_caps(caps);
+  } else if (GST_EVENT_TYPE(event) == GST_EVENT_FLUSH_STOP) {
+    // Data before a seek doesn't continue into what follows
+    context->ring.clear();
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+Napi::Value Element::add_prerecord_buffer(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!element.get()) {
+    Napi::TypeError::New(env, "Element is null or not initialized").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "addPreRecordBuffer() requires a pad name")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  PreRecordLimits limits;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Get("seconds").IsNumber()) {
+      double seconds = options.Get("seconds").As<Napi::Number>().DoubleValue();
+      if (seconds <= 0) {
+        Napi::TypeError::New(env, "seconds must be > 0").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      limits.duration = static_cast<GstClockTime>(seconds * GST_SECOND);
+    }
+    if (options.Get("maxBytes").IsNumber()) {
+      double max_bytes = options.Get("maxBytes").As<Napi::Number>().DoubleValue();
+      if (max_bytes < 0) {
+        Napi::TypeError::New(env, "maxBytes must be >= 0").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      limits.max_bytes = static_cast<size_t>(max_bytes);
+    }
+  }
+
+  std::string pad_name = info[0].As<Napi::String>().Utf8Value();
+  GstPad *pad = gst_element_get_static_pad(element.get(), pad_name.c_str());
+  if (!pad) {
+    Napi::Error::New(env, "Failed to get pad: " + pad_name).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto context = std::make_shared<PreRecordContext>(limits, pad);
+
+  GstCaps *caps = gst_pad_get_current_caps(pad);
+  if (caps) {
+    context->ring.set_caps(caps);
+    gst_caps_unref(caps);
+  }
+
+  context->probe_id = gst_pad_add_probe(
+    pad,
+    static_cast<GstPadProbeType>(
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST
+      | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM | GST_PAD_PROBE_TYPE_EVENT_FLUSH
+    ),
+    prerecord_probe, new std::shared_ptr<PreRecordContext>(context),
+    [](gpointer data) { delete static_cast<std::shared_ptr<PreRecordContext> *>(data); }
+  );
+
+  auto flush_to_method = Napi::Function::New(
+    env,
+    [context](const Napi::CallbackInfo &info) -> Napi::Value {
+      Napi::Env env = info.Env();
+
+      std::string path;
+      GstAppSrc *app_src = nullptr;
+      if (info.Length() > 0 && info[0].IsString()) {
+        path = info[0].As<Napi::String>().Utf8Value();
+      } else if (info.Length() > 0 && info[0].IsObject()
+                 && info[0].As<Napi::Object>().Get("type").StrictEquals(
+                   Napi::String::New(env, "app-src-element")
+                 )) {
+        // Anything can claim the type, only a wrapped app source is accepted
+        Element *target = Napi::ObjectWrap<Element>::Unwrap(info[0].As<Napi::Object>());
+        if (env.IsExceptionPending()) {
+          env.GetAndClearPendingException();
+        }
+        if (!target || !target->gst_element() || !GST_IS_APP_SRC(target->gst_element())) {
+          Napi::TypeError::New(env, "flushTo() target is not an app-src-element")
+            .ThrowAsJavaScriptException();
+          return env.Undefined();
+        }
+        app_src = GST_APP_SRC(target->gst_element());
+      } else {
+        Napi::TypeError::New(env, "flushTo() requires a file path or an app-src-element")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      auto snapshot = std::make_unique<PreRecordSnapshot>();
+      context->ring.snapshot(*snapshot);
+
+      PreRecordFlushWorker *worker =
+        new PreRecordFlushWorker(env, std::move(snapshot), path, app_src);
+      Napi::Promise promise = worker->GetPromise().Promise();
+      worker->Queue();
+      return promise;
+    },
+    "flushTo"
+  );
+  auto get_stats_method = Napi::Function::New(
+    env,
+    [context](const Napi::CallbackInfo &info) -> Napi::Value {
+      Napi::Env env = info.Env();
+      Napi::Object stats = Napi::Object::New(env);
+      stats.Set("buffers", Napi::Number::New(env, static_cast<double>(context->ring.size())));
+      stats.Set("bytes", Napi::Number::New(env, static_cast<double>(context->ring.bytes())));
+      stats.Set(
+        "duration",
+        Napi::Number::New(env, static_cast<double>(context->ring.duration()) / GST_SECOND)
+      );
+      return stats;
+    },
+    "getStats"
+  );
+  auto clear_method = Napi::Function::New(
+    env,
+    [context](const Napi::CallbackInfo &info) -> Napi::Value {
+      context->ring.clear();
+      return info.Env().Undefined();
+    },
+    "clear"
+  );
+  auto stop_method = Napi::Function::New(
+    env,
+    [context](const Napi::CallbackInfo &info) -> Napi::Value {
+      if (context->probe_id != 0) {
+        gst_pad_remove_probe(context->pad, context->probe_id);
+        context->probe_id = 0;
+      }
+      context->ring.clear();
+      return info.Env().Undefined();
+    },
+    "stop"
+  );
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("flushTo", flush_to_method);
+  result.Set("getStats", get_stats_method);
+  result.Set("clear", clear_method);
+  result.Set("stop", stop_method);
+  return result;
+}
+
+// Shared by the indexing probe and the handle returned to JS
+struct KeyframeIndexContext {
+  KeyframeIndexBuilder builder;
+  GstPad *pad;
+  gulong probe_id = 0;
+
+  explicit KeyframeIndexContext(GstPad *pad) : pad(pad) {}
+  ~KeyframeIndexContext() { gst_object_unref(pad); }
+};
+
+static GstPadProbeReturn
+keyframe_index_probe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+  KeyframeIndexContext *context =
+    static_cast<std::shared_ptr<KeyframeIndexContext> *>(user_data)->get();
+
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+    context->builder.push(GST_PAD_PROBE_INFO_BUFFER(info));
+    return GST_PAD_PROBE_OK;
+  }
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    for (guint i = 0; i < gst_buffer_list_length(list); i++) {
+      context->builder.push(gst_buffer_list_get(list, i));
+    }
+    return GST_PAD_PROBE_OK;
+  }
+
+  // Keyframes are indexed in stream time, which is what seek() positions refer to
+  GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+  if (GST_EVENT_TYPE(event) == GST_EVENT_SEGMENT) {
+    const GstSegment *segment;
+    gst_event_parse_segment(event, &segment);
+    context->builder.set_segment(segment);
+  }
+  return GST_PAD_PROBE_OK;
+}
+
+Napi::Value Element::add_keyframe_indexer(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "addKeyframeIndexer() requires a pad name")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string pad_name = info[0].As<Napi::String>().Utf8Value();
+  GstPad *pad = gst_element_get_static_pad(element.get(), pad_name.c_str());
+  if (!pad) {
+    Napi::Error::New(env, "Failed to get pad: " + pad_name).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto context = std::make_shared<KeyframeIndexContext>(pad);
+
+  GstEvent *segment_event = gst_pad_get_sticky_event(pad, GST_EVENT_SEGMENT, 0);
+  if (segment_event) {
+    const GstSegment *segment;
+    gst_event_parse_segment(segment_event, &segment);
+    context->builder.set_segment(segment);
+    gst_event_unref(segment_event);
+  }
+
+  context->probe_id = gst_pad_add_probe(
+    pad,
+    static_cast<GstPadProbeType>(
+      GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST
+      | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM
+    ),
+    keyframe_index_probe, new std::shared_ptr<KeyframeIndexContext>(context),
+    [](gpointer data) { delete static_cast<std::shared_ptr<KeyframeIndexContext> *>(data); }
+  );
+
+  auto get_index_method = Napi::Function::New(
+    env,
+    [context](const Napi::CallbackInfo &info) -> Napi::Value {
+      return KeyframeIndex::to_js(info.Env(), context->builder.entries());
+    },
+    "getIndex"
+  );
+  auto save_method = Napi::Function::New(
+    env,
+    [context](const Napi::CallbackInfo &info) -> Napi::Value {
+      Napi::Env env = info.Env();
+
+      if (info.Length() < 1 || !info[0].IsString()) {
+        Napi::TypeError::New(env, "save() requires a file path").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+
+      KeyframeIndexSaveWorker *worker = new KeyframeIndexSaveWorker(
+        env, context->builder.entries(), info[0].As<Napi::String>().Utf8Value()
+      );
+      Napi::Promise promise = worker->GetPromise().Promise();
+      worker->Queue();
+      return promise;
+    },
+    "save"
+  );
+  auto clear_method = Napi::Function::New(
+    env,
+    [context](const Napi::CallbackInfo &info) -> Napi::Value {
+      context->builder.clear();
+      return info.Env().Undefined();
+    },
+    "clear"
+  );
+  auto stop_method = Napi::Function::New(
+    env,
+    [context](const Napi::CallbackInfo &info) -> Napi::Value {
+      if (context->probe_id != 0) {
+        gst_pad_remove_probe(context->pad, context->probe_id);
+        context->probe_id = 0;
+      }
+      return info.Env().Undefined();
+    },
+    "stop"
+  );
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("getIndex", get_index_method);
+  result.Set("save", save_method);
+  result.Set("clear", clear_method);
+  result.Set("stop", stop_method);
+  return result;
+}
+
+// Shared by the notify handlers, queued deliveries and the unsubscribe function
+struct PropertyChangeContext {
+  Napi::ThreadSafeFunction tsfn;
+  Napi::FunctionReference callback;
+  GstElement *element;
+  std::vector<gulong> handlers;
+  gint64 min_interval_us;
+
+  std::mutex mutex;
+  std::set<std::string> dirty;
+  bool scheduled = false;
+  bool active = true;
+  gint64 last_delivery_us = 0;
+
+  ~PropertyChangeContext() { gst_object_unref(element); }
+};
+
+// Runs on the JS thread: reads the current value of everything that changed since the
+// last delivery and hands them to the callback in one object
+static void deliver_property_changes(
+  const Napi::Env &env, const std::shared_ptr<PropertyChangeContext> &context
+) {
+  std::set<std::string> changed;
+  {
+    std::lock_guard<std::mutex> lock(context->mutex);
+    if (!context->active) {
+      return;
+    }
+    changed.swap(context->dirty);
+    context->scheduled = false;
+    context->last_delivery_us = g_get_monotonic_time();
+  }
+
+  Napi::Object changes = Napi::Object::New(env);
+  GObjectClass *klass = G_OBJECT_GET_CLASS(context->element);
+  for (const std::string &name : changed) {
+    GParamSpec *spec = g_object_class_find_property(klass, name.c_str());
+    GValue value = G_VALUE_INIT;
+    g_value_init(&value, G_PARAM_SPEC_VALUE_TYPE(spec));
+    g_object_get_property(G_OBJECT(context->element), spec->name, &value);
+    Napi::Value js_value = TypeConversion::gvalue_to_js(env, &value);
+    g_value_unset(&value);
+
+    if (env.IsExceptionPending()) {
+      // Report the change even if the value can't be converted
+      env.GetAndClearPendingException();
+      js_value = env.Null();
+    }
+    changes.Set(name, js_value);
+  }
+
+  context->callback.Call({changes});
+}
+
+// notify:: handler, may run on any thread. Only marks the property dirty; a delivery is
+// queued when none is pending, so bursts of changes cost one JS call.
+static void property_notify_callback(GObject *object, GParamSpec *spec, gpointer user_data) {
+  auto &context = *static_cast<std::shared_ptr<PropertyChangeContext> *>(user_data);
+
+  gint64 delay_us = 0;
+  {
+    std::lock_guard<std::mutex> lock(context->mutex);
+    context->dirty.insert(spec->name);
+    if (context->scheduled || !context->active) {
+      return;
+    }
+    context->scheduled = true;
+    gint64 next_us = context->last_delivery_us + context->min_interval_us;
+    delay_us = MAX(next_us - g_get_monotonic_time(), 0);
+  }
+
+  std::shared_ptr<PropertyChangeContext> shared = context;
+  context->tsfn.NonBlockingCall([shared, delay_us](Napi::Env env, Napi::Function) {
+    if (delay_us == 0) {
+      deliver_property_changes(env, shared);
+      return;
+    }
+
+    // Rate limited: deliver once the interval has passed, with everything that changed
+    auto deliver = Napi::Function::New(env, [shared](const Napi::CallbackInfo &info) {
+      deliver_property_changes(info.Env(), shared);
+    });
+    Napi::Function set_timeout = env.Global().Get("setTimeout").As<Napi::Function>();
+    set_timeout.Call({deliver, Napi::Number::New(env, static_cast<double>(delay_us) / 1000)});
+  });
+}
+
+Napi::Value Element::on_property_change(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsArray() || !info[1].IsFunction()) {
+    Napi::TypeError::New(env, "Expected 2 arguments: property names array and callback")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  double min_interval_ms = 0;
+  if (info.Length() > 2 && info[2].IsObject()) {
+    Napi::Value interval = info[2].As<Napi::Object>().Get("minIntervalMs");
+    if (interval.IsNumber()) {
+      min_interval_ms = interval.As<Napi::Number>().DoubleValue();
+    }
+  }
+
+  // Validate all names before connecting anything
+  Napi::Array names = info[0].As<Napi::Array>();
+  std::vector<std::string> property_names;
+  GObjectClass *klass = G_OBJECT_GET_CLASS(element.get());
+  for (uint32_t i = 0; i < names.Length(); i++) {
+    Napi::Value name = names.Get(i);
+    if (!name.IsString()) {
+      Napi::TypeError::New(env, "Property name must be a string").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    std::string property_name = name.As<Napi::String>().Utf8Value();
+    if (!g_object_class_find_property(klass, property_name.c_str())) {
+      Napi::TypeError::New(env, ("Property '" + property_name + "' not found").c_str())
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    property_names.push_back(property_name);
+  }
+
+  Napi::Function callback = info[1].As<Napi::Function>();
+
+  auto context = std::make_shared<PropertyChangeContext>();
+  context->tsfn = Napi::ThreadSafeFunction::New(env, callback, "PropertyChangeCallback", 0, 1);
+  context->callback = Napi::Persistent(callback);
+  context->element = GST_ELEMENT(gst_object_ref(element.get()));
+  context->min_interval_us = static_cast<gint64>(MAX(min_interval_ms, 0) * 1000);
+
+  for (const std::string &property_name : property_names) {
+    std::string signal = "notify::" + property_name;
+    context->handlers.push_back(g_signal_connect_data(
+      element.get(), signal.c_str(), G_CALLBACK(property_notify_callback),
+      new std::shared_ptr<PropertyChangeContext>(context),
+      [](gpointer data, GClosure *) {
+        delete static_cast<std::shared_ptr<PropertyChangeContext> *>(data);
+      },
+      static_cast<GConnectFlags>(0)
+    ));
+  }
+
+  // Return an unsubscribe function
+  return Napi::Function::New(env, [context](const Napi::CallbackInfo &info) -> Napi::Value {
+    {
+      std::lock_guard<std::mutex> lock(context->mutex);
+      if (!context->active) {
+        return info.Env().Undefined();
+      }
+      context->active = false;
+    }
+
+    for (gulong handler : context->handlers) {
+      g_signal_handler_disconnect(context->element, handler);
+    }
+    context->tsfn.Release();
+    context->callback.Reset();
+
+    return info.Env().Undefined();
+  });
+}
+
+// Resolve the object carrying a controlled property: the element, or one of its pads when
+// options.pad is set (compositor/audiomixer pads have alpha, volume, xpos, ...)
+static GstObject *
+control_target(GstElement *element, const Napi::Value &options, std::string &error) {
+  if (!options.IsObject() || !options.As<Napi::Object>().Get("pad").IsString()) {
+    return GST_OBJECT(gst_object_ref(element));
+  }
+
+  std::string pad_name = options.As<Napi::Object>().Get("pad").As<Napi::String>().Utf8Value();
+  GstPad *pad = gst_element_get_static_pad(element, pad_name.c_str());
+  if (!pad) {
+    error = "Failed to get pad: " + pad_name;
+    return nullptr;
+  }
+  return GST_OBJECT(pad);
+}
+
+static GstInterpolationControlSource *
+interpolation_source_for(GstObject *target, const char *property_name) {
+  GstControlBinding *binding = gst_object_get_control_binding(target, property_name);
+  if (!binding) {
+    return nullptr;
+  }
+
+  GstControlSource *source = nullptr;
+  g_object_get(binding, "control-source", &source, NULL);
+  gst_object_unref(binding);
+
+  if (source && !GST_IS_INTERPOLATION_CONTROL_SOURCE(source)) {
+    gst_object_unref(source);
+    return nullptr;
+  }
+  return GST_INTERPOLATION_CONTROL_SOURCE(source);
+}
+
+Napi::Value Element::set_keyframes(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsArray()) {
+    Napi::TypeError::New(env, "setKeyframes() requires a property name and an array of keyframes")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string property_name = info[0].As<Napi::String>().Utf8Value();
+  Napi::Array keyframes = info[1].As<Napi::Array>();
+  Napi::Value options = info.Length() > 2 ? info[2] : env.Undefined();
+
+  GstInterpolationMode mode = GST_INTERPOLATION_MODE_LINEAR;
+  bool replace = false;
+  if (options.IsObject()) {
+    Napi::Object options_obj = options.As<Napi::Object>();
+    if (options_obj.Get("mode").IsString()) {
+      std::string mode_name = options_obj.Get("mode").As<Napi::String>().Utf8Value();
+      if (mode_name == "none") {
+        mode = GST_INTERPOLATION_MODE_NONE;
+      } else if (mode_name == "linear") {
+        mode = GST_INTERPOLATION_MODE_LINEAR;
+      } else if (mode_name == "cubic") {
+        mode = GST_INTERPOLATION_MODE_CUBIC;
+      } else if (mode_name == "cubic-monotonic") {
+        mode = GST_INTERPOLATION_MODE_CUBIC_MONOTONIC;
+      } else {
+        Napi::TypeError::New(
+          env, "Interpolation mode must be 'none', 'linear', 'cubic' or 'cubic-monotonic'"
+        )
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+    replace = options_obj.Get("replace").ToBoolean();
+  }
+
+  // Validate keyframes before touching the controller
+  std::vector<std::pair<GstClockTime, gdouble>> points;
+  for (uint32_t i = 0; i < keyframes.Length(); i++) {
+    Napi::Value keyframe = keyframes.Get(i);
+    Napi::Value time = keyframe.IsObject() ? keyframe.As<Napi::Object>().Get("time") : keyframe;
+    Napi::Value value = keyframe.IsObject() ? keyframe.As<Napi::Object>().Get("value") : keyframe;
+    if (!time.IsNumber() || !(value.IsNumber() || value.IsBoolean())
+        || time.As<Napi::Number>().DoubleValue() < 0) {
+      Napi::TypeError::New(env, "Keyframes must be { time: seconds >= 0, value: number }")
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    gdouble numeric = value.IsBoolean() ? (value.As<Napi::Boolean>().Value() ? 1.0 : 0.0)
+                                        : value.As<Napi::Number>().DoubleValue();
+    points.emplace_back(
+      static_cast<GstClockTime>(time.As<Napi::Number>().DoubleValue() * GST_SECOND), numeric
+    );
+  }
+
+  std::string error;
+  GstObject *target = control_target(element.get(), options, error);
+  if (!target) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  GParamSpec *spec =
+    g_object_class_find_property(G_OBJECT_GET_CLASS(target), property_name.c_str());
+  if (!spec) {
+    gst_object_unref(target);
+    Napi::TypeError::New(env, ("Property '" + property_name + "' not found").c_str())
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (!(spec->flags & GST_PARAM_CONTROLLABLE)) {
+    gst_object_unref(target);
+    Napi::TypeError::New(env, ("Property '" + property_name + "' is not controllable").c_str())
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  GstInterpolationControlSource *source = interpolation_source_for(target, spec->name);
+  if (!source) {
+    // Absolute binding: keyframe values are property values, not 0..1 ranges
+    source = GST_INTERPOLATION_CONTROL_SOURCE(gst_interpolation_control_source_new());
+    GstControlBinding *binding =
+      gst_direct_control_binding_new_absolute(target, spec->name, GST_CONTROL_SOURCE(source));
+    gst_object_add_control_binding(target, binding);
+  } else if (replace) {
+    gst_timed_value_control_source_unset_all(GST_TIMED_VALUE_CONTROL_SOURCE(source));
+  }
+
+  g_object_set(source, "mode", mode, NULL);
+  for (auto &[time, value] : points) {
+    gst_timed_value_control_source_set(GST_TIMED_VALUE_CONTROL_SOURCE(source), time, value);
+  }
+
+  gst_object_unref(source);
+  gst_object_unref(target);
+  return env.Undefined();
+}
+
+Napi::Value Element::clear_keyframes(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "clearKeyframes() requires a property name")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string property_name = info[0].As<Napi::String>().Utf8Value();
+  Napi::Value options = info.Length() > 1 ? info[1] : env.Undefined();
+
+  std::string error;
+  GstObject *target = control_target(element.get(), options, error);
+  if (!target) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // The property keeps the last value the controller applied
+  GstControlBinding *binding = gst_object_get_control_binding(target, property_name.c_str());
+  bool removed = false;
+  if (binding) {
+    removed = gst_object_remove_control_binding(target, binding);
+    gst_object_unref(binding);
+  }
+
+  gst_object_unref(target);
+  return Napi::Boolean::New(env, removed);
+}
+
+Napi::Value Element::push(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  // Validate that we have an app source element
+  if (!element || !GST_IS_APP_SRC(element.get())) {
+    Napi::TypeError::New(env, "push() can only be called on app-src-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1) {
+    Napi::TypeError::New(env, "push() requires at least 1 argument: buffer")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!info[0].IsBuffer()) {
+    Napi::TypeError::New(env, "First argument must be a Buffer").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Get buffer data from Node.js Buffer
+  Napi::Buffer<uint8_t> node_buffer = info[0].As<Napi::Buffer<uint8_t>>();
+  uint8_t *buffer_data = node_buffer.Data();
+  size_t buffer_length = node_buffer.Length();
+
+  // Create GStreamer buffer, from the element's arena when setAllocator() configured one
+  std::shared_ptr<BufferArena> arena = BufferArena::from_element(element.get());
+  GstBuffer *gst_buffer = arena ? arena->new_buffer(buffer_length)
+                                : gst_buffer_new_allocate(nullptr, buffer_length, nullptr);
+  if (!gst_buffer) {
+    Napi::Error::New(env, "Failed to allocate GStreamer buffer").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Fill the buffer with data
+  gst_buffer_fill(gst_buffer, 0, buffer_data, buffer_length);
+
+  // Handle optional PTS (presentation timestamp) parameter
+  if (info.Length() > 1) {
+    if (info[1].IsBuffer()) {
+      // Handle PTS as buffer (compatible with original NAN implementation)
+      Napi::Buffer<uint8_t> pts_buffer = info[1].As<Napi::Buffer<uint8_t>>();
+      if (pts_buffer.Length() >= 8) {
+        uint8_t *pts_data = pts_buffer.Data();
+        // Read as big-endian uint64
+        guint64 pts = GST_READ_UINT64_BE(pts_data);
+        GST_BUFFER_PTS(gst_buffer) = pts;
+      }
+    } else if (info[1].IsNumber()) {
+      // Handle PTS as number (more convenient JavaScript API)
+      guint64 pts = static_cast<guint64>(info[1].As<Napi::Number>().Int64Value());
+      GST_BUFFER_PTS(gst_buffer) = pts;
+    }
+  }
+
+  // Push buffer to app source
+  GstFlowReturn ret = gst_app_src_push_buffer(GST_APP_SRC(element.get()), gst_buffer);
+
+  // Check for errors
+  if (ret != GST_FLOW_OK) {
+    // Buffer is consumed by push_buffer even on error, so don't unref it
+    std::string error_msg = "Failed to push buffer: ";
+    switch (ret) {
+      case GST_FLOW_FLUSHING:
+        error_msg += "Element is flushing";
+        break;
+      case GST_FLOW_EOS:
+        error_msg += "End of stream";
+        break;
+      case GST_FLOW_NOT_LINKED:
+        error_msg += "Source pad not linked";
+        break;
+      case GST_FLOW_ERROR:
+        error_msg += "Generic error";
+        break;
+      default:
+        error_msg += "Unknown error (" + std::to_string(ret) + ")";
+        break;
+    }
+    Napi::Error::New(env, error_msg).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value Element::end_of_stream(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  // Validate that we have an app source element
+  if (!element || !GST_IS_APP_SRC(element.get())) {
+    Napi::TypeError::New(env, "endOfStream() can only be called on app-src-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Send end-of-stream signal to app source
+  GstFlowReturn ret = gst_app_src_end_of_stream(GST_APP_SRC(element.get()));
+
+  // Check for errors
+  if (ret != GST_FLOW_OK) {
+    std::string error_msg = "Failed to send end-of-stream: ";
+    switch (ret) {
+      case GST_FLOW_FLUSHING:
+        error_msg += "Element is flushing";
+        break;
+      case GST_FLOW_EOS:
+        error_msg += "Already at end of stream";
+        break;
+      case GST_FLOW_NOT_LINKED:
+        error_msg += "Source pad not linked";
+        break;
+      case GST_FLOW_ERROR:
+        error_msg += "Generic error";
+        break;
+      default:
+        error_msg += "Unknown error (" + std::to_string(ret) + ")";
+        break;
+    }
+    Napi::Error::New(env, error_msg).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value Element::set_memory_source(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!element || !GST_IS_APP_SRC(element.get())) {
+    Napi::TypeError::New(env, "setMemorySource() can only be called on app-src-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1) {
+    Napi::TypeError::New(env, "setMemorySource() requires a buffer").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  MemorySourceOptions options;
+  std::unique_ptr<GstCaps, decltype(&gst_caps_unref)> caps(nullptr, gst_caps_unref);
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object js_options = info[1].As<Napi::Object>();
+    if (js_options.Get("blockSize").IsNumber()) {
+      double block_size = js_options.Get("blockSize").As<Napi::Number>().DoubleValue();
+      if (block_size < 1 || block_size > G_MAXUINT32) {
+        Napi::TypeError::New(env, "blockSize must be a positive number of bytes")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      options.block_size = static_cast<guint>(block_size);
+    }
+    if (js_options.Get("caps").IsString()) {
+      std::string caps_string = js_options.Get("caps").As<Napi::String>().Utf8Value();
+      caps.reset(gst_caps_from_string(caps_string.c_str()));
+      if (!caps) {
+        Napi::TypeError::New(env, "Invalid caps: " + caps_string).ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      options.caps = caps.get();
+    }
+  }
+
+  std::string error;
+  if (!MemorySource::attach(env, GST_APP_SRC(element.get()), info[0], options, error)) {
+    Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+  }
+  return env.Undefined();
+}
+
+Napi::Value Element::set_allocator(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!element || !GST_IS_APP_SRC(element.get())) {
+    Napi::TypeError::New(env, "setAllocator() can only be called on app-src-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1 || !(info[0].IsObject() || info[0].IsNull())) {
+    Napi::TypeError::New(env, "setAllocator() requires an options object or null")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  // Buffers already pushed keep the previous arena alive until they are freed
+  if (info[0].IsNull()) {
+    BufferArena::attach(element.get(), nullptr);
+    return env.Undefined();
+  }
+
+  BufferArenaOptions options;
+  Napi::Object js_options = info[0].As<Napi::Object>();
+  Napi::Value alignment = js_options.Get("alignment");
+  if (alignment.IsString() && alignment.As<Napi::String>().Utf8Value() == "page") {
+    options.alignment = BufferArena::page_size();
+  } else if (!alignment.IsUndefined()) {
+    double bytes = alignment.IsNumber() ? alignment.As<Napi::Number>().DoubleValue() : 0;
+    size_t value = bytes >= 1 ? static_cast<size_t>(bytes) : 0;
+    if (value == 0 || value != bytes || (value & (value - 1)) != 0
+        || value > BufferArena::page_size()) {
+      Napi::TypeError::New(env, "alignment must be \"page\" or a power of two up to the page size")
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    options.alignment = value;
+  }
+  if (js_options.Get("hugePages").IsBoolean()) {
+    options.huge_pages = js_options.Get("hugePages").As<Napi::Boolean>().Value();
+  }
+
+  BufferArena::attach(element.get(), std::make_shared<BufferArena>(options));
+  return env.Undefined();
+}
+
+Napi::Value Element::get_allocator_stats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::shared_ptr<BufferArena> arena =
+    element ? BufferArena::from_element(element.get()) : nullptr;
+  if (!arena) {
+    return env.Null();
+  }
+
+  BufferArenaStats stats = arena->stats();
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("alignment", Napi::Number::New(env, static_cast<double>(stats.alignment)));
+  result.Set("allocations", Napi::Number::New(env, static_cast<double>(stats.allocations)));
+  result.Set("recycled", Napi::Number::New(env, static_cast<double>(stats.recycled)));
+  result.Set("slabs", Napi::Number::New(env, static_cast<double>(stats.slabs)));
+  result.Set(
+    "largeAllocations", Napi::Number::New(env, static_cast<double>(stats.large_allocations))
+  );
+  result.Set("bytesInUse", Napi::Number::New(env, static_cast<double>(stats.bytes_in_use)));
+  result.Set(
+    "peakBytesInUse", Napi::Number::New(env, static_cast<double>(stats.peak_bytes_in_use))
+  );
+  result.Set("bytesReserved", Napi::Number::New(env, static_cast<double>(stats.bytes_reserved)));
+  result.Set("hugePageBytes", Napi::Number::New(env, static_cast<double>(stats.huge_page_bytes)));
+  return result;
+}
+
+Napi::Value Element::pump_from(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!element || !GST_IS_APP_SRC(element.get())) {
+    Napi::TypeError::New(env, "pumpFrom() can only be called on app-src-element")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() < 1 || !info[0].IsNumber() || info[0].As<Napi::Number>().Int32Value() < 0) {
+    Napi::TypeError::New(env, "pumpFrom() requires a file descriptor")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  int fd = info[0].As<Napi::Number>().Int32Value();
+
+  FdPumpOptions options;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object js_options = info[1].As<Napi::Object>();
+    if (js_options.Get("chunkSize").IsNumber()) {
+      double chunk_size = js_options.Get("chunkSize").As<Napi::Number>().DoubleValue();
+      if (chunk_size < 1 || chunk_size > G_MAXINT32) {
+        Napi::TypeError::New(env, "chunkSize must be a positive number of bytes")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      options.chunk_size = static_cast<size_t>(chunk_size);
+    }
+    if (js_options.Get("readahead").IsNumber()) {
+      double readahead = js_options.Get("readahead").As<Napi::Number>().DoubleValue();
+      if (readahead < 1) {
+        Napi::TypeError::New(env, "readahead must be a positive number of bytes")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      options.readahead = static_cast<guint64>(readahead);
+    }
+    if (js_options.Get("endOfStream").IsBoolean()) {
+      options.end_of_stream = js_options.Get("endOfStream").As<Napi::Boolean>().Value();
+    }
+  }
+
+  // Settles the promise on the JS thread once the pump thread reports back
+  Napi::ThreadSafeFunction tsfn = Napi::ThreadSafeFunction::New(
+    env, Napi::Function::New(env, [](const Napi::CallbackInfo &) {}), "FdPump", 0, 1
+  );
+  auto deferred = std::make_shared<Napi::Promise::Deferred>(env);
+
+  std::string error;
+  std::shared_ptr<FdPump> pump = FdPump::start(
+    GST_APP_SRC(element.get()), fd, options,
+    [tsfn, deferred](const FdPumpResult &result) mutable {
+      tsfn.NonBlockingCall([deferred, result](Napi::Env env, Napi::Function) {
+        if (!result.error.empty()) {
+          deferred->Reject(Napi::Error::New(env, result.error).Value());
+          return;
+        }
+        Napi::Object summary = Napi::Object::New(env);
+        summary.Set("bytes", Napi::Number::New(env, static_cast<double>(result.bytes)));
+        summary.Set("buffers", Napi::Number::New(env, static_cast<double>(result.buffers)));
+        summary.Set("stopped", Napi::Boolean::New(env, result.stopped));
+        deferred->Resolve(summary);
+      });
+      tsfn.Release();
+    },
+    error
+  );
+  if (!pump) {
+    tsfn.Release();
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  auto stop_method = Napi::Function::New(
+    env,
+    [pump](const Napi::CallbackInfo &info) -> Napi::Value {
+      pump->stop();
+      return info.Env().Undefined();
+    },
+    "stop"
+  );
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("done", deferred->Promise());
+  result.Set("stop", stop_method);
+  return result;
 }
 
 Napi::Value Element::set_pad(const Napi::CallbackInfo &info) {
@@ -16,15 +16,36 @@ public:
 
   Napi::Value get_element_property(const Napi::CallbackInfo &info);
   Napi::Value set_element_property(const Napi::CallbackInfo &info);
+  Napi::Value property(const Napi::CallbackInfo &info);
+  Napi::Value get_properties(const Napi::CallbackInfo &info);
+  Napi::Value set_properties(const Napi::CallbackInfo &info);
+  Napi::Value on_property_change(const Napi::CallbackInfo &info);
+  Napi::Value add_audio_meter(const Napi::CallbackInfo &info);
+  Napi::Value add_motion_detector(const Napi::CallbackInfo &info);
+  Napi::Value add_fingerprinter(const Napi::CallbackInfo &info);
+  Napi::Value add_prerecord_buffer(const Napi::CallbackInfo &info);
+  Napi::Value add_keyframe_indexer(const Napi::CallbackInfo &info);
+  Napi::Value set_keyframes(const Napi::CallbackInfo &info);
+  Napi::Value clear_keyframes(const Napi::CallbackInfo &info);
   Napi::Value add_pad_probe(const Napi::CallbackInfo &info);
   Napi::Value set_pad(const Napi::CallbackInfo &info);
   Napi::Value get_pad(const Napi::CallbackInfo &info);
 
   Napi::Value get_sample(const Napi::CallbackInfo &info);
   Napi::Value on_sample(const Napi::CallbackInfo &info);
+  Napi::Value get_preroll(const Napi::CallbackInfo &info);
+  Napi::Value get_video_frame(const Napi::CallbackInfo &info);
+  Napi::Value get_regions(const Napi::CallbackInfo &info);
+  Napi::Value step(const Napi::CallbackInfo &info);
 
   Napi::Value push(const Napi::CallbackInfo &info);
   Napi::Value end_of_stream(const Napi::CallbackInfo &info);
+  Napi::Value set_memory_source(const Napi::CallbackInfo &info);
+  Napi::Value pump_from(const Napi::CallbackInfo &info);
+  Napi::Value set_allocator(const Napi::CallbackInfo &info);
+  Napi::Value get_allocator_stats(const Napi::CallbackInfo &info);
+
+  GstElement *gst_element() const { return element.get(); }
 
 private:
   std::unique_ptr<GstElement, decltype(&gst_object_unref)> element;
@@ -0,0 +1,183 @@
+#include "encoder-pool.hpp"
+#include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Idle pipelines kept per codec, roughly the size of the libuv thread pool
+static const size_t MAX_IDLE_ENCODERS = 4;
+// Upper bound for encoding one frame before the pipeline is considered stuck
+static const GstClockTime ENCODE_TIMEOUT = 10 * GST_SECOND;
+
+struct Encoder {
+  GstElement *pipeline = nullptr;
+  GstElement *src = nullptr;
+  GstElement *encoder = nullptr;
+  GstElement *sink = nullptr;
+
+  ~Encoder() {
+    if (pipeline) {
+      gst_element_set_state(pipeline, GST_STATE_NULL);
+      gst_object_unref(src);
+      gst_object_unref(encoder);
+      gst_object_unref(sink);
+      gst_object_unref(pipeline);
+    }
+  }
+};
+
+static std::mutex pool_mutex;
+static std::map<std::string, std::vector<Encoder *>> idle_encoders;
+
+static const char *factory_for(const std::string &codec) {
+  if (codec == "jpeg") {
+    return "jpegenc";
+  }
+  if (codec == "png") {
+    return "pngenc";
+  }
+  if (codec == "webp") {
+    return "webpenc";
+  }
+  return nullptr;
+}
+
+bool EncoderPool::available(const std::string &codec, std::string &error) {
+  const char *factory_name = factory_for(codec);
+  if (!factory_name) {
+    error = "Unknown codec: " + codec + " (expected \"jpeg\", \"png\" or \"webp\")";
+    return false;
+  }
+
+  GstElementFactory *factory = gst_element_factory_find(factory_name);
+  if (!factory) {
+    error = std::string("No encoder available for ") + codec + " (" + factory_name + ")";
+    return false;
+  }
+  gst_object_unref(factory);
+  return true;
+}
+
+static Encoder *create_encoder(const std::string &codec, std::string &error) {
+  auto encoder = std::make_unique<Encoder>();
+  encoder->pipeline = GST_ELEMENT(gst_object_ref_sink(gst_pipeline_new(nullptr)));
+  encoder->src = gst_element_factory_make("appsrc", nullptr);
+  GstElement *convert = gst_element_factory_make("videoconvert", nullptr);
+  encoder->encoder = gst_element_factory_make(factory_for(codec), nullptr);
+  encoder->sink = gst_element_factory_make("appsink", nullptr);
+
+  if (!encoder->src || !convert || !encoder->encoder || !encoder->sink) {
+    error = "Failed to create " + codec + " encoder pipeline";
+    for (GstElement *element : {encoder->src, convert, encoder->encoder, encoder->sink}) {
+      if (element) {
+        gst_object_unref(gst_object_ref_sink(element));
+      }
+    }
+    gst_object_unref(encoder->pipeline);
+    encoder->pipeline = nullptr;
+    return nullptr;
+  }
+
+  g_object_set(encoder->src, "format", GST_FORMAT_TIME, "block", FALSE, NULL);
+  g_object_set(encoder->sink, "sync", FALSE, "max-buffers", 1, NULL);
+
+  // Keep our own references, the bin owns the floating ones
+  gst_object_ref(encoder->src);
+  gst_object_ref(encoder->encoder);
+  gst_object_ref(encoder->sink);
+  gst_bin_add_many(
+    GST_BIN(encoder->pipeline), encoder->src, convert, encoder->encoder, encoder->sink, NULL
+  );
+
+  if (!gst_element_link_many(encoder->src, convert, encoder->encoder, encoder->sink, NULL)) {
+    error = "Failed to link " + codec + " encoder pipeline";
+    return nullptr;
+  }
+  if (gst_element_set_state(encoder->pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE) {
+    error = "Failed to start " + codec + " encoder pipeline";
+    return nullptr;
+  }
+  return encoder.release();
+}
+
+static Encoder *acquire(const std::string &codec, std::string &error) {
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    std::vector<Encoder *> &idle = idle_encoders[codec];
+    if (!idle.empty()) {
+      Encoder *encoder = idle.back();
+      idle.pop_back();
+      return encoder;
+    }
+  }
+  return create_encoder(codec, error);
+}
+
+static void release(const std::string &codec, Encoder *encoder) {
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex);
+    std::vector<Encoder *> &idle = idle_encoders[codec];
+    if (idle.size() < MAX_IDLE_ENCODERS) {
+      idle.push_back(encoder);
+      return;
+    }
+  }
+  delete encoder;
+}
+
+// First error posted by the pipeline, if any
+static std::string pipeline_error(Encoder *encoder) {
+  GstBus *bus = gst_element_get_bus(encoder->pipeline);
+  GstMessage *message = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+  gst_object_unref(bus);
+  if (!message) {
+    return "";
+  }
+
+  GError *err = nullptr;
+  gst_message_parse_error(message, &err, nullptr);
+  std::string text = err ? err->message : "Unknown error";
+  g_clear_error(&err);
+  gst_message_unref(message);
+  return text;
+}
+
+GstBuffer *
+EncoderPool::encode(const std::string &codec, int quality, GstSample *sample, std::string &error) {
+  if (!available(codec, error)) {
+    return nullptr;
+  }
+  Encoder *encoder = acquire(codec, error);
+  if (!encoder) {
+    return nullptr;
+  }
+
+  if (codec != "png") {
+    // jpegenc takes an integer and webpenc a float, let GStreamer parse either
+    gst_util_set_object_arg(G_OBJECT(encoder->encoder), "quality", std::to_string(quality).c_str());
+  }
+
+  // Caps changes between frames renegotiate the pipeline in place
+  GstSample *encoded = nullptr;
+  if (gst_app_src_push_sample(GST_APP_SRC(encoder->src), sample) == GST_FLOW_OK) {
+    encoded = gst_app_sink_try_pull_sample(GST_APP_SINK(encoder->sink), ENCODE_TIMEOUT);
+  }
+
+  if (!encoded || !gst_sample_get_buffer(encoded)) {
+    // A failed pipeline is not reused
+    if (encoded) {
+      gst_sample_unref(encoded);
+    }
+    std::string message = pipeline_error(encoder);
+    error = "Failed to encode " + codec + (message.empty() ? "" : ": " + message);
+    delete encoder;
+    return nullptr;
+  }
+
+  GstBuffer *buffer = gst_buffer_ref(gst_sample_get_buffer(encoded));
+  gst_sample_unref(encoded);
+  release(codec, encoder);
+  return buffer;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <string>
+
+// Reusable appsrc ! videoconvert ! <encoder> ! appsink pipelines for encoding single frames.
+//
+// Building and starting a pipeline costs more than encoding a thumbnail, so pipelines stay
+// PLAYING between frames and are handed out to one caller at a time. Safe to call from any
+// thread; a few idle pipelines per codec are kept for the lifetime of the process.
+class EncoderPool {
+public:
+  // Codec names are "jpeg", "png" and "webp"; false when the encoder plugin is not installed
+  static bool available(const std::string &codec, std::string &error);
+
+  // Encode one raw video sample. Quality (0-100) is ignored by lossless codecs. Blocks until
+  // the encoded frame is ready; returns nullptr and sets error on failure. The pipeline may
+  // still reference the sample's buffer afterwards, so its memory must outlive the buffer.
+  static GstBuffer *
+  encode(const std::string &codec, int quality, GstSample *sample, std::string &error);
+};
@@ -0,0 +1,221 @@
+#include "fd-pump.hpp"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <io.h>
+#include <windows.h>
+#else
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+// Recycles the memory of buffers the pipeline is done with, so steady-state pumping does not
+// allocate. Blocks beyond what the readahead can hold are freed instead of kept.
+struct FdBlockPool {
+  size_t block_size;
+  size_t max_free;
+  std::mutex mutex;
+  std::vector<guint8 *> free;
+
+  FdBlockPool(size_t block_size, size_t max_free) : block_size(block_size), max_free(max_free) {}
+  ~FdBlockPool() {
+    for (guint8 *block : free) {
+      g_free(block);
+    }
+  }
+
+  guint8 *acquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free.empty()) {
+      return static_cast<guint8 *>(g_malloc(block_size));
+    }
+    guint8 *block = free.back();
+    free.pop_back();
+    return block;
+  }
+
+  void recycle(guint8 *block) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (free.size() < max_free) {
+      free.push_back(block);
+    } else {
+      g_free(block);
+    }
+  }
+};
+
+// Handed to a wrapped memory, returns the block when the last buffer using it is freed
+struct FdBlock {
+  std::shared_ptr<FdBlockPool> pool;
+  guint8 *data;
+};
+
+static void recycle_block(gpointer user_data) {
+  FdBlock *block = static_cast<FdBlock *>(user_data);
+  block->pool->recycle(block->data);
+  delete block;
+}
+
+std::shared_ptr<FdPump> FdPump::start(
+  GstAppSrc *app_src, int fd, const FdPumpOptions &options, DoneCallback done, std::string &error
+) {
+  std::shared_ptr<FdPump> pump(new FdPump());
+  pump->app_src = GST_APP_SRC(gst_object_ref(app_src));
+  pump->fd = fd;
+  pump->options = options;
+  pump->done = std::move(done);
+  pump->blocks = std::make_shared<FdBlockPool>(
+    options.chunk_size, static_cast<size_t>(options.readahead / options.chunk_size) + 2
+  );
+
+#ifndef _WIN32
+  if (pipe(pump->wake_fds) != 0) {
+    error = std::string("Failed to create wake pipe: ") + std::strerror(errno);
+    return nullptr;
+  }
+#endif
+
+  // need-data wakes a pump waiting for space early, the level check stays authoritative
+  pump->need_data_handler = g_signal_connect_data(
+    app_src, "need-data", G_CALLBACK(on_need_data), new std::weak_ptr<FdPump>(pump),
+    [](gpointer data, GClosure *) { delete static_cast<std::weak_ptr<FdPump> *>(data); },
+    static_cast<GConnectFlags>(0)
+  );
+
+  // The thread owns a reference until it has reported back
+  std::thread([pump]() { pump->run(); }).detach();
+  return pump;
+}
+
+FdPump::~FdPump() {
+#ifndef _WIN32
+  for (int wake_fd : wake_fds) {
+    if (wake_fd >= 0) {
+      close(wake_fd);
+    }
+  }
+#endif
+  gst_object_unref(app_src);
+}
+
+void FdPump::stop() {
+  if (stopping.exchange(true)) {
+    return;
+  }
+  space.notify_all();
+#ifndef _WIN32
+  char byte = 0;
+  if (write(wake_fds[1], &byte, 1) < 0) {
+    // Full or closed pipe, the pump is already waking up or done
+  }
+#endif
+}
+
+void FdPump::on_need_data(GstAppSrc *, guint, gpointer user_data) {
+  if (std::shared_ptr<FdPump> pump = static_cast<std::weak_ptr<FdPump> *>(user_data)->lock()) {
+    std::lock_guard<std::mutex> lock(pump->mutex);
+    pump->space.notify_all();
+  }
+}
+
+bool FdPump::wait_for_space() {
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping && gst_app_src_get_current_level_bytes(app_src) >= options.readahead) {
+    // need-data only fires once the queue runs empty, poll the level in between
+    space.wait_for(lock, std::chrono::milliseconds(10));
+  }
+  return !stopping;
+}
+
+bool FdPump::wait_readable() {
+#ifdef _WIN32
+  // There is no poll() for descriptors and a blocked _read() can't be interrupted, so pipes are
+  // only read once they hold data. Files don't block for long and are read directly.
+  HANDLE handle = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  if (handle == INVALID_HANDLE_VALUE || GetFileType(handle) != FILE_TYPE_PIPE) {
+    return !stopping;
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  while (!stopping) {
+    DWORD available = 0;
+    // Errors such as a closed writer are left to _read(), which reports them or end of file
+    if (!PeekNamedPipe(handle, nullptr, 0, nullptr, &available, nullptr) || available > 0) {
+      return true;
+    }
+    space.wait_for(lock, std::chrono::milliseconds(10));
+  }
+  return false;
+#else
+  while (!stopping) {
+    pollfd fds[2] = {{fd, POLLIN, 0}, {wake_fds[0], POLLIN, 0}};
+    int ready = poll(fds, 2, -1);
+    if (ready < 0 && errno == EINTR) {
+      continue;
+    }
+    // Errors and hang-ups are left to read(), which reports them or returns end of file
+    return !stopping;
+  }
+  return false;
+#endif
+}
+
+void FdPump::run() {
+  FdPumpResult result;
+
+  while (true) {
+    if (!wait_for_space() || !wait_readable()) {
+      result.stopped = true;
+      break;
+    }
+
+    guint8 *data = blocks->acquire();
+#ifdef _WIN32
+    int count = _read(fd, data, static_cast<unsigned int>(options.chunk_size));
+#else
+    ssize_t count = read(fd, data, options.chunk_size);
+#endif
+    if (count <= 0) {
+      blocks->recycle(data);
+      if (count < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        continue;
+      }
+      if (count < 0) {
+        result.error = std::string("Failed to read: ") + std::strerror(errno);
+      } else if (options.end_of_stream) {
+        gst_app_src_end_of_stream(app_src);
+      }
+      break;
+    }
+
+    GstBuffer *buffer = gst_buffer_new();
+    gst_buffer_append_memory(
+      buffer,
+      gst_memory_new_wrapped(
+        static_cast<GstMemoryFlags>(0), data, options.chunk_size, 0, static_cast<gsize>(count),
+        new FdBlock{blocks, data}, recycle_block
+      )
+    );
+    GST_BUFFER_OFFSET(buffer) = result.bytes;
+    GST_BUFFER_OFFSET_END(buffer) = result.bytes + count;
+
+    GstFlowReturn ret = gst_app_src_push_buffer(app_src, buffer);
+    if (ret == GST_FLOW_FLUSHING || ret == GST_FLOW_EOS) {
+      result.stopped = true;
+      break;
+    }
+    if (ret != GST_FLOW_OK) {
+      result.error = std::string("Failed to push buffer: ") + gst_flow_get_name(ret);
+      break;
+    }
+    result.bytes += count;
+    result.buffers++;
+  }
+
+  g_signal_handler_disconnect(app_src, need_data_handler);
+  done(result);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+#include <memory>
+#include <mutex>
+#include <string>
+
+struct FdPumpOptions {
+  size_t chunk_size = 64 * 1024; // Bytes per read and per buffer at most
+  guint64 readahead = 1024 * 1024; // Bytes queued in the app source before reading pauses
+  bool end_of_stream = true; // Send EOS when the descriptor reaches end of file
+};
+
+struct FdPumpResult {
+  guint64 bytes = 0;
+  guint64 buffers = 0;
+  bool stopped = false; // Ended by stop() or a flushing app source rather than end of file
+  std::string error;
+};
+
+struct FdBlockPool;
+
+// Reads a file descriptor on its own thread and pushes what it reads into an app source. Data
+// lands in recycled memory blocks that are wrapped into buffers without a copy, and reading
+// pauses while the app source holds more than the readahead. The descriptor stays owned by the
+// caller and must remain open until the done callback has run.
+class FdPump {
+public:
+  using DoneCallback = std::function<void(const FdPumpResult &)>;
+
+  /**
+   * Start pumping
+   * @param app_src The app source to push into
+   * @param fd A readable file, pipe or socket descriptor, blocking or not
+   * @param options Chunk size, readahead and end-of-stream handling
+   * @param done Called once from the pump thread when the pump ends
+   * @param error Set when the pump cannot be started
+   * @return The running pump, or nullptr on error
+   */
+  static std::shared_ptr<FdPump> start(
+    GstAppSrc *app_src, int fd, const FdPumpOptions &options, DoneCallback done,
+    std::string &error
+  );
+
+  ~FdPump();
+
+  // Ask the pump to end, it finishes the current push and calls the done callback. On Windows
+  // a read already blocked on a character device (a console) only returns with its data.
+  void stop();
+
+private:
+  FdPump() = default;
+  void run();
+  bool wait_for_space();
+  bool wait_readable();
+  static void on_need_data(GstAppSrc *app_src, guint length, gpointer user_data);
+
+  GstAppSrc *app_src = nullptr;
+  int fd = -1;
+  FdPumpOptions options;
+  DoneCallback done;
+  std::shared_ptr<FdBlockPool> blocks;
+  gulong need_data_handler = 0;
+
+  std::atomic<bool> stopping{false};
+  std::mutex mutex;
+  std::condition_variable space;
+  int wake_fds[2] = {-1, -1}; // Self-pipe interrupting poll() on stop
+};
@@ -0,0 +1,131 @@
+#include "fingerprint.hpp"
+#include "simd.hpp"
+#include <algorithm>
+#include <cmath>
+
+// dHash compares neighbours on a 9x8 grid, pHash keeps 8x8 DCT coefficients of a 32x32 grid
+static const size_t DHASH_WIDTH = 9;
+static const size_t DHASH_HEIGHT = 8;
+static const size_t DCT_SIZE = 32;
+static const size_t HASH_SIZE = 8;
+
+Fingerprinter::Fingerprinter(FingerprintAlgorithm algorithm) : algorithm(algorithm) {
+  if (algorithm == FingerprintAlgorithm::PHASH) {
+    const double pi = 3.14159265358979323846;
+    basis.resize(HASH_SIZE * DCT_SIZE);
+    for (size_t k = 0; k < HASH_SIZE; k++) {
+      for (size_t n = 0; n < DCT_SIZE; n++) {
+        double angle = pi * static_cast<double>((2 * n + 1) * k) / (2 * DCT_SIZE);
+        basis[k * DCT_SIZE + n] = static_cast<float>(std::cos(angle));
+      }
+    }
+    partial.resize(HASH_SIZE * DCT_SIZE);
+  }
+}
+
+bool Fingerprinter::configure(GstCaps *caps) {
+  configured = false;
+
+  GstVideoInfo info;
+  if (!caps || !gst_video_info_from_caps(&info, caps)) {
+    return false;
+  }
+
+  // Box-downscale as far as possible while keeping enough pixels to resample from
+  size_t target = algorithm == FingerprintAlgorithm::PHASH ? DCT_SIZE : DHASH_WIDTH;
+  size_t factor = std::min(
+    static_cast<size_t>(GST_VIDEO_INFO_WIDTH(&info)) / target,
+    static_cast<size_t>(GST_VIDEO_INFO_HEIGHT(&info)) / target
+  );
+  if (!luma.configure(info, factor) || luma.width() < target || luma.height() < target) {
+    return false;
+  }
+
+  image.assign(luma.width() * luma.height(), 0);
+  configured = true;
+  return true;
+}
+
+void Fingerprinter::resample(size_t width, size_t height) {
+  size_t source_width = luma.width();
+  size_t source_height = luma.height();
+  grid.resize(width * height);
+
+  for (size_t y = 0; y < height; y++) {
+    size_t top = y * source_height / height;
+    size_t bottom = std::max(top + 1, (y + 1) * source_height / height);
+    for (size_t x = 0; x < width; x++) {
+      size_t left = x * source_width / width;
+      size_t right = std::max(left + 1, (x + 1) * source_width / width);
+
+      uint32_t sum = 0;
+      for (size_t sy = top; sy < bottom; sy++) {
+        const uint8_t *row = image.data() + sy * source_width;
+        for (size_t sx = left; sx < right; sx++) {
+          sum += row[sx];
+        }
+      }
+      size_t area = (bottom - top) * (right - left);
+      grid[y * width + x] = static_cast<float>(sum) / static_cast<float>(area);
+    }
+  }
+}
+
+uint64_t Fingerprinter::difference_hash() const {
+  // One bit per horizontal neighbour pair, set when the left pixel is brighter
+  uint64_t result = 0;
+  for (size_t y = 0; y < DHASH_HEIGHT; y++) {
+    const float *row = grid.data() + y * DHASH_WIDTH;
+    for (size_t x = 0; x + 1 < DHASH_WIDTH; x++) {
+      result = (result << 1) | (row[x] > row[x + 1] ? 1 : 0);
+    }
+  }
+  return result;
+}
+
+uint64_t Fingerprinter::dct_hash() {
+  // Only the 8x8 low-frequency corner of the 2D DCT is needed: B * X * B^T with B the
+  // first 8 basis rows. Each entry is a 32-element dot product.
+  for (size_t k = 0; k < HASH_SIZE; k++) {
+    for (size_t y = 0; y < DCT_SIZE; y++) {
+      // partial[k][y] = row y of X transformed by basis k
+      partial[k * DCT_SIZE + y] =
+        Simd::dot_f32(grid.data() + y * DCT_SIZE, basis.data() + k * DCT_SIZE, DCT_SIZE);
+    }
+  }
+
+  float coefficients[HASH_SIZE * HASH_SIZE];
+  for (size_t v = 0; v < HASH_SIZE; v++) {
+    for (size_t u = 0; u < HASH_SIZE; u++) {
+      coefficients[v * HASH_SIZE + u] =
+        Simd::dot_f32(basis.data() + v * DCT_SIZE, partial.data() + u * DCT_SIZE, DCT_SIZE);
+    }
+  }
+
+  // One bit per coefficient, set when it is above the median
+  float sorted[HASH_SIZE * HASH_SIZE];
+  std::copy(std::begin(coefficients), std::end(coefficients), sorted);
+  std::sort(std::begin(sorted), std::end(sorted));
+  float median = (sorted[31] + sorted[32]) / 2.0f;
+
+  uint64_t result = 0;
+  for (float coefficient : coefficients) {
+    result = (result << 1) | (coefficient > median ? 1 : 0);
+  }
+  return result;
+}
+
+bool Fingerprinter::hash(GstBuffer *buffer, uint64_t &result) {
+  if (!configured || !luma.downscale(buffer, image.data())) {
+    return false;
+  }
+
+  if (algorithm == FingerprintAlgorithm::PHASH) {
+    resample(DCT_SIZE, DCT_SIZE);
+    result = dct_hash();
+  } else {
+    resample(DHASH_WIDTH, DHASH_HEIGHT);
+    result = difference_hash();
+  }
+  return true;
+}
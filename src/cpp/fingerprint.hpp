@@ -0,0 +1,36 @@
+#pragma once
+
+#include "luma.hpp"
+#include <gst/gst.h>
+#include <vector>
+
+enum class FingerprintAlgorithm { DHASH, PHASH };
+
+// 64-bit perceptual hash of the luma of raw video frames. Similar frames produce hashes
+// with a small Hamming distance. Not thread safe; driven from the streaming thread of a
+// single pad.
+class Fingerprinter {
+public:
+  explicit Fingerprinter(FingerprintAlgorithm algorithm);
+
+  // Returns false for formats the fingerprinter cannot read
+  bool configure(GstCaps *caps);
+  // Returns false if the frame could not be read
+  bool hash(GstBuffer *buffer, uint64_t &result);
+
+private:
+  // Area-average the downscaled luma to a width x height grid
+  void resample(size_t width, size_t height);
+  uint64_t difference_hash() const;
+  uint64_t dct_hash();
+
+  FingerprintAlgorithm algorithm;
+  bool configured = false;
+  LumaDownscaler luma;
+  std::vector<uint8_t> image;
+  std::vector<float> grid;
+
+  // pHash: the 8 lowest-frequency rows of a 32-point DCT-II and intermediate products
+  std::vector<float> basis;
+  std::vector<float> partial;
+};
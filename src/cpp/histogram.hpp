@@ -0,0 +1,126 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Log-linear (HDR-style) histogram of non-negative integer values.
+//
+// Values below 8 get their own bucket; above that every power of two is split into 8
+// linear sub-buckets, so any recorded value is reported within 12.5% of its true value
+// over the whole uint64 range. Recording is a handful of integer operations plus one
+// relaxed atomic increment, which makes it safe to call from streaming threads.
+class Histogram {
+public:
+  static constexpr int SUB_BUCKET_BITS = 3;
+  static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+  static constexpr int BUCKET_COUNT = SUB_BUCKETS + (64 - SUB_BUCKET_BITS) * SUB_BUCKETS;
+
+  void record(uint64_t value) {
+    buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(value, std::memory_order_relaxed);
+
+    uint64_t current = max_.load(std::memory_order_relaxed);
+    while (value > current
+           && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+    current = min_.load(std::memory_order_relaxed);
+    while (value < current
+           && !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+  uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+  uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+  uint64_t min() const { return count() ? min_.load(std::memory_order_relaxed) : 0; }
+
+  double mean() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(sum()) / static_cast<double>(n) : 0;
+  }
+
+  // Approximate value at the given percentile (0-100), reported as the bucket midpoint
+  double percentile(double p) const {
+    uint64_t n = count();
+    if (n == 0) {
+      return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(p / 100.0 * static_cast<double>(n) + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > n) rank = n;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+      seen += buckets[i].load(std::memory_order_relaxed);
+      if (seen >= rank) {
+        double low = static_cast<double>(bucket_lower_bound(i));
+        double high = static_cast<double>(bucket_upper_bound(i));
+        double mid = (low + high) / 2;
+        // Never report more than what was actually recorded
+        double top = static_cast<double>(max());
+        return mid > top ? top : mid;
+      }
+    }
+
+    return static_cast<double>(max());
+  }
+
+  void reset() {
+    for (auto &bucket : buckets) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+  }
+
+  static int bucket_index(uint64_t value) {
+    if (value < SUB_BUCKETS) {
+      return static_cast<int>(value);
+    }
+    int exponent = 63 - count_leading_zeros(value);
+    int sub = static_cast<int>((value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1));
+    return SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + sub;
+  }
+
+  static uint64_t bucket_lower_bound(int index) {
+    if (index < SUB_BUCKETS) {
+      return static_cast<uint64_t>(index);
+    }
+    int exponent = (index - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+    uint64_t sub = static_cast<uint64_t>((index - SUB_BUCKETS) % SUB_BUCKETS);
+    return (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+  }
+
+  static uint64_t bucket_upper_bound(int index) {
+    if (index < SUB_BUCKETS) {
+      return static_cast<uint64_t>(index);
+    }
+    int exponent = (index - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+    return bucket_lower_bound(index) + ((uint64_t{1} << (exponent - SUB_BUCKET_BITS)) - 1);
+  }
+
+private:
+  static int count_leading_zeros(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(value);
+#endif
+  }
+
+  std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> sum_{0};
+  std::atomic<uint64_t> max_{0};
+  std::atomic<uint64_t> min_{UINT64_MAX};
+};
@@ -0,0 +1,243 @@
+#include "keyframe-index.hpp"
+#include "async-workers.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+  constexpr char magic[4] = {'G', 'K', 'F', 'I'};
+  constexpr guint16 format_version = 1;
+  constexpr size_t header_size = 16;
+  constexpr size_t entry_size = 20;
+} // namespace
+
+void KeyframeIndexBuilder::set_segment(const GstSegment *new_segment) {
+  std::lock_guard<std::mutex> lock(mutex);
+  gst_segment_copy_into(new_segment, &segment);
+  has_segment = true;
+}
+
+void KeyframeIndexBuilder::push(GstBuffer *buffer) {
+  gsize size = gst_buffer_get_size(buffer);
+  guint64 offset = GST_BUFFER_OFFSET(buffer);
+  guint64 offset_end = GST_BUFFER_OFFSET_END(buffer);
+
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Raw video and audio use the offsets as frame or sample counters, only trust byte ranges
+  if (GST_BUFFER_OFFSET_IS_VALID(buffer) && GST_BUFFER_OFFSET_END_IS_VALID(buffer)
+      && offset_end - offset == size) {
+    position = offset;
+  }
+
+  GstClockTime time = GST_BUFFER_PTS_IS_VALID(buffer) ? GST_BUFFER_PTS(buffer)
+                                                      : GST_BUFFER_DTS(buffer);
+  bool keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT)
+                  && !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_HEADER);
+
+  if (keyframe && GST_CLOCK_TIME_IS_VALID(time)) {
+    if (has_segment && segment.format == GST_FORMAT_TIME) {
+      GstClockTime stream_time = gst_segment_to_stream_time(&segment, GST_FORMAT_TIME, time);
+      if (GST_CLOCK_TIME_IS_VALID(stream_time)) {
+        time = stream_time;
+      }
+    }
+    index.push_back({time, position, static_cast<guint32>(size)});
+  }
+
+  position += size;
+}
+
+void KeyframeIndexBuilder::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  index.clear();
+  position = 0;
+}
+
+std::vector<KeyframeEntry> KeyframeIndexBuilder::entries() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return index;
+}
+
+guint64 KeyframeIndexBuilder::bytes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return position;
+}
+
+namespace KeyframeIndex {
+  void Init(const Napi::Env &env, Napi::Object exports) {
+    exports.Set(
+      "loadKeyframeIndex", Napi::Function::New(env, load_keyframe_index, "loadKeyframeIndex")
+    );
+  }
+
+  size_t write_file(
+    const std::string &path, const std::vector<KeyframeEntry> &entries, std::string &error
+  ) {
+    std::vector<guint8> data(header_size + entries.size() * entry_size);
+    std::memcpy(data.data(), magic, sizeof(magic));
+    GST_WRITE_UINT16_LE(data.data() + 4, format_version);
+    GST_WRITE_UINT16_LE(data.data() + 6, entry_size);
+    GST_WRITE_UINT32_LE(data.data() + 8, static_cast<guint32>(entries.size()));
+    GST_WRITE_UINT32_LE(data.data() + 12, 0);
+
+    guint8 *record = data.data() + header_size;
+    for (const KeyframeEntry &entry : entries) {
+      GST_WRITE_UINT64_LE(record, entry.pts);
+      GST_WRITE_UINT64_LE(record + 8, entry.offset);
+      GST_WRITE_UINT32_LE(record + 16, entry.size);
+      record += entry_size;
+    }
+
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+      error = "Failed to open " + path + ": " + std::strerror(errno);
+      return 0;
+    }
+    size_t written = std::fwrite(data.data(), 1, data.size(), file);
+    if (std::fclose(file) != 0 || written != data.size()) {
+      error = "Failed to write " + path + ": " + std::strerror(errno);
+      return 0;
+    }
+    return written;
+  }
+
+  bool read_file(const std::string &path, std::vector<KeyframeEntry> &entries, std::string &error) {
+    FILE *file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+      error = "Failed to open " + path + ": " + std::strerror(errno);
+      return false;
+    }
+
+    guint8 header[header_size];
+    if (std::fread(header, 1, header_size, file) != header_size
+        || std::memcmp(header, magic, sizeof(magic)) != 0) {
+      std::fclose(file);
+      error = path + " is not a keyframe index";
+      return false;
+    }
+    if (GST_READ_UINT16_LE(header + 4) != format_version
+        || GST_READ_UINT16_LE(header + 6) != entry_size) {
+      std::fclose(file);
+      error = path + " has an unsupported keyframe index version";
+      return false;
+    }
+
+    // The count is checked against what the file holds before anything is allocated for it
+    long start = std::ftell(file);
+    long end = start >= 0 && std::fseek(file, 0, SEEK_END) == 0 ? std::ftell(file) : -1;
+    if (end < start || std::fseek(file, start, SEEK_SET) != 0) {
+      std::fclose(file);
+      error = "Failed to read " + path + ": " + std::strerror(errno);
+      return false;
+    }
+    guint32 count = GST_READ_UINT32_LE(header + 8);
+    if (static_cast<guint64>(count) * entry_size > static_cast<guint64>(end - start)) {
+      std::fclose(file);
+      error = path + " is truncated";
+      return false;
+    }
+
+    std::vector<guint8> data(static_cast<size_t>(count) * entry_size);
+    size_t read = std::fread(data.data(), 1, data.size(), file);
+    std::fclose(file);
+    if (read != data.size()) {
+      error = path + " is truncated";
+      return false;
+    }
+
+    entries.clear();
+    entries.reserve(count);
+    for (const guint8 *record = data.data(); record < data.data() + data.size();
+         record += entry_size) {
+      entries.push_back(
+        {GST_READ_UINT64_LE(record), GST_READ_UINT64_LE(record + 8),
+         GST_READ_UINT32_LE(record + 16)}
+      );
+    }
+    return true;
+  }
+
+  Napi::Object to_js(const Napi::Env &env, const std::vector<KeyframeEntry> &entries) {
+    Napi::Float64Array pts = Napi::Float64Array::New(env, entries.size());
+    Napi::Float64Array offsets = Napi::Float64Array::New(env, entries.size());
+    Napi::Uint32Array sizes = Napi::Uint32Array::New(env, entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+      pts[i] = static_cast<double>(entries[i].pts) / GST_SECOND;
+      offsets[i] = static_cast<double>(entries[i].offset);
+      sizes[i] = entries[i].size;
+    }
+
+    Napi::Object index = Napi::Object::New(env);
+    index.Set("count", Napi::Number::New(env, static_cast<double>(entries.size())));
+    index.Set("pts", pts);
+    index.Set("offsets", offsets);
+    index.Set("sizes", sizes);
+    return index;
+  }
+
+  bool lookup(const Napi::Value &index, double seconds, KeyframeEntry &entry, std::string &error) {
+    auto is_array = [](const Napi::Value &value, napi_typedarray_type type) {
+      return value.IsTypedArray() && value.As<Napi::TypedArray>().TypedArrayType() == type;
+    };
+
+    if (!index.IsObject()) {
+      error = "index must be a keyframe index";
+      return false;
+    }
+    Napi::Object object = index.As<Napi::Object>();
+    if (!is_array(object.Get("pts"), napi_float64_array)
+        || !is_array(object.Get("offsets"), napi_float64_array)
+        || !is_array(object.Get("sizes"), napi_uint32_array)) {
+      error = "index must be a keyframe index";
+      return false;
+    }
+
+    Napi::Float64Array pts = object.Get("pts").As<Napi::Float64Array>();
+    Napi::Float64Array offsets = object.Get("offsets").As<Napi::Float64Array>();
+    Napi::Uint32Array sizes = object.Get("sizes").As<Napi::Uint32Array>();
+    size_t count = pts.ElementLength();
+    if (offsets.ElementLength() != count || sizes.ElementLength() != count) {
+      error = "index arrays differ in length";
+      return false;
+    }
+    if (count == 0) {
+      return false;
+    }
+
+    // Index of the first keyframe after the position, the one before it is the seek target
+    const double *times = pts.Data();
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+      size_t middle = low + (high - low) / 2;
+      if (times[middle] <= seconds) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    size_t found = low > 0 ? low - 1 : 0;
+
+    entry.pts = static_cast<GstClockTime>(times[found] * GST_SECOND + 0.5);
+    entry.offset = static_cast<guint64>(offsets[found]);
+    entry.size = sizes[found];
+    return true;
+  }
+
+  Napi::Value load_keyframe_index(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    if (info.Length() < 1 || !info[0].IsString()) {
+      Napi::TypeError::New(env, "loadKeyframeIndex() requires a file path")
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    KeyframeIndexLoadWorker *worker =
+      new KeyframeIndexLoadWorker(env, info[0].As<Napi::String>().Utf8Value());
+    Napi::Promise promise = worker->GetPromise().Promise();
+    worker->Queue();
+    return promise;
+  }
+} // namespace KeyframeIndex
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <mutex>
+#include <napi.h>
+#include <string>
+#include <vector>
+
+struct KeyframeEntry {
+  GstClockTime pts; // Stream time
+  guint64 offset;   // Byte position in the recorded stream
+  guint32 size;     // Size of the keyframe buffer
+};
+
+// Collects the position of every keyframe (buffer without GST_BUFFER_FLAG_DELTA_UNIT or
+// GST_BUFFER_FLAG_HEADER) passing a pad. Buffers carrying byte offsets, i.e. OFFSET_END - OFFSET
+// equals their size, are placed at that offset, everything else at the running byte count.
+// Pushed from a streaming thread, read from any other.
+class KeyframeIndexBuilder {
+public:
+  void set_segment(const GstSegment *segment);
+  void push(GstBuffer *buffer);
+  void clear();
+
+  std::vector<KeyframeEntry> entries();
+  guint64 bytes();
+
+private:
+  std::mutex mutex;
+  std::vector<KeyframeEntry> index;
+  GstSegment segment{};
+  bool has_segment = false;
+  guint64 position = 0;
+};
+
+// Sidecar files and JS representation of keyframe indexes
+namespace KeyframeIndex {
+  void Init(const Napi::Env &env, Napi::Object exports);
+
+  /**
+   * Write entries in the "GKFI" format: a 16 byte header (magic, version, entry size, count)
+   * followed by one little-endian pts/offset/size record of 20 bytes per keyframe
+   * @return Bytes written, 0 with error set on failure
+   */
+  size_t write_file(
+    const std::string &path, const std::vector<KeyframeEntry> &entries, std::string &error
+  );
+
+  /**
+   * Read a file written by write_file()
+   * @return true on success, false with error set otherwise
+   */
+  bool read_file(const std::string &path, std::vector<KeyframeEntry> &entries, std::string &error);
+
+  /**
+   * Convert entries to { count, pts, offsets, sizes } with one typed array per field
+   */
+  Napi::Object to_js(const Napi::Env &env, const std::vector<KeyframeEntry> &entries);
+
+  /**
+   * Find the last keyframe at or before a position, or the first one when the position is
+   * before the start of the index. Binary search over the typed arrays of a to_js() object.
+   * @param index The index object
+   * @param seconds The position in stream time
+   * @param entry Filled with the keyframe found
+   * @param error Set when the value is not an index object
+   * @return true when a keyframe was found, false for an empty index or on error
+   */
+  bool lookup(const Napi::Value &index, double seconds, KeyframeEntry &entry, std::string &error);
+
+  Napi::Value load_keyframe_index(const Napi::CallbackInfo &info);
+} // namespace KeyframeIndex
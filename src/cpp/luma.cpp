@@ -0,0 +1,76 @@
+#include "luma.hpp"
+#include "simd.hpp"
+#include <algorithm>
+
+bool LumaDownscaler::configure(const GstVideoInfo &video_info, size_t scale) {
+  info = video_info;
+  const GstVideoFormatInfo *format = info.finfo;
+  if (!format || GST_VIDEO_FORMAT_INFO_DEPTH(format, 0) != 8) {
+    return false;
+  }
+
+  if ((GST_VIDEO_FORMAT_INFO_IS_YUV(format) || GST_VIDEO_FORMAT_INFO_IS_GRAY(format))
+      && GST_VIDEO_FORMAT_INFO_PSTRIDE(format, 0) == 1) {
+    rgb = false;
+  } else if (GST_VIDEO_FORMAT_INFO_IS_RGB(format)
+             && GST_VIDEO_FORMAT_INFO_PSTRIDE(format, 0) == 4) {
+    rgb = true;
+    r_offset = GST_VIDEO_FORMAT_INFO_POFFSET(format, 0);
+    g_offset = GST_VIDEO_FORMAT_INFO_POFFSET(format, 1);
+    b_offset = GST_VIDEO_FORMAT_INFO_POFFSET(format, 2);
+  } else {
+    return false;
+  }
+
+  // 255 * factor has to fit the 16-bit column sums
+  factor = std::clamp<size_t>(scale, 1, 257);
+  out_width = static_cast<size_t>(GST_VIDEO_INFO_WIDTH(&info)) / factor;
+  out_height = static_cast<size_t>(GST_VIDEO_INFO_HEIGHT(&info)) / factor;
+
+  sums.assign(out_width * factor, 0);
+  luma_row.assign(rgb ? out_width * factor : 0, 0);
+  return out_width > 0 && out_height > 0;
+}
+
+bool LumaDownscaler::downscale(GstBuffer *buffer, uint8_t *out) {
+  GstVideoFrame frame;
+  if (!gst_video_frame_map(&frame, &info, buffer, GST_MAP_READ)) {
+    return false;
+  }
+
+  const uint8_t *plane = static_cast<const uint8_t *>(GST_VIDEO_FRAME_PLANE_DATA(&frame, 0));
+  size_t stride = static_cast<size_t>(GST_VIDEO_FRAME_PLANE_STRIDE(&frame, 0));
+  size_t used_width = out_width * factor;
+  size_t area = factor * factor;
+
+  for (size_t y = 0; y < out_height; y++) {
+    // Sum `factor` source rows column-wise, then each run of `factor` columns
+    std::fill(sums.begin(), sums.end(), 0);
+    for (size_t r = 0; r < factor; r++) {
+      const uint8_t *row = plane + (y * factor + r) * stride;
+      if (rgb) {
+        // BT.601 luma in 8-bit fixed point, simple enough for the compiler to vectorize
+        for (size_t x = 0; x < used_width; x++) {
+          const uint8_t *pixel = row + x * 4;
+          luma_row[x] = static_cast<uint8_t>(
+            (pixel[r_offset] * 77 + pixel[g_offset] * 150 + pixel[b_offset] * 29) >> 8
+          );
+        }
+        row = luma_row.data();
+      }
+      Simd::accumulate_u8(row, sums.data(), used_width);
+    }
+
+    uint8_t *out_row = out + y * out_width;
+    for (size_t x = 0; x < out_width; x++) {
+      uint32_t sum = 0;
+      for (size_t c = 0; c < factor; c++) {
+        sum += sums[x * factor + c];
+      }
+      out_row[x] = static_cast<uint8_t>(sum / area);
+    }
+  }
+
+  gst_video_frame_unmap(&frame);
+  return true;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <vector>
+
+// Box-downscaled luma of raw video frames, the common input of the frame analyzers.
+// Reads the Y plane of 8-bit planar/semi-planar YUV and GRAY8 directly and derives luma
+// from packed 32-bit RGB.
+class LumaDownscaler {
+public:
+  // Returns false for other formats, or frames smaller than one output pixel
+  bool configure(const GstVideoInfo &info, size_t factor);
+  // Writes width() * height() pixels to out, returns false if the frame cannot be mapped
+  bool downscale(GstBuffer *buffer, uint8_t *out);
+
+  size_t width() const { return out_width; }
+  size_t height() const { return out_height; }
+
+private:
+  GstVideoInfo info;
+  bool rgb = false;
+  size_t r_offset = 0, g_offset = 0, b_offset = 0;
+  size_t factor = 1, out_width = 0, out_height = 0;
+
+  // Scratch space reused between frames
+  std::vector<uint16_t> sums;
+  std::vector<uint8_t> luma_row;
+};
@@ -0,0 +1,135 @@
+#include "memory-source.hpp"
+#include <algorithm>
+#include <mutex>
+
+// Keeps the JS object alive while GStreamer memory points into it. The last buffer can be
+// freed on any thread, but a reference can only be dropped on the JS thread.
+struct PinnedMemory {
+  Napi::Reference<Napi::Object> object;
+  Napi::ThreadSafeFunction release;
+};
+
+static void unpin_memory(gpointer data) {
+  PinnedMemory *pinned = static_cast<PinnedMemory *>(data);
+  Napi::ThreadSafeFunction release = pinned->release;
+  napi_status status = release.NonBlockingCall([pinned](Napi::Env, Napi::Function) {
+    delete pinned;
+  });
+  // While the environment shuts down the object goes away with it
+  if (status != napi_ok) {
+    pinned->object.SuppressDestruct();
+    delete pinned;
+  }
+  release.Release();
+}
+
+// State of one app source, owned by its callbacks
+struct MemorySourceContext {
+  GstBuffer *memory;
+  gsize size;
+  guint block_size;
+  std::mutex mutex;
+  guint64 position = 0;
+
+  MemorySourceContext(GstBuffer *memory, guint block_size) :
+      memory(memory), size(gst_buffer_get_size(memory)), block_size(block_size) {}
+  ~MemorySourceContext() { gst_buffer_unref(memory); }
+};
+
+static void memory_need_data(GstAppSrc *app_src, guint length, gpointer user_data) {
+  MemorySourceContext *context = static_cast<MemorySourceContext *>(user_data);
+
+  GstBuffer *buffer = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(context->mutex);
+    if (context->position < context->size) {
+      // Random-access sources are asked for an exact size, (guint)-1 when there is none
+      gsize remaining = context->size - context->position;
+      gsize wanted = length == G_MAXUINT || length == 0 ? context->block_size : length;
+      gsize chunk = std::min<gsize>(wanted, remaining);
+
+      // Shares the wrapped memory, only the view is new
+      buffer =
+        gst_buffer_copy_region(context->memory, GST_BUFFER_COPY_MEMORY, context->position, chunk);
+      GST_BUFFER_OFFSET(buffer) = context->position;
+      GST_BUFFER_OFFSET_END(buffer) = context->position + chunk;
+      context->position += chunk;
+    }
+  }
+
+  if (buffer) {
+    gst_app_src_push_buffer(app_src, buffer);
+  } else {
+    gst_app_src_end_of_stream(app_src);
+  }
+}
+
+static gboolean memory_seek_data(GstAppSrc *, guint64 offset, gpointer user_data) {
+  MemorySourceContext *context = static_cast<MemorySourceContext *>(user_data);
+
+  std::lock_guard<std::mutex> lock(context->mutex);
+  if (offset > context->size) {
+    return FALSE;
+  }
+  context->position = offset;
+  return TRUE;
+}
+
+namespace MemorySource {
+  GstBuffer *wrap(const Napi::Env &env, const Napi::Object &owner, uint8_t *data, gsize size) {
+    PinnedMemory *pinned = new PinnedMemory();
+    pinned->object = Napi::Persistent(owner);
+    pinned->release = Napi::ThreadSafeFunction::New(
+      env, Napi::Function::New(env, [](const Napi::CallbackInfo &) {}), "MemorySource", 0, 1
+    );
+    // Unpinning must not keep the process alive
+    pinned->release.Unref(env);
+
+    return gst_buffer_new_wrapped_full(
+      GST_MEMORY_FLAG_READONLY, data, size, 0, size, pinned, unpin_memory
+    );
+  }
+
+  bool attach(
+    const Napi::Env &env, GstAppSrc *app_src, const Napi::Value &data,
+    const MemorySourceOptions &options, std::string &error
+  ) {
+    uint8_t *bytes = nullptr;
+    size_t size = 0;
+    if (data.IsTypedArray()) {
+      Napi::TypedArray view = data.As<Napi::TypedArray>();
+      bytes = static_cast<uint8_t *>(view.ArrayBuffer().Data()) + view.ByteOffset();
+      size = view.ByteLength();
+    } else if (data.IsArrayBuffer()) {
+      Napi::ArrayBuffer array_buffer = data.As<Napi::ArrayBuffer>();
+      bytes = static_cast<uint8_t *>(array_buffer.Data());
+      size = array_buffer.ByteLength();
+    } else {
+      error = "setMemorySource() requires a Buffer, typed array or ArrayBuffer";
+      return false;
+    }
+    if (size == 0) {
+      error = "setMemorySource() requires a non-empty buffer";
+      return false;
+    }
+
+    GstBuffer *memory = wrap(env, data.As<Napi::Object>(), bytes, size);
+
+    g_object_set(
+      app_src, "stream-type", GST_APP_STREAM_TYPE_RANDOM_ACCESS, "format", GST_FORMAT_BYTES,
+      "size", static_cast<gint64>(size), "blocksize", options.block_size, nullptr
+    );
+    if (options.caps) {
+      gst_app_src_set_caps(app_src, options.caps);
+    }
+
+    GstAppSrcCallbacks callbacks = {};
+    callbacks.need_data = memory_need_data;
+    callbacks.seek_data = memory_seek_data;
+    gst_app_src_set_callbacks(
+      app_src, &callbacks, new MemorySourceContext(memory, options.block_size),
+      [](gpointer data) { delete static_cast<MemorySourceContext *>(data); }
+    );
+    return true;
+  }
+} // namespace MemorySource
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <gst/app/gstappsrc.h>
+#include <gst/gst.h>
+#include <napi.h>
+#include <string>
+
+struct MemorySourceOptions {
+  // Bytes per buffer when pushing, demuxers pulling from the source ask for their own sizes
+  guint block_size = 64 * 1024;
+  GstCaps *caps = nullptr; // Borrowed, may be nullptr to let downstream typefind
+};
+
+// Serves a block of JS memory from an app source in random-access mode
+namespace MemorySource {
+  /**
+   * Wrap JS memory in a read-only buffer without copying. The owner is pinned until the buffer
+   * and every buffer sharing its memory are freed, on whichever thread that happens.
+   * @param env The environment of the caller, must be called on the JS thread
+   * @param owner The Buffer, typed array or ArrayBuffer the memory belongs to
+   * @param data Start of the memory
+   * @param size Length of the memory in bytes
+   * @return A new buffer
+   */
+  GstBuffer *wrap(const Napi::Env &env, const Napi::Object &owner, uint8_t *data, gsize size);
+
+  /**
+   * Switch an app source to GST_APP_STREAM_TYPE_RANDOM_ACCESS and answer its need-data and
+   * seek-data signals natively with read-only sub-buffers of the memory, without copying.
+   * The JS object is pinned until the app source and every buffer sliced from it are gone.
+   * @param env The environment of the caller
+   * @param app_src The app source, replaces any memory served before
+   * @param data A Buffer, typed array or ArrayBuffer
+   * @param options Block size and caps
+   * @param error Set when the data is not usable
+   * @return true on success
+   */
+  bool attach(
+    const Napi::Env &env, GstAppSrc *app_src, const Napi::Value &data,
+    const MemorySourceOptions &options, std::string &error
+  );
+} // namespace MemorySource
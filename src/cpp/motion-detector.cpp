@@ -0,0 +1,112 @@
+#include "motion-detector.hpp"
+#include "simd.hpp"
+#include <algorithm>
+
+// Luma histogram resolution used for scene cut detection
+static const size_t HISTOGRAM_BINS = 64;
+
+MotionDetector::MotionDetector(const MotionOptions &options) : options(options) {}
+
+bool MotionDetector::configure(GstCaps *caps) {
+  configured = false;
+
+  GstVideoInfo info;
+  if (!caps || !gst_video_info_from_caps(&info, caps)) {
+    return false;
+  }
+  size_t factor = static_cast<size_t>(GST_VIDEO_INFO_WIDTH(&info)) / options.analysis_width;
+  if (!luma.configure(info, factor)) {
+    return false;
+  }
+
+  width = luma.width();
+  height = luma.height();
+  block_size = std::min({options.block_size, width, height});
+  columns = width / block_size;
+  rows = height / block_size;
+
+  current.assign(width * height, 0);
+  previous.assign(width * height, 0);
+  histogram.assign(HISTOGRAM_BINS, 0);
+  previous_histogram.assign(HISTOGRAM_BINS, 0);
+
+  configured = true;
+  reset();
+  return true;
+}
+
+void MotionDetector::reset() {
+  has_previous = false;
+  in_motion = false;
+}
+
+std::vector<MotionEvent> MotionDetector::process(GstBuffer *buffer) {
+  std::vector<MotionEvent> events;
+  if (!configured || !luma.downscale(buffer, current.data())) {
+    return events;
+  }
+
+  GstClockTime pts = GST_BUFFER_PTS(buffer);
+  // Without timestamps the hold time falls back to the monotonic clock
+  GstClockTime now = GST_CLOCK_TIME_IS_VALID(pts) ? pts : g_get_monotonic_time() * GST_USECOND;
+
+  std::fill(histogram.begin(), histogram.end(), 0);
+  for (uint8_t value : current) {
+    histogram[value * HISTOGRAM_BINS / 256]++;
+  }
+
+  if (has_previous) {
+    size_t pixels = width * height;
+    double difference =
+      static_cast<double>(Simd::sad_u8(current.data(), previous.data(), pixels)) / (255.0 * pixels);
+
+    // Half the L1 distance of the normalized histograms, 0 for identical and 1 for disjoint
+    uint64_t histogram_distance = 0;
+    for (size_t i = 0; i < HISTOGRAM_BINS; i++) {
+      histogram_distance += histogram[i] > previous_histogram[i]
+                              ? histogram[i] - previous_histogram[i]
+                              : previous_histogram[i] - histogram[i];
+    }
+    double scene_score = static_cast<double>(histogram_distance) / (2.0 * pixels);
+
+    if (scene_score >= options.scene_threshold) {
+      events.push_back({MotionEvent::SCENE_CHANGE, pts, scene_score, difference, {}, 0, 0});
+    }
+
+    std::vector<uint8_t> mask(columns * rows, 0);
+    size_t moving = 0;
+    double block_limit = options.pixel_threshold * 255.0 * block_size * block_size;
+    for (size_t by = 0; by < rows; by++) {
+      for (size_t bx = 0; bx < columns; bx++) {
+        uint64_t sad = 0;
+        for (size_t line = 0; line < block_size; line++) {
+          size_t offset = (by * block_size + line) * width + bx * block_size;
+          sad += Simd::sad_u8(current.data() + offset, previous.data() + offset, block_size);
+        }
+        if (static_cast<double>(sad) >= block_limit) {
+          mask[by * columns + bx] = 1;
+          moving++;
+        }
+      }
+    }
+    double motion_score = static_cast<double>(moving) / static_cast<double>(columns * rows);
+
+    if (motion_score >= options.motion_threshold) {
+      last_motion = now;
+      if (!in_motion) {
+        in_motion = true;
+        events.push_back(
+          {MotionEvent::MOTION_START, pts, motion_score, difference, std::move(mask), columns, rows}
+        );
+      }
+    } else if (in_motion && now >= last_motion + options.hold) {
+      in_motion = false;
+      events.push_back({MotionEvent::MOTION_END, pts, motion_score, difference, {}, 0, 0});
+    }
+  }
+
+  std::swap(current, previous);
+  std::swap(histogram, previous_histogram);
+  has_previous = true;
+  return events;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "luma.hpp"
+#include <gst/gst.h>
+#include <vector>
+
+struct MotionOptions {
+  // Frames are box-downscaled to about this width before analysis
+  size_t analysis_width = 160;
+  // Block edge in analysis pixels for the motion mask
+  size_t block_size = 8;
+  // Mean luma difference (0-1) at which a block counts as moving
+  double pixel_threshold = 0.06;
+  // Fraction of moving blocks that starts a motion event
+  double motion_threshold = 0.02;
+  // Luma histogram distance (0-1) that counts as a scene cut
+  double scene_threshold = 0.5;
+  // Quiet time before a motion event ends
+  GstClockTime hold = GST_SECOND;
+};
+
+struct MotionEvent {
+  enum Type { MOTION_START, MOTION_END, SCENE_CHANGE };
+
+  Type type;
+  GstClockTime pts;
+  // Fraction of moving blocks, or the histogram distance for scene changes
+  double score;
+  // Mean luma difference to the previous frame (0-1)
+  double difference;
+  // One byte per block in row-major order, 1 for moving blocks (motion start only)
+  std::vector<uint8_t> mask;
+  size_t columns = 0, rows = 0;
+};
+
+// Frame differencing on the downscaled luma of raw video. Not thread safe; driven from the
+// streaming thread of a single pad.
+class MotionDetector {
+public:
+  explicit MotionDetector(const MotionOptions &options);
+
+  // Returns false for formats the detector cannot read
+  bool configure(GstCaps *caps);
+  // Returns the events triggered by this frame, usually none
+  std::vector<MotionEvent> process(GstBuffer *buffer);
+  // Forget the previous frame, e.g. after a flush
+  void reset();
+
+private:
+  MotionOptions options;
+  bool configured = false;
+  LumaDownscaler luma;
+
+  // Analysis image geometry
+  size_t width = 0, height = 0;
+  size_t block_size = 0, columns = 0, rows = 0;
+
+  std::vector<uint8_t> current, previous;
+  std::vector<uint32_t> histogram, previous_histogram;
+  bool has_previous = false;
+
+  bool in_motion = false;
+  GstClockTime last_motion = 0;
+};
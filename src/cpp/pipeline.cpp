@@ -1,6 +1,7 @@
 #include "pipeline.hpp"
 #include "async-workers.hpp"
 #include "element.hpp"
+#include "keyframe-index.hpp"
 #include <gst/gst.h>
 #include <gst/video/video.h>
 
@@ -22,8 +23,206 @@ Napi::Object Pipeline::Init(const Napi::Env &env, const Napi::Object &exports) {
   return exports;
 }
 
+// Turn off clock synchronisation and QoS on a sink so it consumes buffers as fast as
+// upstream produces them
+static void disable_sink_sync(GstElement *element) {
+  if (GST_IS_BIN(element) || !GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK)) {
+    return;
+  }
+
+  GObjectClass *klass = G_OBJECT_GET_CLASS(element);
+  if (g_object_class_find_property(klass, "sync")) {
+    g_object_set(element, "sync", FALSE, NULL);
+  }
+  if (g_object_class_find_property(klass, "qos")) {
+    g_object_set(element, "qos", FALSE, NULL);
+  }
+}
+
+void Pipeline::configure_offline(GstPipeline *pipeline) {
+  GstIterator *it = gst_bin_iterate_recurse(GST_BIN(pipeline));
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK:
+        disable_sink_sync(GST_ELEMENT(g_value_get_object(&item)));
+        g_value_reset(&item);
+        break;
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync(it);
+        break;
+      default:
+        done = true;
+        break;
+    }
+  }
+
+  g_value_unset(&item);
+  gst_iterator_free(it);
+
+  // Sinks created later (autovideosink, decodebin, playbin) are configured as they appear
+  g_signal_connect(
+    pipeline, "deep-element-added",
+    G_CALLBACK(+[](GstBin *, GstBin *, GstElement *element, gpointer) {
+      disable_sink_sync(element);
+    }),
+    nullptr
+  );
+
+  // Without a clock nothing in the pipeline waits, including elements that sync on their own
+  gst_pipeline_use_clock(pipeline, nullptr);
+}
+
+BusSyncState::~BusSyncState() {
+  if (task_pool) {
+    gst_task_pool_cleanup(task_pool);
+    gst_object_unref(task_pool);
+  }
+}
+
+GstTaskPool *BusSyncState::acquire_task_pool() {
+  if (!task_pool) {
+    task_pool = gst_task_pool_new();
+  }
+  if (!task_pool_prepared) {
+    GError *error = nullptr;
+    gst_task_pool_prepare(task_pool, &error);
+    if (error) {
+      g_error_free(error);
+      return nullptr;
+    }
+    task_pool_prepared = true;
+  }
+  return task_pool;
+}
+
+void BusSyncState::release_task_pool() {
+  GstTaskPool *pool = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (task_pool && task_pool_prepared) {
+      pool = GST_TASK_POOL(gst_object_ref(task_pool));
+      task_pool_prepared = false;
+    }
+  }
+  if (pool) {
+    // Joins the pool threads, which must not wait for the mutex in the meantime
+    gst_task_pool_cleanup(pool);
+    gst_object_unref(pool);
+  }
+}
+
+GstBusSyncReply
+Pipeline::bus_sync_handler(GstBus *bus, GstMessage *message, gpointer user_data) {
+  BusSyncState *state = static_cast<std::shared_ptr<BusSyncState> *>(user_data)->get();
+
+  switch (GST_MESSAGE_TYPE(message)) {
+    case GST_MESSAGE_STATE_CHANGED: {
+      // Only the pipeline's own transitions matter for wall-clock accounting
+      if (!GST_IS_PIPELINE(GST_MESSAGE_SRC(message))) {
+        break;
+      }
+      GstState old_state, new_state;
+      gst_message_parse_state_changed(message, &old_state, &new_state, nullptr);
+
+      // Every task has been joined on the way down, so the pool threads are idle. The move to
+      // NULL can't be used, its message is dropped by the then flushing bus.
+      if (old_state == GST_STATE_PAUSED && new_state == GST_STATE_READY) {
+        state->release_task_pool();
+      }
+
+      std::lock_guard<std::mutex> lock(state->mutex);
+      gint64 now = g_get_monotonic_time();
+      if (old_state == GST_STATE_READY && new_state == GST_STATE_PAUSED) {
+        // A new run starts
+        state->playing_since_us = -1;
+        state->playing_total_us = 0;
+        state->finished = false;
+      } else if (new_state == GST_STATE_PLAYING && state->playing_since_us < 0) {
+        state->playing_since_us = now;
+      } else if (old_state == GST_STATE_PLAYING && state->playing_since_us >= 0) {
+        state->playing_total_us += now - state->playing_since_us;
+        state->playing_since_us = -1;
+      }
+      break;
+    }
+    case GST_MESSAGE_EOS: {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (state->playing_since_us >= 0) {
+        state->playing_total_us += g_get_monotonic_time() - state->playing_since_us;
+        state->playing_since_us = -1;
+      }
+      state->finished = true;
+      break;
+    }
+    case GST_MESSAGE_STREAM_STATUS: {
+      // ENTER and LEAVE are posted from the streaming thread itself, so the thread can be
+      // configured right here before it starts pushing data
+      GstStreamStatusType type;
+      GstElement *owner;
+      gst_message_parse_stream_status(message, &type, &owner);
+      if (!ThreadControl::supported()) {
+        break;
+      }
+
+      if (type == GST_STREAM_STATUS_TYPE_CREATE) {
+        // Posted before the task gets a thread. Giving it the pipeline's own pool keeps
+        // threads configured by a policy from later running tasks of other pipelines.
+        const GValue *object = gst_message_get_stream_status_object(message);
+        if (object && G_VALUE_HOLDS_OBJECT(object) && GST_IS_TASK(g_value_get_object(object))) {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          if (GstTaskPool *pool = state->acquire_task_pool()) {
+            gst_task_set_pool(GST_TASK(g_value_get_object(object)), pool);
+          }
+        }
+        break;
+      }
+      if (type != GST_STREAM_STATUS_TYPE_ENTER && type != GST_STREAM_STATUS_TYPE_LEAVE) {
+        break;
+      }
+
+      long tid = ThreadControl::current_thread_id();
+      if (type == GST_STREAM_STATUS_TYPE_LEAVE) {
+        // The thread goes back to the pipeline's task pool
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->threads.erase(tid);
+        break;
+      }
+
+      ThreadAssignment assignment;
+      assignment.tid = tid;
+      assignment.element = GST_OBJECT_NAME(owner);
+      if (GST_IS_PAD(GST_MESSAGE_SRC(message))) {
+        assignment.pad = GST_OBJECT_NAME(GST_MESSAGE_SRC(message));
+      }
+
+      std::shared_ptr<const ThreadPolicySet> policy;
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        policy = state->thread_policy;
+      }
+      if (policy) {
+        assignment.errors =
+          ThreadControl::apply(tid, policy->for_element(assignment.element), assignment.element);
+      }
+
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->threads[tid] = assignment;
+      break;
+    }
+    default:
+      break;
+  }
+
+  // Messages always continue to the bus so busPop() sees them
+  return GST_BUS_PASS;
+}
+
 Pipeline::Pipeline(const Napi::CallbackInfo &info) :
-    Napi::ObjectWrap<Pipeline>(info), pipeline(nullptr, gst_object_unref) {
+    Napi::ObjectWrap<Pipeline>(info), pipeline(nullptr, gst_object_unref),
+    bus_state(std::make_shared<BusSyncState>()) {
   ensure_gst_initialized();
   Napi::Env env = info.Env();
   GError *err = NULL;
@@ -42,6 +241,23 @@ Pipeline::Pipeline(const Napi::CallbackInfo &info) :
 
   pipeline.reset(raw_pipeline);
 
+  if (pipeline) {
+    GstBus *bus = gst_pipeline_get_bus(pipeline.get());
+    gst_bus_set_sync_handler(
+      bus, Pipeline::bus_sync_handler, new std::shared_ptr<BusSyncState>(bus_state),
+      [](gpointer data) { delete static_cast<std::shared_ptr<BusSyncState> *>(data); }
+    );
+    gst_object_unref(bus);
+
+    if (info.Length() > 1 && info[1].IsObject()) {
+      Napi::Object options = info[1].As<Napi::Object>();
+      Napi::Value offline = options.Get("offline");
+      if (offline.IsBoolean() && offline.As<Napi::Boolean>().Value()) {
+        configure_offline(pipeline.get());
+      }
+    }
+  }
+
   // Set methods as enumerable instance properties to make them visible in console.log
   Napi::Object thisObj = info.This().As<Napi::Object>();
 
@@ -89,6 +305,64 @@ Pipeline::Pipeline(const Napi::CallbackInfo &info) :
     [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->end_of_stream(info); },
     "endOfStream"
   );
+  auto get_throughput_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->get_throughput(info); },
+    "getThroughput"
+  );
+  auto add_bin_method = Napi::Function::New(
+    env, [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->add_bin(info); },
+    "addBin"
+  );
+  auto link_method = Napi::Function::New(
+    env, [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->link(info); }, "link"
+  );
+  auto unlink_method = Napi::Function::New(
+    env, [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->unlink(info); },
+    "unlink"
+  );
+  auto remove_element_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->remove_element(info); },
+    "removeElement"
+  );
+  auto enable_tracers_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->enable_tracers(info); },
+    "enableTracers"
+  );
+  auto get_tracer_stats_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->get_tracer_stats(info); },
+    "getTracerStats"
+  );
+  auto disable_tracers_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->disable_tracers(info); },
+    "disableTracers"
+  );
+  auto start_profiler_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->start_profiler(info); },
+    "startProfiler"
+  );
+  auto monitor_queues_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->monitor_queues(info); },
+    "monitorQueues"
+  );
+  auto set_thread_policy_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value { return this->set_thread_policy(info); },
+    "setThreadPolicy"
+  );
+  auto get_thread_assignments_method = Napi::Function::New(
+    env,
+    [this](const Napi::CallbackInfo &info) -> Napi::Value {
+      return this->get_thread_assignments(info);
+    },
+    "getThreadAssignments"
+  );
 
   thisObj.DefineProperties(
     {Napi::PropertyDescriptor::Value("play", play_method, napi_enumerable),
@@ -102,7 +376,21 @@ Pipeline::Pipeline(const Napi::CallbackInfo &info) :
      Napi::PropertyDescriptor::Value("queryDuration", queryDuration_method, napi_enumerable),
      Napi::PropertyDescriptor::Value("busPop", busPop_method, napi_enumerable),
      Napi::PropertyDescriptor::Value("seek", seek_method, napi_enumerable),
-     Napi::PropertyDescriptor::Value("endOfStream", end_of_stream_method, napi_enumerable)}
+     Napi::PropertyDescriptor::Value("endOfStream", end_of_stream_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("getThroughput", get_throughput_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("addBin", add_bin_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("link", link_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("unlink", unlink_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("removeElement", remove_element_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("enableTracers", enable_tracers_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("getTracerStats", get_tracer_stats_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("disableTracers", disable_tracers_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("startProfiler", start_profiler_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("monitorQueues", monitor_queues_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value("setThreadPolicy", set_thread_policy_method, napi_enumerable),
+     Napi::PropertyDescriptor::Value(
+       "getThreadAssignments", get_thread_assignments_method, napi_enumerable
+     )}
   );
 }
 
@@ -263,6 +551,40 @@ Napi::Value Pipeline::seek(const Napi::CallbackInfo &info) {
   // Convert seconds to nanoseconds
   GstClockTime position_ns = static_cast<GstClockTime>(position_seconds * GST_SECOND);
 
+  // With a keyframe index, land exactly on the keyframe at or before the position
+  if (info.Length() > 1 && info[1].IsObject()
+      && !info[1].As<Napi::Object>().Get("index").IsUndefined()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+
+    bool bytes = false;
+    if (options.Get("format").IsString()) {
+      std::string format = options.Get("format").As<Napi::String>().Utf8Value();
+      if (format != "time" && format != "bytes") {
+        Napi::TypeError::New(env, "format must be \"time\" or \"bytes\"")
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      bytes = format == "bytes";
+    }
+
+    KeyframeEntry keyframe;
+    std::string error;
+    if (!KeyframeIndex::lookup(options.Get("index"), position_seconds, keyframe, error)) {
+      if (!error.empty()) {
+        Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+      return Napi::Boolean::New(env, false);
+    }
+
+    gboolean result = gst_element_seek(
+      GST_ELEMENT(pipeline.get()), 1.0, bytes ? GST_FORMAT_BYTES : GST_FORMAT_TIME,
+      static_cast<GstSeekFlags>(GST_SEEK_FLAG_FLUSH | GST_SEEK_FLAG_ACCURATE), GST_SEEK_TYPE_SET,
+      bytes ? keyframe.offset : keyframe.pts, GST_SEEK_TYPE_NONE, GST_CLOCK_TIME_NONE
+    );
+    return Napi::Boolean::New(env, result);
+  }
+
   // Perform the seek
   gboolean result = gst_element_seek(
     GST_ELEMENT(pipeline.get()),
@@ -300,6 +622,391 @@ Napi::Value Pipeline::end_of_stream(const Napi::CallbackInfo &info) {
   return Napi::Boolean::New(env, result);
 }
 
+Napi::Value Pipeline::get_throughput(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  gint64 wall_us;
+  bool finished;
+  {
+    std::lock_guard<std::mutex> lock(bus_state->mutex);
+    wall_us = bus_state->playing_total_us;
+    if (bus_state->playing_since_us >= 0) {
+      wall_us += g_get_monotonic_time() - bus_state->playing_since_us;
+    }
+    finished = bus_state->finished;
+  }
+
+  // Media time processed so far; after EOS the position stays at the end of the stream
+  gint64 media_ns = -1;
+  if (!gst_element_query_position(GST_ELEMENT(pipeline.get()), GST_FORMAT_TIME, &media_ns)) {
+    gst_element_query_duration(GST_ELEMENT(pipeline.get()), GST_FORMAT_TIME, &media_ns);
+  }
+
+  double wall_seconds = static_cast<double>(wall_us) / G_USEC_PER_SEC;
+  double media_seconds = media_ns < 0 ? -1 : static_cast<double>(media_ns) / GST_SECOND;
+
+  // How many seconds of media were processed per wall-clock second
+  double realtime_factor = 0;
+  if (wall_seconds > 0 && media_seconds >= 0) {
+    realtime_factor = media_seconds / wall_seconds;
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("wallSeconds", Napi::Number::New(env, wall_seconds));
+  result.Set("mediaSeconds", Napi::Number::New(env, media_seconds));
+  result.Set("realtimeFactor", Napi::Number::New(env, realtime_factor));
+  result.Set("finished", Napi::Boolean::New(env, finished));
+
+  return result;
+}
+
+Napi::Value Pipeline::add_bin(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "addBin() requires a string argument (bin description)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::string description = info[0].As<Napi::String>().Utf8Value();
+
+  // Unlinked pads of the description are ghosted as "sink"/"src" on the new bin
+  GError *err = nullptr;
+  GstElement *bin = gst_parse_bin_from_description(description.c_str(), TRUE, &err);
+  if (err) {
+    std::string message = err->message;
+    g_error_free(err);
+    if (bin) {
+      gst_object_unref(bin);
+    }
+    Napi::Error::New(env, message).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (info.Length() > 1 && info[1].IsString()) {
+    gst_object_set_name(GST_OBJECT(bin), info[1].As<Napi::String>().Utf8Value().c_str());
+  }
+
+  // The bin stays in NULL until link() syncs it with the pipeline
+  if (!gst_bin_add(GST_BIN(pipeline.get()), bin)) {
+    gst_object_unref(bin);
+    Napi::Error::New(env, "Failed to add bin (duplicate name?)").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  return Element::CreateFromGstElement(env, GST_ELEMENT(gst_object_ref(bin)));
+}
+
+// Read the timeoutMs option shared by the reconfiguration methods
+static GstClockTime reconfigure_timeout(const Napi::Value &options) {
+  GstClockTime timeout = 1000 * GST_MSECOND;
+  if (!options.IsObject()) {
+    return timeout;
+  }
+
+  Napi::Value timeout_value = options.As<Napi::Object>().Get("timeoutMs");
+  if (timeout_value.IsNumber()) {
+    double timeout_ms = timeout_value.As<Napi::Number>().DoubleValue();
+    if (timeout_ms < 0) {
+      // Negative timeout means infinite wait
+      timeout = GST_CLOCK_TIME_NONE;
+    } else {
+      timeout = static_cast<GstClockTime>(timeout_ms * GST_MSECOND);
+    }
+  }
+  return timeout;
+}
+
+static std::string string_option(const Napi::Value &options, const char *key) {
+  if (options.IsObject() && options.As<Napi::Object>().Get(key).IsString()) {
+    return options.As<Napi::Object>().Get(key).As<Napi::String>().Utf8Value();
+  }
+  return "";
+}
+
+Napi::Value Pipeline::link(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "link() requires two string arguments (source, sink)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Value options = info.Length() > 2 ? info[2] : env.Undefined();
+
+  ReconfigureWorker *worker = new ReconfigureWorker(
+    env, pipeline.get(), ReconfigureWorker::Operation::Link,
+    info[0].As<Napi::String>().Utf8Value(), info[1].As<Napi::String>().Utf8Value(),
+    string_option(options, "srcPad"), string_option(options, "sinkPad"), false,
+    reconfigure_timeout(options)
+  );
+  Napi::Promise promise = worker->GetPromise().Promise();
+  worker->Queue();
+
+  return promise;
+}
+
+Napi::Value Pipeline::unlink(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 2 || !info[0].IsString() || !info[1].IsString()) {
+    Napi::TypeError::New(env, "unlink() requires two string arguments (source, sink)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Value options = info.Length() > 2 ? info[2] : env.Undefined();
+
+  ReconfigureWorker *worker = new ReconfigureWorker(
+    env, pipeline.get(), ReconfigureWorker::Operation::Unlink,
+    info[0].As<Napi::String>().Utf8Value(), info[1].As<Napi::String>().Utf8Value(), "", "", false,
+    reconfigure_timeout(options)
+  );
+  Napi::Promise promise = worker->GetPromise().Promise();
+  worker->Queue();
+
+  return promise;
+}
+
+Napi::Value Pipeline::remove_element(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsString()) {
+    Napi::TypeError::New(env, "removeElement() requires a string argument (element name)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::Value options = info.Length() > 1 ? info[1] : env.Undefined();
+  bool send_eos = options.IsObject() && options.As<Napi::Object>().Get("eos").ToBoolean();
+
+  ReconfigureWorker *worker = new ReconfigureWorker(
+    env, pipeline.get(), ReconfigureWorker::Operation::Remove,
+    info[0].As<Napi::String>().Utf8Value(), "", "", "", send_eos, reconfigure_timeout(options)
+  );
+  Napi::Promise promise = worker->GetPromise().Promise();
+  worker->Queue();
+
+  return promise;
+}
+
+Napi::Value Pipeline::enable_tracers(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsArray()) {
+    Napi::TypeError::New(env, "enableTracers() requires an array argument (tracer names)")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::vector<std::string> tracers;
+  Napi::Array names = info[0].As<Napi::Array>();
+  for (uint32_t i = 0; i < names.Length(); i++) {
+    Napi::Value name = names.Get(i);
+    if (!name.IsString()) {
+      Napi::TypeError::New(env, "Tracer names must be strings").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    tracers.push_back(name.As<Napi::String>().Utf8Value());
+  }
+
+  // Optional per-tracer parameter strings, e.g. { latency: "flags=element" }
+  std::map<std::string, std::string> params;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Value params_value = info[1].As<Napi::Object>().Get("params");
+    if (params_value.IsObject()) {
+      Napi::Object params_obj = params_value.As<Napi::Object>();
+      Napi::Array keys = params_obj.GetPropertyNames();
+      for (uint32_t i = 0; i < keys.Length(); i++) {
+        std::string key = keys.Get(i).As<Napi::String>().Utf8Value();
+        params[key] = params_obj.Get(key).ToString().Utf8Value();
+      }
+    }
+  }
+
+  std::string error;
+  std::shared_ptr<TracerSession> session =
+    TracerSession::start(pipeline.get(), tracers, params, error);
+  if (!session) {
+    Napi::Error::New(env, error).ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  tracer_session = session;
+  return env.Undefined();
+}
+
+Napi::Value Pipeline::get_tracer_stats(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (!tracer_session) {
+    return Napi::Object::New(env);
+  }
+
+  Napi::Object result = tracer_session->to_js(env);
+
+  if (info.Length() > 0 && info[0].IsObject()
+      && info[0].As<Napi::Object>().Get("reset").ToBoolean()) {
+    tracer_session->reset();
+  }
+
+  return result;
+}
+
+Napi::Value Pipeline::disable_tracers(const Napi::CallbackInfo &info) {
+  // Tracers keep running process-wide, but records are no longer collected for this pipeline
+  tracer_session.reset();
+  return info.Env().Undefined();
+}
+
+Napi::Value Pipeline::start_profiler(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::shared_ptr<Profiler> profiler = Profiler::start(pipeline.get());
+
+  // The profiler lives as long as either function is reachable from JS
+  auto snapshot_method = Napi::Function::New(
+    env,
+    [profiler](const Napi::CallbackInfo &info) -> Napi::Value {
+      return profiler->snapshot(info.Env());
+    },
+    "snapshot"
+  );
+  auto stop_method = Napi::Function::New(
+    env,
+    [profiler](const Napi::CallbackInfo &info) -> Napi::Value {
+      profiler->stop();
+      return info.Env().Undefined();
+    },
+    "stop"
+  );
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("snapshot", snapshot_method);
+  result.Set("stop", stop_method);
+
+  return result;
+}
+
+Napi::Value Pipeline::monitor_queues(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !info[0].IsFunction()) {
+    Napi::TypeError::New(env, "monitorQueues() requires a callback function")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  double interval_ms = 1000;
+  double history_length = 60;
+  double saturation = 0.9;
+  if (info.Length() > 1 && info[1].IsObject()) {
+    Napi::Object options = info[1].As<Napi::Object>();
+    if (options.Get("intervalMs").IsNumber()) {
+      interval_ms = options.Get("intervalMs").As<Napi::Number>().DoubleValue();
+    }
+    if (options.Get("historyLength").IsNumber()) {
+      history_length = options.Get("historyLength").As<Napi::Number>().DoubleValue();
+    }
+    if (options.Get("saturation").IsNumber()) {
+      saturation = options.Get("saturation").As<Napi::Number>().DoubleValue();
+    }
+  }
+
+  if (interval_ms < 1) {
+    Napi::TypeError::New(env, "intervalMs must be >= 1").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+  if (history_length < 1) {
+    Napi::TypeError::New(env, "historyLength must be >= 1").ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  Napi::ThreadSafeFunction tsfn =
+    Napi::ThreadSafeFunction::New(env, info[0].As<Napi::Function>(), "QueueMonitorCallback", 0, 1);
+
+  std::shared_ptr<QueueMonitor> monitor = QueueMonitor::start(
+    pipeline.get(), tsfn, std::chrono::milliseconds(static_cast<int64_t>(interval_ms)),
+    static_cast<size_t>(history_length), saturation
+  );
+
+  // Return a stop function
+  return Napi::Function::New(env, [monitor](const Napi::CallbackInfo &info) -> Napi::Value {
+    monitor->stop();
+    return info.Env().Undefined();
+  });
+}
+
+Napi::Value Pipeline::set_thread_policy(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  if (info.Length() < 1 || !(info[0].IsObject() || info[0].IsNull())) {
+    Napi::TypeError::New(env, "setThreadPolicy() requires a policy object or null")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  if (!ThreadControl::supported()) {
+    Napi::Error::New(env, "Thread policies are only supported on Linux")
+      .ThrowAsJavaScriptException();
+    return env.Undefined();
+  }
+
+  std::shared_ptr<const ThreadPolicySet> policy;
+  if (info[0].IsObject()) {
+    std::string error;
+    ThreadPolicySet parsed = ThreadControl::from_js(info[0].As<Napi::Object>(), error);
+    if (!error.empty()) {
+      Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+    policy = std::make_shared<const ThreadPolicySet>(std::move(parsed));
+  }
+
+  std::map<long, ThreadAssignment> running;
+  {
+    std::lock_guard<std::mutex> lock(bus_state->mutex);
+    bus_state->thread_policy = policy;
+    running = bus_state->threads;
+  }
+
+  // Threads that are already streaming are updated in place; null only affects new threads
+  if (policy) {
+    for (auto &[tid, assignment] : running) {
+      std::vector<std::string> errors =
+        ThreadControl::apply(tid, policy->for_element(assignment.element), assignment.element);
+
+      std::lock_guard<std::mutex> lock(bus_state->mutex);
+      auto it = bus_state->threads.find(tid);
+      if (it != bus_state->threads.end()) {
+        it->second.errors = errors;
+      }
+    }
+  }
+
+  return env.Undefined();
+}
+
+Napi::Value Pipeline::get_thread_assignments(const Napi::CallbackInfo &info) {
+  Napi::Env env = info.Env();
+
+  std::map<long, ThreadAssignment> running;
+  {
+    std::lock_guard<std::mutex> lock(bus_state->mutex);
+    running = bus_state->threads;
+  }
+
+  Napi::Array result = Napi::Array::New(env, running.size());
+  uint32_t index = 0;
+  for (auto &[tid, assignment] : running) {
+    result.Set(index++, ThreadControl::to_js(env, assignment));
+  }
+
+  return result;
+}
+
 Napi::Value Pipeline::ElementExists(const Napi::CallbackInfo &info) {
   Napi::Env env = info.Env();
 
@@ -1,15 +1,48 @@
 #pragma once
 
+#include "profiler.hpp"
+#include "queue-monitor.hpp"
+#include "thread-policy.hpp"
+#include "tracing.hpp"
 #include <gst/gst.h>
 #include <gst/video/video.h>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <napi.h>
 #include <string>
 
+// State read and written by the bus sync handler. It is shared with the bus because the
+// handler runs on streaming threads and the bus can outlive the Pipeline wrapper while
+// async workers still hold a reference to the GstPipeline.
+struct BusSyncState {
+  std::mutex mutex;
+  // Wall-clock accounting for throughput reports (microseconds, monotonic)
+  gint64 playing_since_us = -1;
+  gint64 playing_total_us = 0;
+  bool finished = false;
+  // Scheduling policy applied to streaming threads as they start, null if none is set
+  std::shared_ptr<const ThreadPolicySet> thread_policy;
+  // Streaming threads currently running a task, by kernel thread id
+  std::map<long, ThreadAssignment> threads;
+  // Runs the pipeline's tasks where thread policies are supported. Policies change the
+  // threads themselves, and threads of the default pool go on to serve other pipelines.
+  GstTaskPool *task_pool = nullptr;
+  bool task_pool_prepared = false;
+
+  ~BusSyncState();
+  // The prepared task pool, created on first use. Called with mutex held.
+  GstTaskPool *acquire_task_pool();
+  // Stop the pool's idle threads once no task runs anymore. Called without mutex held.
+  void release_task_pool();
+};
+
 class Pipeline : public Napi::ObjectWrap<Pipeline> {
 public:
   static Napi::Object Init(const Napi::Env &env, const Napi::Object &exports);
   static Napi::Value ElementExists(const Napi::CallbackInfo &info);
+  // Initialize GStreamer once for the whole addon, before anything else calls into it
+  static void ensure_gst_initialized();
 
   Pipeline(const Napi::CallbackInfo &info);
 
@@ -23,10 +56,25 @@ public:
   Napi::Value bus_pop(const Napi::CallbackInfo &info);
   Napi::Value seek(const Napi::CallbackInfo &info);
   Napi::Value end_of_stream(const Napi::CallbackInfo &info);
+  Napi::Value get_throughput(const Napi::CallbackInfo &info);
+  Napi::Value add_bin(const Napi::CallbackInfo &info);
+  Napi::Value link(const Napi::CallbackInfo &info);
+  Napi::Value unlink(const Napi::CallbackInfo &info);
+  Napi::Value remove_element(const Napi::CallbackInfo &info);
+  Napi::Value enable_tracers(const Napi::CallbackInfo &info);
+  Napi::Value get_tracer_stats(const Napi::CallbackInfo &info);
+  Napi::Value disable_tracers(const Napi::CallbackInfo &info);
+  Napi::Value start_profiler(const Napi::CallbackInfo &info);
+  Napi::Value monitor_queues(const Napi::CallbackInfo &info);
+  Napi::Value set_thread_policy(const Napi::CallbackInfo &info);
+  Napi::Value get_thread_assignments(const Napi::CallbackInfo &info);
 
 private:
   std::string pipeline_string;
   std::unique_ptr<GstPipeline, decltype(&gst_object_unref)> pipeline;
+  std::shared_ptr<BusSyncState> bus_state;
+  std::shared_ptr<TracerSession> tracer_session;
   static bool gst_initialized;
-  static void ensure_gst_initialized();
+  static GstBusSyncReply bus_sync_handler(GstBus *bus, GstMessage *message, gpointer user_data);
+  static void configure_offline(GstPipeline *pipeline);
 };
@@ -0,0 +1,150 @@
+#include "prerecord-ring.hpp"
+
+PreRecordSnapshot::~PreRecordSnapshot() {
+  if (caps) {
+    gst_caps_unref(caps);
+  }
+  for (GstBuffer *buffer : headers) {
+    gst_buffer_unref(buffer);
+  }
+  for (GstBuffer *buffer : buffers) {
+    gst_buffer_unref(buffer);
+  }
+}
+
+PreRecordRing::PreRecordRing(const PreRecordLimits &limits) : limits(limits) {}
+
+PreRecordRing::~PreRecordRing() {
+  clear();
+  for (GstBuffer *buffer : headers) {
+    gst_buffer_unref(buffer);
+  }
+  if (caps) {
+    gst_caps_unref(caps);
+  }
+}
+
+void PreRecordRing::set_caps(GstCaps *new_caps) {
+  std::lock_guard<std::mutex> lock(mutex);
+  gst_caps_replace(&caps, new_caps);
+}
+
+void PreRecordRing::push(GstBuffer *buffer) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  if (GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_HEADER)) {
+    // A new run of headers replaces the previous one
+    if (!last_was_header) {
+      for (GstBuffer *header : headers) {
+        gst_buffer_unref(header);
+      }
+      headers.clear();
+    }
+    headers.push_back(gst_buffer_ref(buffer));
+    last_was_header = true;
+    return;
+  }
+  last_was_header = false;
+
+  bool keyframe = !GST_BUFFER_FLAG_IS_SET(buffer, GST_BUFFER_FLAG_DELTA_UNIT);
+  if (entries.empty() && !keyframe) {
+    // Nothing is decodable before the first keyframe
+    return;
+  }
+
+  // Decode order is what ends up in the file, so DTS is preferred when present
+  GstClockTime time = GST_BUFFER_DTS_OR_PTS(buffer);
+  entries.push_back({gst_buffer_ref(buffer), time, keyframe});
+  total_bytes += gst_buffer_get_size(buffer);
+  if (GST_CLOCK_TIME_IS_VALID(time)) {
+    end_time = time + (GST_BUFFER_DURATION_IS_VALID(buffer) ? GST_BUFFER_DURATION(buffer) : 0);
+  }
+
+  prune();
+}
+
+GstClockTime PreRecordRing::span() const {
+  if (entries.empty() || !GST_CLOCK_TIME_IS_VALID(entries.front().time)
+      || !GST_CLOCK_TIME_IS_VALID(end_time) || end_time < entries.front().time) {
+    return 0;
+  }
+  return end_time - entries.front().time;
+}
+
+void PreRecordRing::prune() {
+  while (entries.size() > 1) {
+    bool over_bytes = limits.max_bytes > 0 && total_bytes > limits.max_bytes;
+
+    // Start of the second GOP, the earliest point the ring can be cut at
+    size_t next = 1;
+    while (next < entries.size() && !entries[next].keyframe) {
+      next++;
+    }
+    if (next >= entries.size()) {
+      // A single GOP over the cap is dropped whole, the ring restarts at the next keyframe
+      if (over_bytes) {
+        clear_entries();
+      }
+      return;
+    }
+
+    // Drop the oldest GOP if what follows still covers the duration, or if over the byte cap
+    GstClockTime next_time = entries[next].time;
+    bool covered = GST_CLOCK_TIME_IS_VALID(next_time) && GST_CLOCK_TIME_IS_VALID(end_time)
+                   && end_time >= next_time && end_time - next_time >= limits.duration;
+    if (!covered && !over_bytes) {
+      return;
+    }
+
+    for (size_t i = 0; i < next; i++) {
+      total_bytes -= gst_buffer_get_size(entries.front().buffer);
+      gst_buffer_unref(entries.front().buffer);
+      entries.pop_front();
+    }
+  }
+}
+
+void PreRecordRing::clear_entries() {
+  for (Entry &entry : entries) {
+    gst_buffer_unref(entry.buffer);
+  }
+  entries.clear();
+  total_bytes = 0;
+  end_time = GST_CLOCK_TIME_NONE;
+}
+
+void PreRecordRing::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  clear_entries();
+}
+
+void PreRecordRing::snapshot(PreRecordSnapshot &snapshot) {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (caps) {
+    snapshot.caps = gst_caps_ref(caps);
+  }
+  for (GstBuffer *header : headers) {
+    snapshot.headers.push_back(gst_buffer_ref(header));
+  }
+  snapshot.buffers.reserve(entries.size());
+  for (Entry &entry : entries) {
+    snapshot.buffers.push_back(gst_buffer_ref(entry.buffer));
+  }
+  snapshot.bytes = total_bytes;
+  snapshot.duration = span();
+}
+
+size_t PreRecordRing::size() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return entries.size();
+}
+
+size_t PreRecordRing::bytes() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return total_bytes;
+}
+
+GstClockTime PreRecordRing::duration() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return span();
+}
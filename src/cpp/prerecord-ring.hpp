@@ -0,0 +1,69 @@
+#pragma once
+
+#include <deque>
+#include <gst/gst.h>
+#include <mutex>
+#include <vector>
+
+struct PreRecordLimits {
+  // Keep at least this much media time, counted from a keyframe
+  GstClockTime duration = 30 * GST_SECOND;
+  // Hard cap on the stored bytes, 0 for none. Whole GOPs are dropped to stay below it. This is
+  // the only bound for streams without timestamps.
+  size_t max_bytes = 256 * 1024 * 1024;
+};
+
+// Buffers of one ring at the time of a flush, each holding a reference
+struct PreRecordSnapshot {
+  GstCaps *caps = nullptr;
+  std::vector<GstBuffer *> headers;
+  std::vector<GstBuffer *> buffers;
+  size_t bytes = 0;
+  GstClockTime duration = 0;
+
+  PreRecordSnapshot() = default;
+  PreRecordSnapshot(const PreRecordSnapshot &) = delete;
+  PreRecordSnapshot &operator=(const PreRecordSnapshot &) = delete;
+  ~PreRecordSnapshot();
+};
+
+// Rolling buffer of the most recent encoded buffers. The oldest buffer is always a keyframe
+// (no GST_BUFFER_FLAG_DELTA_UNIT), so a flush starts with something decodable. Buffers
+// flagged GST_BUFFER_FLAG_HEADER (codec or container headers) are kept aside and written in
+// front of every flush. Pushed from a streaming thread, read from any other.
+class PreRecordRing {
+public:
+  explicit PreRecordRing(const PreRecordLimits &limits);
+  ~PreRecordRing();
+
+  void set_caps(GstCaps *caps);
+  void push(GstBuffer *buffer);
+  void clear();
+
+  // References the current contents, the ring keeps running
+  void snapshot(PreRecordSnapshot &snapshot);
+
+  size_t size();
+  size_t bytes();
+  GstClockTime duration();
+
+private:
+  struct Entry {
+    GstBuffer *buffer;
+    GstClockTime time;
+    bool keyframe;
+  };
+
+  void prune();
+  void clear_entries();
+  GstClockTime span() const;
+
+  PreRecordLimits limits;
+  std::mutex mutex;
+  std::deque<Entry> entries;
+  size_t total_bytes = 0;
+  GstClockTime end_time = GST_CLOCK_TIME_NONE;
+  GstCaps *caps = nullptr;
+  std::vector<GstBuffer *> headers;
+  bool last_was_header = false;
+};
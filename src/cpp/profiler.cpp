@@ -0,0 +1,411 @@
+#include "profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+static std::atomic<uint64_t> next_element_id{1};
+static std::atomic<uint64_t> next_session_id{1};
+
+// What the current thread last saw of an element
+struct ProfilerThreadSlot {
+  uint64_t entry_ns = 0;
+  ProfilerThreadStats *stats = nullptr;
+};
+
+using ProfilerSlots = std::unordered_map<uint64_t, ProfilerThreadSlot>;
+
+// Sessions still running probes. Ending one bumps the generation, so threads know to drop the
+// slots of ended sessions on their next probe without taking the lock on every buffer.
+static std::mutex live_sessions_mutex;
+static std::unordered_set<uint64_t> live_sessions;
+static std::atomic<uint64_t> live_sessions_generation{0};
+
+static void session_started(uint64_t session_id) {
+  std::lock_guard<std::mutex> lock(live_sessions_mutex);
+  live_sessions.insert(session_id);
+}
+
+static void session_ended(uint64_t session_id) {
+  std::lock_guard<std::mutex> lock(live_sessions_mutex);
+  live_sessions.erase(session_id);
+  live_sessions_generation.fetch_add(1, std::memory_order_release);
+}
+
+// Slots of the current thread, kept apart per session so profilers sharing a pipeline never
+// see each other's timestamps. Element ids are never reused, so slots of ended sessions are
+// dropped rather than left to pile up on long-lived streaming threads.
+static ProfilerSlots &thread_slots(uint64_t session_id) {
+  thread_local std::unordered_map<uint64_t, ProfilerSlots> sessions;
+  thread_local uint64_t generation = 0;
+
+  uint64_t current = live_sessions_generation.load(std::memory_order_acquire);
+  if (generation != current) {
+    generation = current;
+    std::lock_guard<std::mutex> lock(live_sessions_mutex);
+    for (auto it = sessions.begin(); it != sessions.end();) {
+      it = live_sessions.count(it->first) ? std::next(it) : sessions.erase(it);
+    }
+  }
+  return sessions[session_id];
+}
+
+static uint64_t now_ns() {
+  return static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()
+    )
+      .count()
+  );
+}
+
+static uint64_t current_thread_key() {
+  return static_cast<uint64_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+}
+
+static std::string current_thread_name() {
+#ifdef __linux__
+  // GstTask names its threads after the pad task, e.g. "queue0:src"
+  char name[16] = {0};
+  if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0) {
+    return name;
+  }
+#endif
+  return "";
+}
+
+ProfilerThreadStats *ProfilerElementStats::thread_stats() {
+  uint64_t key = current_thread_key();
+
+  std::lock_guard<std::mutex> lock(threads_mutex);
+  auto &stats = threads[key];
+  if (!stats) {
+    stats = std::make_unique<ProfilerThreadStats>();
+    stats->name = current_thread_name();
+  }
+  return stats.get();
+}
+
+ProfilerState::~ProfilerState() {
+  if (session_id) {
+    session_ended(session_id);
+  }
+  for (auto &stats : elements) {
+    gst_object_unref(stats->element);
+  }
+  if (pipeline) {
+    gst_object_unref(pipeline);
+  }
+}
+
+struct ProfilerProbeContext {
+  std::shared_ptr<ProfilerState> state;
+  ProfilerElementStats *stats;
+  bool sink_side;
+};
+
+static GstPadProbeReturn
+profiler_probe_callback(GstPad *pad, GstPadProbeInfo *info, gpointer user_data) {
+  ProfilerProbeContext *context = static_cast<ProfilerProbeContext *>(user_data);
+  ProfilerElementStats *stats = context->stats;
+  uint64_t now = now_ns();
+
+  uint64_t buffers = 1;
+  uint64_t bytes = 0;
+  if (GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER_LIST) {
+    GstBufferList *list = GST_PAD_PROBE_INFO_BUFFER_LIST(info);
+    buffers = gst_buffer_list_length(list);
+    bytes = gst_buffer_list_calculate_size(list);
+  } else {
+    bytes = gst_buffer_get_size(GST_PAD_PROBE_INFO_BUFFER(info));
+  }
+
+  ProfilerThreadSlot &slot = thread_slots(context->state->session_id)[stats->id];
+  if (!slot.stats) {
+    slot.stats = stats->thread_stats();
+  }
+
+  if (context->sink_side) {
+    stats->buffers_in.fetch_add(buffers, std::memory_order_relaxed);
+    stats->bytes_in.fetch_add(bytes, std::memory_order_relaxed);
+    if (stats->is_sink) {
+      // Sinks produce nothing to time against, only throughput is counted
+      slot.stats->buffers.fetch_add(buffers, std::memory_order_relaxed);
+    } else {
+      slot.entry_ns = now;
+    }
+    return GST_PAD_PROBE_OK;
+  }
+
+  stats->buffers_out.fetch_add(buffers, std::memory_order_relaxed);
+  stats->bytes_out.fetch_add(bytes, std::memory_order_relaxed);
+  slot.stats->buffers.fetch_add(buffers, std::memory_order_relaxed);
+
+  // Only the first output after an input on the same thread is a processing time; outputs
+  // from the element's own thread (queues, sources) have no matching input
+  if (slot.entry_ns) {
+    uint64_t elapsed = now - slot.entry_ns;
+    slot.entry_ns = 0;
+    stats->processing.record(elapsed);
+    slot.stats->busy_ns.fetch_add(elapsed, std::memory_order_relaxed);
+  }
+
+  return GST_PAD_PROBE_OK;
+}
+
+// Called with state->mutex held
+static void instrument_pad(
+  const std::shared_ptr<ProfilerState> &state, ProfilerElementStats *stats, GstPad *pad
+) {
+  ProfilerProbeContext *context =
+    new ProfilerProbeContext{state, stats, GST_PAD_DIRECTION(pad) == GST_PAD_SINK};
+
+  gulong probe_id = gst_pad_add_probe(
+    pad,
+    static_cast<GstPadProbeType>(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_BUFFER_LIST),
+    profiler_probe_callback, context,
+    [](gpointer data) { delete static_cast<ProfilerProbeContext *>(data); }
+  );
+  if (probe_id) {
+    state->probes.emplace_back(GST_PAD(gst_object_ref(pad)), probe_id);
+  }
+}
+
+static void on_pad_added(GstElement *element, GstPad *pad, gpointer user_data) {
+  auto &state = *static_cast<std::shared_ptr<ProfilerState> *>(user_data);
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  auto it = state->by_element.find(element);
+  if (state->running && it != state->by_element.end()) {
+    instrument_pad(state, it->second, pad);
+  }
+}
+
+// Called with state->mutex held
+static void instrument_element(const std::shared_ptr<ProfilerState> &state, GstElement *element) {
+  // Bins only proxy their children's pads, which are instrumented directly
+  if (GST_IS_BIN(element) || state->by_element.count(element)) {
+    return;
+  }
+
+  auto stats = std::make_unique<ProfilerElementStats>();
+  stats->id = next_element_id.fetch_add(1);
+  stats->element = GST_ELEMENT(gst_object_ref(element));
+  stats->name = GST_OBJECT_NAME(element);
+  GstElementFactory *factory = gst_element_get_factory(element);
+  stats->factory = factory ? GST_OBJECT_NAME(factory) : "";
+  stats->is_source = GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SOURCE)
+                     || (element->numsinkpads == 0 && element->numsrcpads > 0);
+  stats->is_sink = GST_OBJECT_FLAG_IS_SET(element, GST_ELEMENT_FLAG_SINK)
+                   || (element->numsrcpads == 0 && element->numsinkpads > 0);
+
+  ProfilerElementStats *raw_stats = stats.get();
+  state->by_element[element] = raw_stats;
+  state->elements.push_back(std::move(stats));
+
+  GstIterator *it = gst_element_iterate_pads(element);
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK:
+        instrument_pad(state, raw_stats, GST_PAD(g_value_get_object(&item)));
+        g_value_reset(&item);
+        break;
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync(it);
+        break;
+      default:
+        done = true;
+        break;
+    }
+  }
+
+  g_value_unset(&item);
+  gst_iterator_free(it);
+
+  // Demuxers and decodebin add their source pads once the stream is known
+  gulong handler = g_signal_connect_data(
+    element, "pad-added", G_CALLBACK(on_pad_added), new std::shared_ptr<ProfilerState>(state),
+    [](gpointer data, GClosure *) { delete static_cast<std::shared_ptr<ProfilerState> *>(data); },
+    static_cast<GConnectFlags>(0)
+  );
+  state->handlers.emplace_back(GST_ELEMENT(gst_object_ref(element)), handler);
+}
+
+static void
+on_deep_element_added(GstBin *pipeline, GstBin *bin, GstElement *element, gpointer user_data) {
+  auto &state = *static_cast<std::shared_ptr<ProfilerState> *>(user_data);
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (state->running) {
+    instrument_element(state, element);
+  }
+}
+
+std::shared_ptr<Profiler> Profiler::start(GstPipeline *pipeline) {
+  std::shared_ptr<Profiler> profiler(new Profiler());
+  profiler->state = std::make_shared<ProfilerState>();
+  profiler->state->session_id = next_session_id.fetch_add(1);
+  session_started(profiler->state->session_id);
+
+  std::shared_ptr<ProfilerState> &state = profiler->state;
+  state->pipeline = GST_PIPELINE(gst_object_ref(pipeline));
+  state->started_us = g_get_monotonic_time();
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+
+  gulong handler = g_signal_connect_data(
+    pipeline, "deep-element-added", G_CALLBACK(on_deep_element_added),
+    new std::shared_ptr<ProfilerState>(state),
+    [](gpointer data, GClosure *) { delete static_cast<std::shared_ptr<ProfilerState> *>(data); },
+    static_cast<GConnectFlags>(0)
+  );
+  state->handlers.emplace_back(GST_ELEMENT(gst_object_ref(pipeline)), handler);
+
+  GstIterator *it = gst_bin_iterate_recurse(GST_BIN(pipeline));
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK:
+        instrument_element(state, GST_ELEMENT(g_value_get_object(&item)));
+        g_value_reset(&item);
+        break;
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync(it);
+        break;
+      default:
+        done = true;
+        break;
+    }
+  }
+
+  g_value_unset(&item);
+  gst_iterator_free(it);
+
+  return profiler;
+}
+
+Profiler::~Profiler() { stop(); }
+
+void Profiler::stop() {
+  std::vector<std::pair<GstPad *, gulong>> probes;
+  std::vector<std::pair<GstElement *, gulong>> handlers;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->running) {
+      return;
+    }
+    state->running = false;
+    state->stopped_us = g_get_monotonic_time();
+    probes.swap(state->probes);
+    handlers.swap(state->handlers);
+  }
+
+  // Removing probes and handlers drops their references to the state
+  for (auto &[element, handler] : handlers) {
+    g_signal_handler_disconnect(element, handler);
+    gst_object_unref(element);
+  }
+  for (auto &[pad, probe_id] : probes) {
+    gst_pad_remove_probe(pad, probe_id);
+    gst_object_unref(pad);
+  }
+}
+
+static Napi::Object processing_to_js(const Napi::Env &env, const Histogram &histogram) {
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("count", Napi::Number::New(env, static_cast<double>(histogram.count())));
+  result.Set("totalNs", Napi::Number::New(env, static_cast<double>(histogram.sum())));
+  result.Set("mean", Napi::Number::New(env, histogram.mean()));
+  result.Set("p50", Napi::Number::New(env, histogram.percentile(50)));
+  result.Set("p95", Napi::Number::New(env, histogram.percentile(95)));
+  result.Set("p99", Napi::Number::New(env, histogram.percentile(99)));
+  result.Set("max", Napi::Number::New(env, static_cast<double>(histogram.max())));
+  return result;
+}
+
+Napi::Object Profiler::snapshot(const Napi::Env &env) {
+  std::lock_guard<std::mutex> lock(state->mutex);
+
+  gint64 end_us = state->stopped_us >= 0 ? state->stopped_us : g_get_monotonic_time();
+  double elapsed = static_cast<double>(end_us - state->started_us) / G_USEC_PER_SEC;
+
+  std::vector<ProfilerElementStats *> ranked;
+  uint64_t total_ns = 0;
+  for (auto &stats : state->elements) {
+    ranked.push_back(stats.get());
+    total_ns += stats->processing.sum();
+  }
+  std::stable_sort(
+    ranked.begin(), ranked.end(),
+    [](ProfilerElementStats *a, ProfilerElementStats *b) {
+      return a->processing.sum() > b->processing.sum();
+    }
+  );
+
+  Napi::Array elements = Napi::Array::New(env, ranked.size());
+  for (size_t i = 0; i < ranked.size(); i++) {
+    ProfilerElementStats *stats = ranked[i];
+    Napi::Object element = Napi::Object::New(env);
+
+    const char *type = stats->is_source ? "source" : stats->is_sink ? "sink" : "element";
+    element.Set("name", Napi::String::New(env, stats->name));
+    element.Set("factory", Napi::String::New(env, stats->factory));
+    element.Set("type", Napi::String::New(env, type));
+
+    double buffers_in = static_cast<double>(stats->buffers_in.load());
+    double buffers_out = static_cast<double>(stats->buffers_out.load());
+    double bytes_in = static_cast<double>(stats->bytes_in.load());
+    double bytes_out = static_cast<double>(stats->bytes_out.load());
+    element.Set("buffersIn", Napi::Number::New(env, buffers_in));
+    element.Set("buffersOut", Napi::Number::New(env, buffers_out));
+    element.Set("bytesIn", Napi::Number::New(env, bytes_in));
+    element.Set("bytesOut", Napi::Number::New(env, bytes_out));
+
+    // Throughput is measured on the output side, except for sinks
+    double buffers = stats->is_sink ? buffers_in : buffers_out;
+    double bytes = stats->is_sink ? bytes_in : bytes_out;
+    element.Set("buffersPerSecond", Napi::Number::New(env, elapsed > 0 ? buffers / elapsed : 0));
+    element.Set("bytesPerSecond", Napi::Number::New(env, elapsed > 0 ? bytes / elapsed : 0));
+
+    if (stats->processing.count() > 0) {
+      element.Set("processing", processing_to_js(env, stats->processing));
+    } else {
+      element.Set("processing", env.Null());
+    }
+
+    double share = total_ns ? static_cast<double>(stats->processing.sum()) / total_ns : 0;
+    element.Set("share", Napi::Number::New(env, share));
+
+    Napi::Array threads = Napi::Array::New(env);
+    {
+      std::lock_guard<std::mutex> threads_lock(stats->threads_mutex);
+      uint32_t index = 0;
+      for (auto &[key, thread] : stats->threads) {
+        Napi::Object thread_obj = Napi::Object::New(env);
+        thread_obj.Set("name", Napi::String::New(env, thread->name));
+        thread_obj.Set("buffers", Napi::Number::New(env, static_cast<double>(thread->buffers)));
+        thread_obj.Set("busyNs", Napi::Number::New(env, static_cast<double>(thread->busy_ns)));
+        threads.Set(index++, thread_obj);
+      }
+    }
+    element.Set("threads", threads);
+
+    elements.Set(static_cast<uint32_t>(i), element);
+  }
+
+  Napi::Object result = Napi::Object::New(env);
+  result.Set("elapsedSeconds", Napi::Number::New(env, elapsed));
+  result.Set("elements", elements);
+  return result;
+}
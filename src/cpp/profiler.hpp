@@ -0,0 +1,78 @@
+#pragma once
+
+#include "histogram.hpp"
+#include <atomic>
+#include <gst/gst.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <string>
+#include <vector>
+
+// Buffers and busy time one streaming thread spent in one element
+struct ProfilerThreadStats {
+  std::string name;
+  std::atomic<uint64_t> buffers{0};
+  std::atomic<uint64_t> busy_ns{0};
+};
+
+struct ProfilerElementStats {
+  // Process-unique key for the per-thread probe state, never reused
+  uint64_t id;
+  GstElement *element;
+  std::string name;
+  std::string factory;
+  bool is_source;
+  bool is_sink;
+
+  // Time from a buffer entering a sink pad to the next buffer leaving a src pad on the
+  // same thread. Downstream work done inside the push is not included.
+  Histogram processing;
+  std::atomic<uint64_t> buffers_in{0};
+  std::atomic<uint64_t> buffers_out{0};
+  std::atomic<uint64_t> bytes_in{0};
+  std::atomic<uint64_t> bytes_out{0};
+
+  std::mutex threads_mutex;
+  std::map<uint64_t, std::unique_ptr<ProfilerThreadStats>> threads;
+
+  ProfilerThreadStats *thread_stats();
+};
+
+struct ProfilerState {
+  // Process-unique key of the per-thread probe state, dropped once the session ends
+  uint64_t session_id = 0;
+  std::mutex mutex;
+  GstPipeline *pipeline = nullptr;
+  bool running = true;
+  gint64 started_us = 0;
+  gint64 stopped_us = -1;
+  std::vector<std::unique_ptr<ProfilerElementStats>> elements;
+  std::map<GstElement *, ProfilerElementStats *> by_element;
+  // Installed probes and signal handlers, removed on stop()
+  std::vector<std::pair<GstPad *, gulong>> probes;
+  std::vector<std::pair<GstElement *, gulong>> handlers;
+
+  ~ProfilerState();
+};
+
+// Per-element processing time and throughput profiler for a running pipeline.
+//
+// A buffer probe on every pad of every element records timestamps on the streaming threads;
+// the hot path is a clock read, a thread-local lookup and a few relaxed atomic operations,
+// so it is cheap enough to leave enabled. Elements added later (decodebin, hot
+// reconfiguration) and pads that appear while running are instrumented as well.
+class Profiler {
+public:
+  static std::shared_ptr<Profiler> start(GstPipeline *pipeline);
+
+  ~Profiler();
+
+  void stop();
+  // { elapsedSeconds, elements: [...] } with elements ranked by total processing time
+  Napi::Object snapshot(const Napi::Env &env);
+
+private:
+  std::shared_ptr<ProfilerState> state;
+};
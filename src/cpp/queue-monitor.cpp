@@ -0,0 +1,483 @@
+#include "queue-monitor.hpp"
+#include <cstring>
+#include <set>
+
+MonitoredQueue::~MonitoredQueue() { gst_object_unref(element); }
+
+static bool is_queue(GstElement *element) {
+  GstElementFactory *factory = gst_element_get_factory(element);
+  if (!factory) {
+    return false;
+  }
+  const gchar *name = GST_OBJECT_NAME(factory);
+  return std::strcmp(name, "queue") == 0 || std::strcmp(name, "queue2") == 0
+         || std::strcmp(name, "multiqueue") == 0;
+}
+
+// Read an integer property of any width, returns false if the object doesn't have it
+static bool read_level(GObject *object, const char *name, guint64 *out) {
+  GParamSpec *spec = g_object_class_find_property(G_OBJECT_GET_CLASS(object), name);
+  if (!spec) {
+    return false;
+  }
+
+  GValue value = G_VALUE_INIT;
+  g_value_init(&value, spec->value_type);
+  g_object_get_property(object, name, &value);
+
+  bool ok = true;
+  switch (G_VALUE_TYPE(&value)) {
+    case G_TYPE_UINT:
+      *out = g_value_get_uint(&value);
+      break;
+    case G_TYPE_UINT64:
+      *out = g_value_get_uint64(&value);
+      break;
+    case G_TYPE_INT:
+      *out = static_cast<guint64>(MAX(g_value_get_int(&value), 0));
+      break;
+    case G_TYPE_INT64:
+      *out = static_cast<guint64>(MAX(g_value_get_int64(&value), 0));
+      break;
+    default:
+      ok = false;
+      break;
+  }
+
+  g_value_unset(&value);
+  return ok;
+}
+
+static bool read_levels(GObject *object, QueueSample &sample) {
+  return read_level(object, "current-level-buffers", &sample.buffers)
+         && read_level(object, "current-level-bytes", &sample.bytes)
+         && read_level(object, "current-level-time", &sample.time);
+}
+
+static void read_limits(GObject *object, QueueSample &sample) {
+  read_level(object, "max-size-buffers", &sample.max_buffers);
+  read_level(object, "max-size-bytes", &sample.max_bytes);
+  read_level(object, "max-size-time", &sample.max_time);
+}
+
+// Fill ratio of the most constrained limit; a limit of 0 means unlimited
+static double fill_ratio(const QueueSample &sample) {
+  double fill = 0;
+  if (sample.max_buffers > 0) {
+    fill = MAX(fill, static_cast<double>(sample.buffers) / sample.max_buffers);
+  }
+  if (sample.max_bytes > 0) {
+    fill = MAX(fill, static_cast<double>(sample.bytes) / sample.max_bytes);
+  }
+  if (sample.max_time > 0) {
+    fill = MAX(fill, static_cast<double>(sample.time) / sample.max_time);
+  }
+  return MIN(fill, 1.0);
+}
+
+// Elements directly downstream of element, looking through ghost pads of bins
+static std::vector<GstElement *> downstream_elements(GstElement *element) {
+  std::vector<GstElement *> result;
+
+  GstIterator *it = gst_element_iterate_src_pads(element);
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK: {
+        GstPad *peer = gst_pad_get_peer(GST_PAD(g_value_get_object(&item)));
+        while (peer) {
+          if (GST_IS_GHOST_PAD(peer)) {
+            // Entering a bin
+            GstPad *target = gst_ghost_pad_get_target(GST_GHOST_PAD(peer));
+            gst_object_unref(peer);
+            peer = target;
+            continue;
+          }
+
+          GstObject *parent = gst_pad_get_parent(peer);
+          gst_object_unref(peer);
+          peer = nullptr;
+          if (parent && GST_IS_GHOST_PAD(parent)) {
+            // Leaving a bin through the internal pad of a ghost src pad
+            peer = gst_pad_get_peer(GST_PAD(parent));
+            gst_object_unref(parent);
+          } else if (parent && GST_IS_ELEMENT(parent)) {
+            result.push_back(GST_ELEMENT(parent));
+          } else if (parent) {
+            gst_object_unref(parent);
+          }
+        }
+        g_value_reset(&item);
+        break;
+      }
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync(it);
+        break;
+      default:
+        done = true;
+        break;
+    }
+  }
+
+  g_value_unset(&item);
+  gst_iterator_free(it);
+  return result;
+}
+
+// Walk downstream of a saturated queue. Returns false if another saturated queue is found,
+// otherwise sets suspect to the first non-queue element reached.
+static bool find_suspect(
+  GstElement *queue, const std::set<GstElement *> &saturated, std::string &suspect
+) {
+  std::vector<GstElement *> pending = downstream_elements(queue);
+  std::set<GstElement *> visited;
+  bool is_last = true;
+
+  // Bounded so a pathological graph can't stall the sampler
+  for (size_t i = 0; i < pending.size() && i < 256; i++) {
+    GstElement *element = pending[i];
+    if (!visited.insert(element).second) {
+      continue;
+    }
+    if (saturated.count(element)) {
+      is_last = false;
+      break;
+    }
+    if (suspect.empty() && !is_queue(element)) {
+      suspect = GST_OBJECT_NAME(element);
+    }
+    std::vector<GstElement *> next = downstream_elements(element);
+    pending.insert(pending.end(), next.begin(), next.end());
+  }
+
+  for (GstElement *element : pending) {
+    gst_object_unref(element);
+  }
+  return is_last;
+}
+
+static void on_underrun(GstElement *element, gpointer user_data) {
+  auto &queue = *static_cast<std::shared_ptr<MonitoredQueue> *>(user_data);
+  queue->underruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void on_overrun(GstElement *element, gpointer user_data) {
+  auto &queue = *static_cast<std::shared_ptr<MonitoredQueue> *>(user_data);
+  queue->overruns.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void delete_queue_ref(gpointer data, GClosure *) {
+  delete static_cast<std::shared_ptr<MonitoredQueue> *>(data);
+}
+
+// Called with state->mutex held
+static void add_queue(const std::shared_ptr<QueueMonitorState> &state, GstElement *element) {
+  if (!is_queue(element)) {
+    return;
+  }
+  for (auto &queue : state->queues) {
+    if (queue->element == element) {
+      return;
+    }
+  }
+
+  auto queue = std::make_shared<MonitoredQueue>();
+  queue->element = GST_ELEMENT(gst_object_ref(element));
+  queue->name = GST_OBJECT_NAME(element);
+  queue->factory = GST_OBJECT_NAME(gst_element_get_factory(element));
+
+  // queue and multiqueue emit these, queue2 doesn't
+  GType type = G_OBJECT_TYPE(element);
+  if (g_signal_lookup("underrun", type)) {
+    queue->handlers.push_back(g_signal_connect_data(
+      element, "underrun", G_CALLBACK(on_underrun), new std::shared_ptr<MonitoredQueue>(queue),
+      delete_queue_ref, static_cast<GConnectFlags>(0)
+    ));
+  }
+  if (g_signal_lookup("overrun", type)) {
+    queue->handlers.push_back(g_signal_connect_data(
+      element, "overrun", G_CALLBACK(on_overrun), new std::shared_ptr<MonitoredQueue>(queue),
+      delete_queue_ref, static_cast<GConnectFlags>(0)
+    ));
+  }
+
+  state->queues.push_back(queue);
+}
+
+static void
+on_deep_element_added(GstBin *pipeline, GstBin *bin, GstElement *element, gpointer user_data) {
+  auto &state = *static_cast<std::shared_ptr<QueueMonitorState> *>(user_data);
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (state->running) {
+    add_queue(state, element);
+  }
+}
+
+std::shared_ptr<QueueMonitor> QueueMonitor::start(
+  GstPipeline *pipeline, Napi::ThreadSafeFunction callback, std::chrono::milliseconds interval,
+  size_t history_length, double saturation
+) {
+  std::shared_ptr<QueueMonitor> monitor(new QueueMonitor());
+  monitor->pipeline = GST_PIPELINE(gst_object_ref(pipeline));
+  monitor->state = std::make_shared<QueueMonitorState>();
+  monitor->callback = callback;
+  monitor->interval = interval;
+  monitor->history_length = history_length;
+  monitor->saturation = saturation;
+
+  std::shared_ptr<QueueMonitorState> &state = monitor->state;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+
+    GstIterator *it = gst_bin_iterate_recurse(GST_BIN(pipeline));
+    GValue item = G_VALUE_INIT;
+    bool done = false;
+
+    while (!done) {
+      switch (gst_iterator_next(it, &item)) {
+        case GST_ITERATOR_OK:
+          add_queue(state, GST_ELEMENT(g_value_get_object(&item)));
+          g_value_reset(&item);
+          break;
+        case GST_ITERATOR_RESYNC:
+          gst_iterator_resync(it);
+          break;
+        default:
+          done = true;
+          break;
+      }
+    }
+
+    g_value_unset(&item);
+    gst_iterator_free(it);
+  }
+
+  // Queues created later by decodebin, playbin or addBin() are picked up as they appear
+  monitor->element_added_handler = g_signal_connect_data(
+    pipeline, "deep-element-added", G_CALLBACK(on_deep_element_added),
+    new std::shared_ptr<QueueMonitorState>(state),
+    [](gpointer data, GClosure *) {
+      delete static_cast<std::shared_ptr<QueueMonitorState> *>(data);
+    },
+    static_cast<GConnectFlags>(0)
+  );
+
+  monitor->thread = std::thread([raw = monitor.get()]() { raw->run(); });
+  return monitor;
+}
+
+QueueMonitor::~QueueMonitor() {
+  stop();
+  gst_object_unref(pipeline);
+}
+
+void QueueMonitor::stop() {
+  {
+    std::lock_guard<std::mutex> lock(thread_mutex);
+    if (stopping) {
+      return;
+    }
+    stopping = true;
+  }
+  wake.notify_all();
+  if (thread.joinable()) {
+    thread.join();
+  }
+
+  g_signal_handler_disconnect(pipeline, element_added_handler);
+
+  std::vector<std::shared_ptr<MonitoredQueue>> queues;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->running = false;
+    queues.swap(state->queues);
+  }
+  for (auto &queue : queues) {
+    for (gulong handler : queue->handlers) {
+      g_signal_handler_disconnect(queue->element, handler);
+    }
+  }
+
+  callback.Release();
+}
+
+void QueueMonitor::run() {
+  std::unique_lock<std::mutex> lock(thread_mutex);
+  while (!wake.wait_for(lock, interval, [this] { return stopping; })) {
+    lock.unlock();
+    QueueBatch *batch = new QueueBatch(sample());
+
+    napi_status status = callback.NonBlockingCall(
+      batch,
+      [](Napi::Env env, Napi::Function js_callback, QueueBatch *batch) {
+        Napi::Array queues = Napi::Array::New(env, batch->queues.size());
+        for (size_t i = 0; i < batch->queues.size(); i++) {
+          const QueueSample &sample = batch->queues[i];
+          Napi::Object queue = Napi::Object::New(env);
+          queue.Set("name", Napi::String::New(env, sample.name));
+          queue.Set("element", Napi::String::New(env, sample.element));
+          queue.Set("factory", Napi::String::New(env, sample.factory));
+          queue.Set("fill", Napi::Number::New(env, sample.fill));
+
+          Napi::Object level = Napi::Object::New(env);
+          level.Set("buffers", Napi::Number::New(env, static_cast<double>(sample.buffers)));
+          level.Set("bytes", Napi::Number::New(env, static_cast<double>(sample.bytes)));
+          level.Set("time", Napi::Number::New(env, static_cast<double>(sample.time)));
+          queue.Set("level", level);
+
+          Napi::Object limits = Napi::Object::New(env);
+          limits.Set("buffers", Napi::Number::New(env, static_cast<double>(sample.max_buffers)));
+          limits.Set("bytes", Napi::Number::New(env, static_cast<double>(sample.max_bytes)));
+          limits.Set("time", Napi::Number::New(env, static_cast<double>(sample.max_time)));
+          queue.Set("limits", limits);
+
+          queue.Set("underruns", Napi::Number::New(env, static_cast<double>(sample.underruns)));
+          queue.Set("overruns", Napi::Number::New(env, static_cast<double>(sample.overruns)));
+
+          Napi::Float64Array history = Napi::Float64Array::New(env, sample.history.size());
+          for (size_t j = 0; j < sample.history.size(); j++) {
+            history[j] = sample.history[j];
+          }
+          queue.Set("history", history);
+
+          queues.Set(static_cast<uint32_t>(i), queue);
+        }
+
+        Napi::Object result = Napi::Object::New(env);
+        result.Set("timestamp", Napi::Number::New(env, static_cast<double>(batch->timestamp_ms)));
+        result.Set("queues", queues);
+
+        if (batch->has_bottleneck) {
+          Napi::Object bottleneck = Napi::Object::New(env);
+          bottleneck.Set("queue", Napi::String::New(env, batch->bottleneck_queue));
+          bottleneck.Set(
+            "suspect", batch->bottleneck_suspect.empty()
+                         ? env.Null()
+                         : Napi::String::New(env, batch->bottleneck_suspect)
+          );
+          bottleneck.Set("fill", Napi::Number::New(env, batch->bottleneck_fill));
+          result.Set("bottleneck", bottleneck);
+        } else {
+          result.Set("bottleneck", env.Null());
+        }
+
+        delete batch;
+        js_callback.Call({result});
+      }
+    );
+    if (status != napi_ok) {
+      delete batch;
+    }
+
+    lock.lock();
+  }
+}
+
+QueueBatch QueueMonitor::sample() {
+  std::vector<std::shared_ptr<MonitoredQueue>> queues;
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    queues = state->queues;
+  }
+
+  QueueBatch batch;
+  batch.timestamp_ms = g_get_real_time() / 1000;
+
+  std::map<GstElement *, double> element_fill;
+
+  for (auto &queue : queues) {
+    GObject *object = G_OBJECT(queue->element);
+    std::vector<QueueSample> samples;
+
+    QueueSample base;
+    base.element = queue->name;
+    base.factory = queue->factory;
+    base.underruns = queue->underruns.load(std::memory_order_relaxed);
+    base.overruns = queue->overruns.load(std::memory_order_relaxed);
+    read_limits(object, base);
+
+    if (read_levels(object, base)) {
+      base.name = queue->name;
+      samples.push_back(base);
+    } else {
+      // multiqueue reports levels on each of its source pads (GStreamer 1.18+)
+      GstIterator *it = gst_element_iterate_src_pads(queue->element);
+      GValue item = G_VALUE_INIT;
+      bool done = false;
+
+      while (!done) {
+        switch (gst_iterator_next(it, &item)) {
+          case GST_ITERATOR_OK: {
+            GstPad *pad = GST_PAD(g_value_get_object(&item));
+            QueueSample pad_sample = base;
+            if (read_levels(G_OBJECT(pad), pad_sample)) {
+              pad_sample.name = queue->name + ":" + GST_OBJECT_NAME(pad);
+              samples.push_back(pad_sample);
+            }
+            g_value_reset(&item);
+            break;
+          }
+          case GST_ITERATOR_RESYNC:
+            gst_iterator_resync(it);
+            samples.clear();
+            break;
+          default:
+            done = true;
+            break;
+        }
+      }
+
+      g_value_unset(&item);
+      gst_iterator_free(it);
+
+      if (samples.empty()) {
+        // No per-pad levels on this version, counters are still useful
+        base.name = queue->name;
+        samples.push_back(base);
+      }
+    }
+
+    for (QueueSample &sample : samples) {
+      sample.fill = fill_ratio(sample);
+      element_fill[queue->element] = MAX(element_fill[queue->element], sample.fill);
+
+      // Only the sampler thread touches the history
+      std::deque<double> &history = queue->history[sample.name];
+      history.push_back(sample.fill);
+      while (history.size() > history_length) {
+        history.pop_front();
+      }
+      sample.history.assign(history.begin(), history.end());
+
+      batch.queues.push_back(std::move(sample));
+    }
+  }
+
+  std::set<GstElement *> saturated;
+  for (auto &[element, fill] : element_fill) {
+    if (fill >= saturation) {
+      saturated.insert(element);
+    }
+  }
+
+  // A full queue means whatever it feeds is too slow; the one closest to the sinks is
+  // the one that starts the backpressure
+  for (GstElement *element : saturated) {
+    std::string suspect;
+    if (!find_suspect(element, saturated, suspect)) {
+      continue;
+    }
+    double fill = element_fill[element];
+    if (!batch.has_bottleneck || fill > batch.bottleneck_fill) {
+      batch.has_bottleneck = true;
+      batch.bottleneck_queue = GST_OBJECT_NAME(element);
+      batch.bottleneck_suspect = suspect;
+      batch.bottleneck_fill = fill;
+    }
+  }
+
+  return batch;
+}
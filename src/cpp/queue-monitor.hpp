@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <gst/gst.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// A queue, queue2 or multiqueue being watched. Shared with its signal handlers so the
+// counters stay valid while a handler is still running on a streaming thread.
+struct MonitoredQueue {
+  GstElement *element;
+  std::string name;
+  std::string factory;
+  std::atomic<uint64_t> underruns{0};
+  std::atomic<uint64_t> overruns{0};
+  std::vector<gulong> handlers;
+  // Fill history per reported entry (the element, or element:pad for multiqueue)
+  std::map<std::string, std::deque<double>> history;
+
+  ~MonitoredQueue();
+};
+
+// One queue (or one multiqueue single queue) in a batch
+struct QueueSample {
+  std::string name;
+  std::string element;
+  std::string factory;
+  double fill = 0;
+  guint64 buffers = 0, bytes = 0, time = 0;
+  guint64 max_buffers = 0, max_bytes = 0, max_time = 0;
+  uint64_t underruns = 0, overruns = 0;
+  std::vector<double> history;
+};
+
+struct QueueBatch {
+  gint64 timestamp_ms;
+  std::vector<QueueSample> queues;
+  // Most downstream saturated queue and the element it feeds
+  bool has_bottleneck = false;
+  std::string bottleneck_queue;
+  std::string bottleneck_suspect;
+  double bottleneck_fill = 0;
+};
+
+struct QueueMonitorState {
+  std::mutex mutex;
+  std::vector<std::shared_ptr<MonitoredQueue>> queues;
+  bool running = true;
+};
+
+// Samples the fill level of every queue in a pipeline on a background thread and delivers
+// one batch per interval to JavaScript, with underrun/overrun counts, fill history and a
+// bottleneck guess.
+class QueueMonitor {
+public:
+  static std::shared_ptr<QueueMonitor> start(
+    GstPipeline *pipeline, Napi::ThreadSafeFunction callback, std::chrono::milliseconds interval,
+    size_t history_length, double saturation
+  );
+
+  ~QueueMonitor();
+
+  void stop();
+
+private:
+  QueueMonitor() = default;
+  void run();
+  QueueBatch sample();
+
+  GstPipeline *pipeline = nullptr;
+  gulong element_added_handler = 0;
+  std::shared_ptr<QueueMonitorState> state;
+  Napi::ThreadSafeFunction callback;
+  std::chrono::milliseconds interval;
+  size_t history_length;
+  double saturation;
+
+  std::thread thread;
+  std::mutex thread_mutex;
+  std::condition_variable wake;
+  bool stopping = false;
+};
@@ -0,0 +1,261 @@
+#include "sample-dispatcher.hpp"
+#include "type-conversion.hpp"
+#include <algorithm>
+
+static GQuark dispatcher_quark() {
+  static GQuark quark = g_quark_from_static_string("gst-kit-sample-dispatcher");
+  return quark;
+}
+
+// Stream time of a sample for rate limiting, or the wall clock when the buffer has no timestamp
+static GstClockTime sample_time(GstSample *sample) {
+  GstBuffer *buffer = gst_sample_get_buffer(sample);
+  if (buffer && GST_BUFFER_PTS_IS_VALID(buffer)) {
+    return GST_BUFFER_PTS(buffer);
+  }
+  return static_cast<GstClockTime>(g_get_monotonic_time()) * GST_USECOND;
+}
+
+std::shared_ptr<SampleDispatcher> SampleDispatcher::for_app_sink(GstAppSink *app_sink) {
+  gpointer data = g_object_get_qdata(G_OBJECT(app_sink), dispatcher_quark());
+  if (data) {
+    return *static_cast<std::shared_ptr<SampleDispatcher> *>(data);
+  }
+
+  std::shared_ptr<SampleDispatcher> dispatcher(new SampleDispatcher(app_sink));
+  g_object_set_qdata_full(
+    G_OBJECT(app_sink), dispatcher_quark(), new std::shared_ptr<SampleDispatcher>(dispatcher),
+    [](gpointer data) { delete static_cast<std::shared_ptr<SampleDispatcher> *>(data); }
+  );
+  return dispatcher;
+}
+
+guint64 SampleDispatcher::subscribe(
+  const Napi::Env &env, const Napi::Function &callback, const SampleSubscriptionOptions &options
+) {
+  auto subscriber = std::make_shared<Subscriber>();
+  subscriber->min_interval =
+    options.max_fps > 0 ? static_cast<GstClockTime>(GST_SECOND / options.max_fps) : 0;
+  subscriber->max_pending = options.max_pending;
+  subscriber->drop_oldest = options.drop_oldest;
+  subscriber->latest_only = options.latest_only;
+  subscriber->cadence_us = static_cast<gint64>(subscriber->min_interval / GST_USECOND);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  subscriber->id = next_id++;
+  callbacks[subscriber->id] = Napi::Persistent(callback);
+
+  if (subscribers.empty()) {
+    // Keeps the process alive while anyone is subscribed, like a callback of its own would
+    tsfn = Napi::ThreadSafeFunction::New(
+      env, Napi::Function::New(env, [](const Napi::CallbackInfo &) {}), "SampleDispatcher", 0, 1
+    );
+    g_object_set(app_sink, "emit-signals", TRUE, nullptr);
+    signal_id = g_signal_connect_data(
+      app_sink, "new-sample", G_CALLBACK(on_new_sample),
+      new std::weak_ptr<SampleDispatcher>(shared_from_this()),
+      [](gpointer data, GClosure *) {
+        delete static_cast<std::weak_ptr<SampleDispatcher> *>(data);
+      },
+      static_cast<GConnectFlags>(0)
+    );
+  }
+  subscribers.push_back(subscriber);
+  return subscriber->id;
+}
+
+void SampleDispatcher::unsubscribe(guint64 id) {
+  if (callbacks.erase(id) == 0) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = std::find_if(subscribers.begin(), subscribers.end(), [id](const auto &subscriber) {
+    return subscriber->id == id;
+  });
+  if (it == subscribers.end()) {
+    return;
+  }
+  // Samples already queued for it are skipped on arrival
+  (*it)->active = false;
+  subscribers.erase(it);
+
+  if (subscribers.empty()) {
+    // A signal emission already running finds no subscribers and drops its sample
+    g_signal_handler_disconnect(app_sink, signal_id);
+    signal_id = 0;
+    tsfn.Release();
+    converted.Reset();
+  }
+}
+
+GstFlowReturn SampleDispatcher::on_new_sample(GstAppSink *app_sink, gpointer user_data) {
+  GstSample *sample = gst_app_sink_try_pull_sample(app_sink, 0); // Non-blocking
+  if (!sample) {
+    return GST_FLOW_OK;
+  }
+
+  auto *weak = static_cast<std::weak_ptr<SampleDispatcher> *>(user_data);
+  if (std::shared_ptr<SampleDispatcher> dispatcher = weak->lock()) {
+    dispatcher->dispatch(sample);
+  } else {
+    gst_sample_unref(sample);
+  }
+  return GST_FLOW_OK;
+}
+
+void SampleDispatcher::dispatch(GstSample *sample) {
+  GstClockTime time = sample_time(sample);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  guint64 seq = next_seq++;
+  Targets targets;
+  std::vector<std::pair<std::shared_ptr<Subscriber>, gint64>> mail; // Mailboxes to schedule
+  for (const std::shared_ptr<Subscriber> &subscriber : subscribers) {
+    if (subscriber->latest_only) {
+      // The sample it replaces is dropped without ever being converted
+      if (subscriber->mailbox) {
+        gst_sample_unref(subscriber->mailbox);
+      }
+      subscriber->mailbox = gst_sample_ref(sample);
+      subscriber->mailbox_seq = seq;
+      if (!subscriber->scheduled) {
+        subscriber->scheduled = true;
+        gint64 next_us = subscriber->last_delivery_us + subscriber->cadence_us;
+        mail.emplace_back(subscriber, MAX(next_us - g_get_monotonic_time(), 0));
+      }
+      continue;
+    }
+
+    // Time going backwards means a seek or a new segment, start the rate limit over
+    if (subscriber->min_interval > 0 && GST_CLOCK_TIME_IS_VALID(subscriber->last_time) &&
+        time >= subscriber->last_time && time - subscriber->last_time < subscriber->min_interval) {
+      continue;
+    }
+    if (subscriber->max_pending > 0 && subscriber->pending.size() >= subscriber->max_pending) {
+      if (!subscriber->drop_oldest) {
+        continue;
+      }
+      subscriber->pending.pop_front();
+    }
+    subscriber->last_time = time;
+    subscriber->pending.push_back(seq);
+    targets.push_back(subscriber);
+  }
+
+  auto self = shared_from_this();
+  for (const auto &[subscriber, delay_us] : mail) {
+    napi_status status = tsfn.NonBlockingCall(
+      [self, subscriber, delay_us](Napi::Env env, Napi::Function) {
+        if (delay_us == 0) {
+          self->deliver_latest(env, subscriber);
+          return;
+        }
+
+        // Keep the cadence: deliver whatever is newest once the interval has passed
+        auto deliver = Napi::Function::New(env, [self, subscriber](const Napi::CallbackInfo &info) {
+          self->deliver_latest(info.Env(), subscriber);
+        });
+        Napi::Function set_timeout = env.Global().Get("setTimeout").As<Napi::Function>();
+        set_timeout.Call({deliver, Napi::Number::New(env, static_cast<double>(delay_us) / 1000)});
+      }
+    );
+    if (status != napi_ok) {
+      subscriber->scheduled = false;
+    }
+  }
+
+  if (targets.empty()) {
+    gst_sample_unref(sample);
+    return;
+  }
+
+  napi_status status =
+    tsfn.NonBlockingCall([self, sample, seq, targets](Napi::Env env, Napi::Function) {
+      self->deliver(env, sample, seq, targets);
+      gst_sample_unref(sample);
+    });
+  if (status != napi_ok) {
+    // The environment is going away
+    for (const std::shared_ptr<Subscriber> &subscriber : targets) {
+      subscriber->pending.erase(
+        std::remove(subscriber->pending.begin(), subscriber->pending.end(), seq),
+        subscriber->pending.end()
+      );
+    }
+    gst_sample_unref(sample);
+  }
+}
+
+void SampleDispatcher::deliver(
+  Napi::Env env, GstSample *sample, guint64 seq, const Targets &targets
+) {
+  std::vector<guint64> ids;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const std::shared_ptr<Subscriber> &subscriber : targets) {
+      // Gone from the queue when a newer sample pushed it out
+      auto it = std::find(subscriber->pending.begin(), subscriber->pending.end(), seq);
+      if (it == subscriber->pending.end()) {
+        continue;
+      }
+      subscriber->pending.erase(it);
+      if (subscriber->active) {
+        ids.push_back(subscriber->id);
+      }
+    }
+  }
+  if (ids.empty()) {
+    return;
+  }
+
+  Napi::Object js_sample = materialize(env, sample, seq);
+  for (guint64 id : ids) {
+    // A callback may unsubscribe the ones after it
+    auto it = callbacks.find(id);
+    if (it == callbacks.end()) {
+      continue;
+    }
+    Napi::Function callback = it->second.Value();
+    callback.Call({js_sample});
+    if (env.IsExceptionPending()) {
+      break;
+    }
+  }
+}
+
+void SampleDispatcher::deliver_latest(
+  Napi::Env env, const std::shared_ptr<Subscriber> &subscriber
+) {
+  GstSample *sample;
+  guint64 seq;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    sample = subscriber->mailbox;
+    seq = subscriber->mailbox_seq;
+    subscriber->mailbox = nullptr;
+    subscriber->scheduled = false;
+    subscriber->last_delivery_us = g_get_monotonic_time();
+  }
+  if (!sample) {
+    return;
+  }
+
+  auto it = callbacks.find(subscriber->id);
+  if (subscriber->active && it != callbacks.end()) {
+    Napi::Function callback = it->second.Value();
+    callback.Call({materialize(env, sample, seq)});
+  }
+  gst_sample_unref(sample);
+}
+
+// Subscribers handed the same sample at different times still share one JS object
+Napi::Object SampleDispatcher::materialize(Napi::Env env, GstSample *sample, guint64 seq) {
+  if (!converted.IsEmpty() && converted_seq == seq) {
+    return converted.Value();
+  }
+  Napi::Object js_sample = TypeConversion::gst_sample_to_js(env, sample);
+  converted = Napi::Persistent(js_sample);
+  converted_seq = seq;
+  return js_sample;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <deque>
+#include <gst/app/gstappsink.h>
+#include <gst/gst.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <vector>
+
+struct SampleSubscriptionOptions {
+  double max_fps = 0; // Samples per second at most, 0 for every sample
+  size_t max_pending = 0; // Samples queued for the JS thread at most, 0 for no limit
+  bool drop_oldest = false; // When max_pending is reached, drop the oldest queued sample instead
+  bool latest_only = false; // Keep only the newest sample and deliver it at max_fps wall-clock
+};
+
+// Fans the samples of one app sink out to every onSample() subscriber. Each sample is pulled
+// once and converted to a JS object once, on the JS thread, and only when at least one
+// subscriber still wants it; all subscribers are then called with that same object. Rate limits
+// and queue limits are applied per subscriber on the streaming thread, so dropped samples never
+// reach the JS thread. Latest-only subscribers instead keep the newest sample in a mailbox of
+// their own that is emptied on a fixed cadence; a sample replaced there is never converted.
+// Shared by every element handle of the sink.
+class SampleDispatcher : public std::enable_shared_from_this<SampleDispatcher> {
+public:
+  static std::shared_ptr<SampleDispatcher> for_app_sink(GstAppSink *app_sink);
+
+  /**
+   * Add a subscriber, connecting to the sink's new-sample signal for the first one
+   * @return An id for unsubscribe()
+   */
+  guint64 subscribe(
+    const Napi::Env &env, const Napi::Function &callback, const SampleSubscriptionOptions &options
+  );
+
+  // Remove a subscriber, disconnecting from the sink after the last one. JS thread only.
+  void unsubscribe(guint64 id);
+
+private:
+  struct Subscriber {
+    guint64 id;
+    GstClockTime min_interval;
+    size_t max_pending;
+    bool drop_oldest;
+    GstClockTime last_time = GST_CLOCK_TIME_NONE; // Of the last sample accepted
+    std::deque<guint64> pending; // Sequence numbers queued for the JS thread
+    bool active = true;
+
+    // Latest-only delivery
+    bool latest_only;
+    gint64 cadence_us;
+    GstSample *mailbox = nullptr;
+    guint64 mailbox_seq = 0;
+    bool scheduled = false; // A delivery of the mailbox is queued
+    gint64 last_delivery_us = 0;
+
+    ~Subscriber() {
+      if (mailbox) {
+        gst_sample_unref(mailbox);
+      }
+    }
+  };
+
+  using Targets = std::vector<std::shared_ptr<Subscriber>>;
+
+  explicit SampleDispatcher(GstAppSink *app_sink) : app_sink(app_sink) {}
+  static GstFlowReturn on_new_sample(GstAppSink *app_sink, gpointer user_data);
+  void dispatch(GstSample *sample);
+  void deliver(Napi::Env env, GstSample *sample, guint64 seq, const Targets &targets);
+  void deliver_latest(Napi::Env env, const std::shared_ptr<Subscriber> &subscriber);
+  Napi::Object materialize(Napi::Env env, GstSample *sample, guint64 seq);
+
+  GstAppSink *app_sink; // Not owned, the dispatcher lives in the sink's qdata
+  std::mutex mutex;
+  std::vector<std::shared_ptr<Subscriber>> subscribers;
+  Napi::ThreadSafeFunction tsfn; // Valid while there are subscribers
+  gulong signal_id = 0;
+  guint64 next_id = 1;
+  guint64 next_seq = 0;
+  std::map<guint64, Napi::FunctionReference> callbacks; // JS thread only
+  Napi::ObjectReference converted; // The last sample converted, JS thread only
+  guint64 converted_seq = 0;
+};
@@ -0,0 +1,245 @@
+#include "samples.hpp"
+#include "async-workers.hpp"
+#include "encoder-pool.hpp"
+#include "pipeline.hpp"
+#include <algorithm>
+#include <cmath>
+#include <regex>
+
+namespace Samples {
+  void Init(const Napi::Env &env, Napi::Object exports) {
+    exports.Set("convertSample", Napi::Function::New(env, convert_sample, "convertSample"));
+    exports.Set("encodeSample", Napi::Function::New(env, encode_sample, "encodeSample"));
+  }
+
+  GstCaps *caps_from_js(const Napi::Object &caps, std::string &error) {
+    if (!caps.Get("name").IsString()) {
+      error = "Sample caps have no name";
+      return nullptr;
+    }
+
+    // gst_sample_to_js turns fractions into "n/d" strings, everything else maps back directly
+    static const std::regex fraction("^(-?\\d+)/(\\d+)$");
+
+    std::string name = caps.Get("name").As<Napi::String>().Utf8Value();
+    GstStructure *structure = gst_structure_new_empty(name.c_str());
+    Napi::Array keys = caps.GetPropertyNames();
+    for (uint32_t i = 0; i < keys.Length(); i++) {
+      std::string key = keys.Get(i).As<Napi::String>().Utf8Value();
+      Napi::Value value = caps.Get(key);
+      if (key == "name") {
+        continue;
+      }
+
+      GValue gvalue = G_VALUE_INIT;
+      std::smatch match;
+      if (value.IsString()) {
+        std::string text = value.As<Napi::String>().Utf8Value();
+        if (std::regex_match(text, match, fraction)) {
+          g_value_init(&gvalue, GST_TYPE_FRACTION);
+          gst_value_set_fraction(&gvalue, std::stoi(match[1].str()), std::stoi(match[2].str()));
+        } else {
+          g_value_init(&gvalue, G_TYPE_STRING);
+          g_value_set_string(&gvalue, text.c_str());
+        }
+      } else if (value.IsNumber()) {
+        double number = value.As<Napi::Number>().DoubleValue();
+        if (std::floor(number) == number && std::fabs(number) <= G_MAXINT) {
+          g_value_init(&gvalue, G_TYPE_INT);
+          g_value_set_int(&gvalue, static_cast<gint>(number));
+        } else {
+          g_value_init(&gvalue, G_TYPE_DOUBLE);
+          g_value_set_double(&gvalue, number);
+        }
+      } else if (value.IsBoolean()) {
+        g_value_init(&gvalue, G_TYPE_BOOLEAN);
+        g_value_set_boolean(&gvalue, value.As<Napi::Boolean>().Value());
+      } else {
+        // Lists and ranges don't occur in the fixed caps of a sample
+        continue;
+      }
+      gst_structure_take_value(structure, key.c_str(), &gvalue);
+    }
+
+    GstCaps *result = gst_caps_new_empty();
+    gst_caps_append_structure(result, structure);
+    return result;
+  }
+
+  bool video_sample_from_js(
+    const Napi::Value &value, GstVideoInfo *info, Napi::Buffer<uint8_t> *buffer,
+    std::string &error
+  ) {
+    if (!value.IsObject()) {
+      error = "Expected a sample object";
+      return false;
+    }
+    Napi::Object sample = value.As<Napi::Object>();
+    if (!sample.Get("buffer").IsBuffer() || !sample.Get("caps").IsObject()) {
+      error = "Sample must have a buffer and caps";
+      return false;
+    }
+
+    GstCaps *caps = caps_from_js(sample.Get("caps").As<Napi::Object>(), error);
+    if (!caps) {
+      return false;
+    }
+    bool parsed = gst_video_info_from_caps(info, caps);
+    gst_caps_unref(caps);
+    if (!parsed) {
+      error = "Sample is not raw video";
+      return false;
+    }
+
+    *buffer = sample.Get("buffer").As<Napi::Buffer<uint8_t>>();
+    if (buffer->Length() < GST_VIDEO_INFO_SIZE(info)) {
+      error = "Sample buffer is smaller than its caps describe";
+      return false;
+    }
+    return true;
+  }
+
+  Napi::Value convert_sample(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    Pipeline::ensure_gst_initialized();
+
+    GstVideoInfo in_info;
+    Napi::Buffer<uint8_t> input;
+    std::string error;
+    if (info.Length() < 1 || !video_sample_from_js(info[0], &in_info, &input, error)) {
+      Napi::TypeError::New(env, "convertSample(): " + (error.empty() ? "Expected a sample" : error))
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Object options =
+      info.Length() > 1 && info[1].IsObject() ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+
+    GstVideoFormat format = GST_VIDEO_INFO_FORMAT(&in_info);
+    if (options.Get("format").IsString()) {
+      std::string format_name = options.Get("format").As<Napi::String>().Utf8Value();
+      format = gst_video_format_from_string(format_name.c_str());
+      if (format == GST_VIDEO_FORMAT_UNKNOWN) {
+        Napi::TypeError::New(env, "Unknown video format: " + format_name)
+          .ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+
+    // Source rectangle, the whole frame unless cropped
+    gint in_width = GST_VIDEO_INFO_WIDTH(&in_info);
+    gint in_height = GST_VIDEO_INFO_HEIGHT(&in_info);
+    gint crop_x = 0, crop_y = 0, crop_width = in_width, crop_height = in_height;
+    if (options.Get("crop").IsObject()) {
+      Napi::Object crop = options.Get("crop").As<Napi::Object>();
+      auto read = [&crop](const char *key, gint fallback) {
+        Napi::Value value = crop.Get(key);
+        return value.IsNumber() ? value.As<Napi::Number>().Int32Value() : fallback;
+      };
+      crop_x = read("x", 0);
+      crop_y = read("y", 0);
+      // Checked one value at a time, sums of unchecked input could overflow
+      bool inside = crop_x >= 0 && crop_y >= 0 && crop_x < in_width && crop_y < in_height;
+      if (inside) {
+        crop_width = read("width", in_width - crop_x);
+        crop_height = read("height", in_height - crop_y);
+        inside = crop_width >= 1 && crop_height >= 1 && crop_width <= in_width - crop_x
+                 && crop_height <= in_height - crop_y;
+      }
+      if (!inside) {
+        Napi::TypeError::New(env, "crop must lie within the frame").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+
+    // A single dimension scales the other one to keep the aspect ratio of the source area
+    gint out_width = crop_width, out_height = crop_height;
+    bool has_width = options.Get("width").IsNumber();
+    bool has_height = options.Get("height").IsNumber();
+    if (has_width) {
+      out_width = options.Get("width").As<Napi::Number>().Int32Value();
+    }
+    if (has_height) {
+      out_height = options.Get("height").As<Napi::Number>().Int32Value();
+    }
+    if (has_width && !has_height) {
+      out_height = static_cast<gint>(std::lround(
+        static_cast<double>(out_width) * crop_height / crop_width
+      ));
+    } else if (has_height && !has_width) {
+      out_width = static_cast<gint>(std::lround(
+        static_cast<double>(out_height) * crop_width / crop_height
+      ));
+    }
+    if (out_width < 1 || out_height < 1) {
+      Napi::TypeError::New(env, "width and height must be >= 1").ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    guint threads = g_get_num_processors();
+    if (options.Get("threads").IsNumber()) {
+      threads = std::max(1u, options.Get("threads").As<Napi::Number>().Uint32Value());
+    }
+
+    GstVideoInfo out_info;
+    gst_video_info_set_format(&out_info, format, out_width, out_height);
+    GST_VIDEO_INFO_FPS_N(&out_info) = GST_VIDEO_INFO_FPS_N(&in_info);
+    GST_VIDEO_INFO_FPS_D(&out_info) = GST_VIDEO_INFO_FPS_D(&in_info);
+
+    GstStructure *config = gst_structure_new(
+      "GstVideoConverter", GST_VIDEO_CONVERTER_OPT_THREADS, G_TYPE_UINT, threads,
+      GST_VIDEO_CONVERTER_OPT_SRC_X, G_TYPE_INT, crop_x, GST_VIDEO_CONVERTER_OPT_SRC_Y,
+      G_TYPE_INT, crop_y, GST_VIDEO_CONVERTER_OPT_SRC_WIDTH, G_TYPE_INT, crop_width,
+      GST_VIDEO_CONVERTER_OPT_SRC_HEIGHT, G_TYPE_INT, crop_height, NULL
+    );
+
+    Napi::Value flags = info[0].As<Napi::Object>().Get("flags");
+    ConvertSampleWorker *worker = new ConvertSampleWorker(
+      env, input, in_info, out_info, config,
+      flags.IsNumber() ? flags.As<Napi::Number>().Uint32Value() : 0
+    );
+    worker->Queue();
+    return worker->GetPromise().Promise();
+  }
+
+  Napi::Value encode_sample(const Napi::CallbackInfo &info) {
+    Napi::Env env = info.Env();
+
+    Pipeline::ensure_gst_initialized();
+
+    GstVideoInfo video_info;
+    Napi::Buffer<uint8_t> input;
+    std::string error;
+    if (info.Length() < 1 || !video_sample_from_js(info[0], &video_info, &input, error)) {
+      Napi::TypeError::New(env, "encodeSample(): " + (error.empty() ? "Expected a sample" : error))
+        .ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    Napi::Object options =
+      info.Length() > 1 && info[1].IsObject() ? info[1].As<Napi::Object>() : Napi::Object::New(env);
+
+    std::string codec = "jpeg";
+    if (options.Get("codec").IsString()) {
+      codec = options.Get("codec").As<Napi::String>().Utf8Value();
+    }
+    if (!EncoderPool::available(codec, error)) {
+      Napi::TypeError::New(env, error).ThrowAsJavaScriptException();
+      return env.Undefined();
+    }
+
+    int quality = 85;
+    if (options.Get("quality").IsNumber()) {
+      quality = options.Get("quality").As<Napi::Number>().Int32Value();
+      if (quality < 0 || quality > 100) {
+        Napi::TypeError::New(env, "quality must be between 0 and 100").ThrowAsJavaScriptException();
+        return env.Undefined();
+      }
+    }
+
+    EncodeSampleWorker *worker = new EncodeSampleWorker(env, input, video_info, codec, quality);
+    worker->Queue();
+    return worker->GetPromise().Promise();
+  }
+} // namespace Samples
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <gst/video/video.h>
+#include <napi.h>
+#include <string>
+
+// Module-level functions working on sample objects from getSample()/onSample()
+namespace Samples {
+  void Init(const Napi::Env &env, Napi::Object exports);
+
+  /**
+   * Rebuild the caps of a sample object, e.g. { name: "video/x-raw", format: "I420", ... }
+   * @param caps The caps object of the sample
+   * @param error Set when the caps cannot be rebuilt
+   * @return New caps owned by the caller, or nullptr on error
+   */
+  GstCaps *caps_from_js(const Napi::Object &caps, std::string &error);
+
+  /**
+   * Read the video info and buffer of a raw video sample object
+   * @param value The sample object
+   * @param info Filled with the video info of the sample caps
+   * @param buffer Set to the sample's buffer, which holds at least info->size bytes
+   * @param error Set when the value is not a usable raw video sample
+   * @return true on success
+   */
+  bool video_sample_from_js(
+    const Napi::Value &value, GstVideoInfo *info, Napi::Buffer<uint8_t> *buffer,
+    std::string &error
+  );
+
+  Napi::Value convert_sample(const Napi::CallbackInfo &info);
+  Napi::Value encode_sample(const Napi::CallbackInfo &info);
+} // namespace Samples
@@ -0,0 +1,482 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// SSE2 is the x86-64 baseline and NEON the arm64 baseline, so those are picked at compile
+// time. AVX2 is not enabled by the build flags, so it is compiled per function with the
+// target attribute and selected at runtime when the CPU supports it.
+#if defined(__SSE2__) || defined(_M_X64)
+#define GST_KIT_SIMD_SSE2 1
+#include <emmintrin.h>
+#if defined(__GNUC__)
+#define GST_KIT_SIMD_AVX2 1
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define GST_KIT_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Simd {
+  // Absolute peak and sum of squares of a run of samples
+  struct PeakEnergy {
+    float peak = 0;
+    double energy = 0;
+  };
+
+  constexpr float S16_SCALE = 1.0f / 32768.0f;
+  constexpr float S32_SCALE = 1.0f / 2147483648.0f;
+
+  namespace scalar {
+    inline void s16_to_f32(const int16_t *src, float *dst, size_t n) {
+      for (size_t i = 0; i < n; i++) {
+        dst[i] = static_cast<float>(src[i]) * S16_SCALE;
+      }
+    }
+
+    inline void s32_to_f32(const int32_t *src, float *dst, size_t n) {
+      for (size_t i = 0; i < n; i++) {
+        dst[i] = static_cast<float>(src[i]) * S32_SCALE;
+      }
+    }
+
+    inline PeakEnergy peak_energy(const float *src, size_t n) {
+      PeakEnergy result;
+      for (size_t i = 0; i < n; i++) {
+        result.peak = std::max(result.peak, std::fabs(src[i]));
+        result.energy += static_cast<double>(src[i]) * src[i];
+      }
+      return result;
+    }
+
+    // Largest |y[i]| for y[i] = sum(taps[k] * src[i + k]), src holds n + tap_count - 1 samples
+    inline float max_abs_fir(const float *src, size_t n, const float *taps, size_t tap_count) {
+      float peak = 0;
+      for (size_t i = 0; i < n; i++) {
+        float sum = 0;
+        for (size_t k = 0; k < tap_count; k++) {
+          sum += taps[k] * src[i + k];
+        }
+        peak = std::max(peak, std::fabs(sum));
+      }
+      return peak;
+    }
+
+    // acc[i] += src[i], used to sum rows for box downscaling
+    inline void accumulate_u8(const uint8_t *src, uint16_t *acc, size_t n) {
+      for (size_t i = 0; i < n; i++) {
+        acc[i] = static_cast<uint16_t>(acc[i] + src[i]);
+      }
+    }
+
+    // Sum of absolute differences
+    inline uint64_t sad_u8(const uint8_t *a, const uint8_t *b, size_t n) {
+      uint64_t sum = 0;
+      for (size_t i = 0; i < n; i++) {
+        sum += a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
+      }
+      return sum;
+    }
+
+    inline float dot_f32(const float *a, const float *b, size_t n) {
+      float sum = 0;
+      for (size_t i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+      }
+      return sum;
+    }
+  } // namespace scalar
+
+#if GST_KIT_SIMD_SSE2
+  namespace sse2 {
+    inline __m128 abs_ps(__m128 v) {
+      return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+    }
+
+    inline float hmax_ps(__m128 v) {
+      v = _mm_max_ps(v, _mm_movehl_ps(v, v));
+      v = _mm_max_ss(v, _mm_shuffle_ps(v, v, 1));
+      return _mm_cvtss_f32(v);
+    }
+
+    inline double hsum_pd(__m128d v) {
+      return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+
+    inline void s16_to_f32(const int16_t *src, float *dst, size_t n) {
+      const __m128 scale = _mm_set1_ps(S16_SCALE);
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        // Sign extend by placing each sample in the upper half and shifting back down
+        __m128i low = _mm_srai_epi32(_mm_unpacklo_epi16(samples, samples), 16);
+        __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples, samples), 16);
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+        _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+      }
+      scalar::s16_to_f32(src + i, dst + i, n - i);
+    }
+
+    inline void s32_to_f32(const int32_t *src, float *dst, size_t n) {
+      const __m128 scale = _mm_set1_ps(S32_SCALE);
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(samples), scale));
+      }
+      scalar::s32_to_f32(src + i, dst + i, n - i);
+    }
+
+    inline PeakEnergy peak_energy(const float *src, size_t n) {
+      __m128 peak = _mm_setzero_ps();
+      __m128d energy_low = _mm_setzero_pd();
+      __m128d energy_high = _mm_setzero_pd();
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 v = _mm_loadu_ps(src + i);
+        peak = _mm_max_ps(peak, abs_ps(v));
+        __m128d low = _mm_cvtps_pd(v);
+        __m128d high = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        energy_low = _mm_add_pd(energy_low, _mm_mul_pd(low, low));
+        energy_high = _mm_add_pd(energy_high, _mm_mul_pd(high, high));
+      }
+      PeakEnergy tail = scalar::peak_energy(src + i, n - i);
+      tail.peak = std::max(tail.peak, hmax_ps(peak));
+      tail.energy += hsum_pd(_mm_add_pd(energy_low, energy_high));
+      return tail;
+    }
+
+    inline float max_abs_fir(const float *src, size_t n, const float *taps, size_t tap_count) {
+      __m128 peak = _mm_setzero_ps();
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        __m128 sum = _mm_setzero_ps();
+        for (size_t k = 0; k < tap_count; k++) {
+          sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(taps[k]), _mm_loadu_ps(src + i + k)));
+        }
+        peak = _mm_max_ps(peak, abs_ps(sum));
+      }
+      return std::max(hmax_ps(peak), scalar::max_abs_fir(src + i, n - i, taps, tap_count));
+    }
+
+    inline void accumulate_u8(const uint8_t *src, uint16_t *acc, size_t n) {
+      const __m128i zero = _mm_setzero_si128();
+      size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m128i *low = reinterpret_cast<__m128i *>(acc + i);
+        __m128i *high = reinterpret_cast<__m128i *>(acc + i + 8);
+        _mm_storeu_si128(low, _mm_add_epi16(_mm_loadu_si128(low), _mm_unpacklo_epi8(pixels, zero)));
+        _mm_storeu_si128(
+          high, _mm_add_epi16(_mm_loadu_si128(high), _mm_unpackhi_epi8(pixels, zero))
+        );
+      }
+      scalar::accumulate_u8(src + i, acc + i, n - i);
+    }
+
+    inline uint64_t sad_u8(const uint8_t *a, const uint8_t *b, size_t n) {
+      __m128i sum = _mm_setzero_si128();
+      size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i));
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(va, vb));
+      }
+      uint64_t lanes[2];
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), sum);
+      return lanes[0] + lanes[1] + scalar::sad_u8(a + i, b + i, n - i);
+    }
+
+    inline float dot_f32(const float *a, const float *b, size_t n) {
+      __m128 sum = _mm_setzero_ps();
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+      }
+      sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+      sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+      return _mm_cvtss_f32(sum) + scalar::dot_f32(a + i, b + i, n - i);
+    }
+  } // namespace sse2
+#endif
+
+#if GST_KIT_SIMD_AVX2
+  namespace avx2 {
+    __attribute__((target("avx2"))) inline __m256 abs_ps(__m256 v) {
+      return _mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+    }
+
+    __attribute__((target("avx2"))) inline float hmax_ps(__m256 v) {
+      __m128 half = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+      return sse2::hmax_ps(half);
+    }
+
+    __attribute__((target("avx2"))) inline void
+    s16_to_f32(const int16_t *src, float *dst, size_t n) {
+      const __m256 scale = _mm256_set1_ps(S16_SCALE);
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(values, scale));
+      }
+      scalar::s16_to_f32(src + i, dst + i, n - i);
+    }
+
+    __attribute__((target("avx2"))) inline void
+    s32_to_f32(const int32_t *src, float *dst, size_t n) {
+      const __m256 scale = _mm256_set1_ps(S32_SCALE);
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256i samples = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(samples), scale));
+      }
+      scalar::s32_to_f32(src + i, dst + i, n - i);
+    }
+
+    __attribute__((target("avx2"))) inline PeakEnergy peak_energy(const float *src, size_t n) {
+      __m256 peak = _mm256_setzero_ps();
+      __m256d energy_low = _mm256_setzero_pd();
+      __m256d energy_high = _mm256_setzero_pd();
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 v = _mm256_loadu_ps(src + i);
+        peak = _mm256_max_ps(peak, abs_ps(v));
+        __m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+        __m256d high = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+        energy_low = _mm256_add_pd(energy_low, _mm256_mul_pd(low, low));
+        energy_high = _mm256_add_pd(energy_high, _mm256_mul_pd(high, high));
+      }
+      __m256d energy = _mm256_add_pd(energy_low, energy_high);
+      __m128d energy_half =
+        _mm_add_pd(_mm256_castpd256_pd128(energy), _mm256_extractf128_pd(energy, 1));
+
+      PeakEnergy tail = scalar::peak_energy(src + i, n - i);
+      tail.peak = std::max(tail.peak, hmax_ps(peak));
+      tail.energy += sse2::hsum_pd(energy_half);
+      return tail;
+    }
+
+    __attribute__((target("avx2"))) inline float
+    max_abs_fir(const float *src, size_t n, const float *taps, size_t tap_count) {
+      __m256 peak = _mm256_setzero_ps();
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        __m256 sum = _mm256_setzero_ps();
+        for (size_t k = 0; k < tap_count; k++) {
+          __m256 tap = _mm256_set1_ps(taps[k]);
+          sum = _mm256_add_ps(sum, _mm256_mul_ps(tap, _mm256_loadu_ps(src + i + k)));
+        }
+        peak = _mm256_max_ps(peak, abs_ps(sum));
+      }
+      return std::max(hmax_ps(peak), scalar::max_abs_fir(src + i, n - i, taps, tap_count));
+    }
+
+    __attribute__((target("avx2"))) inline void
+    accumulate_u8(const uint8_t *src, uint16_t *acc, size_t n) {
+      size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        __m256i *sums = reinterpret_cast<__m256i *>(acc + i);
+        _mm256_storeu_si256(
+          sums, _mm256_add_epi16(_mm256_loadu_si256(sums), _mm256_cvtepu8_epi16(pixels))
+        );
+      }
+      scalar::accumulate_u8(src + i, acc + i, n - i);
+    }
+
+    __attribute__((target("avx2"))) inline uint64_t
+    sad_u8(const uint8_t *a, const uint8_t *b, size_t n) {
+      __m256i sum = _mm256_setzero_si256();
+      size_t i = 0;
+      for (; i + 32 <= n; i += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(va, vb));
+      }
+      uint64_t lanes[4];
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), sum);
+      return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sse2::sad_u8(a + i, b + i, n - i);
+    }
+
+    __attribute__((target("avx2"))) inline float dot_f32(const float *a, const float *b, size_t n) {
+      __m256 sum = _mm256_setzero_ps();
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+      }
+      __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+      half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+      half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+      return _mm_cvtss_f32(half) + scalar::dot_f32(a + i, b + i, n - i);
+    }
+  } // namespace avx2
+#endif
+
+#if GST_KIT_SIMD_NEON
+  namespace neon {
+    inline float hmax_ps(float32x4_t v) {
+      float lanes[4];
+      vst1q_f32(lanes, v);
+      return std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+    }
+
+    inline double hsum_ps(float32x4_t v) {
+      float lanes[4];
+      vst1q_f32(lanes, v);
+      return static_cast<double>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    inline void s16_to_f32(const int16_t *src, float *dst, size_t n) {
+      size_t i = 0;
+      for (; i + 8 <= n; i += 8) {
+        int16x8_t samples = vld1q_s16(src + i);
+        float32x4_t low = vcvtq_f32_s32(vmovl_s16(vget_low_s16(samples)));
+        float32x4_t high = vcvtq_f32_s32(vmovl_s16(vget_high_s16(samples)));
+        vst1q_f32(dst + i, vmulq_n_f32(low, S16_SCALE));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(high, S16_SCALE));
+      }
+      scalar::s16_to_f32(src + i, dst + i, n - i);
+    }
+
+    inline void s32_to_f32(const int32_t *src, float *dst, size_t n) {
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), S32_SCALE));
+      }
+      scalar::s32_to_f32(src + i, dst + i, n - i);
+    }
+
+    inline PeakEnergy peak_energy(const float *src, size_t n) {
+      // 32-bit ARM has no double lanes, so squares are summed in float over short runs
+      const size_t run = 1024;
+      float32x4_t peak = vdupq_n_f32(0);
+      double energy = 0;
+      size_t i = 0;
+      while (i + 4 <= n) {
+        float32x4_t sum = vdupq_n_f32(0);
+        size_t end = std::min(n & ~size_t(3), i + run);
+        for (; i < end; i += 4) {
+          float32x4_t v = vld1q_f32(src + i);
+          peak = vmaxq_f32(peak, vabsq_f32(v));
+          sum = vmlaq_f32(sum, v, v);
+        }
+        energy += hsum_ps(sum);
+      }
+      PeakEnergy tail = scalar::peak_energy(src + i, n - i);
+      tail.peak = std::max(tail.peak, hmax_ps(peak));
+      tail.energy += energy;
+      return tail;
+    }
+
+    inline float max_abs_fir(const float *src, size_t n, const float *taps, size_t tap_count) {
+      float32x4_t peak = vdupq_n_f32(0);
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        float32x4_t sum = vdupq_n_f32(0);
+        for (size_t k = 0; k < tap_count; k++) {
+          sum = vmlaq_n_f32(sum, vld1q_f32(src + i + k), taps[k]);
+        }
+        peak = vmaxq_f32(peak, vabsq_f32(sum));
+      }
+      return std::max(hmax_ps(peak), scalar::max_abs_fir(src + i, n - i, taps, tap_count));
+    }
+
+    inline void accumulate_u8(const uint8_t *src, uint16_t *acc, size_t n) {
+      size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+        uint8x16_t pixels = vld1q_u8(src + i);
+        vst1q_u16(acc + i, vaddw_u8(vld1q_u16(acc + i), vget_low_u8(pixels)));
+        vst1q_u16(acc + i + 8, vaddw_u8(vld1q_u16(acc + i + 8), vget_high_u8(pixels)));
+      }
+      scalar::accumulate_u8(src + i, acc + i, n - i);
+    }
+
+    inline uint64_t sad_u8(const uint8_t *a, const uint8_t *b, size_t n) {
+      uint32x4_t sum = vdupq_n_u32(0);
+      size_t i = 0;
+      for (; i + 16 <= n; i += 16) {
+        uint8x16_t difference = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+        sum = vpadalq_u16(sum, vpaddlq_u8(difference));
+      }
+      uint32_t lanes[4];
+      vst1q_u32(lanes, sum);
+      return static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3]
+             + scalar::sad_u8(a + i, b + i, n - i);
+    }
+
+    inline float dot_f32(const float *a, const float *b, size_t n) {
+      float32x4_t sum = vdupq_n_f32(0);
+      size_t i = 0;
+      for (; i + 4 <= n; i += 4) {
+        sum = vmlaq_f32(sum, vld1q_f32(a + i), vld1q_f32(b + i));
+      }
+      return static_cast<float>(hsum_ps(sum)) + scalar::dot_f32(a + i, b + i, n - i);
+    }
+  } // namespace neon
+#endif
+
+  inline bool has_avx2() {
+#if GST_KIT_SIMD_AVX2
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+#else
+    return false;
+#endif
+  }
+
+  // Name of the kernel set in use: "avx2", "sse2", "neon" or "scalar"
+  inline const char *backend() {
+#if GST_KIT_SIMD_SSE2
+    return has_avx2() ? "avx2" : "sse2";
+#elif GST_KIT_SIMD_NEON
+    return "neon";
+#else
+    return "scalar";
+#endif
+  }
+
+#if GST_KIT_SIMD_AVX2
+#define GST_KIT_SIMD_DISPATCH(function, ...)                                                       \
+  return has_avx2() ? avx2::function(__VA_ARGS__) : sse2::function(__VA_ARGS__)
+#elif GST_KIT_SIMD_SSE2
+#define GST_KIT_SIMD_DISPATCH(function, ...) return sse2::function(__VA_ARGS__)
+#elif GST_KIT_SIMD_NEON
+#define GST_KIT_SIMD_DISPATCH(function, ...) return neon::function(__VA_ARGS__)
+#else
+#define GST_KIT_SIMD_DISPATCH(function, ...) return scalar::function(__VA_ARGS__)
+#endif
+
+  inline void s16_to_f32(const int16_t *src, float *dst, size_t n) {
+    GST_KIT_SIMD_DISPATCH(s16_to_f32, src, dst, n);
+  }
+
+  inline void s32_to_f32(const int32_t *src, float *dst, size_t n) {
+    GST_KIT_SIMD_DISPATCH(s32_to_f32, src, dst, n);
+  }
+
+  inline PeakEnergy peak_energy(const float *src, size_t n) {
+    GST_KIT_SIMD_DISPATCH(peak_energy, src, n);
+  }
+
+  inline float max_abs_fir(const float *src, size_t n, const float *taps, size_t tap_count) {
+    GST_KIT_SIMD_DISPATCH(max_abs_fir, src, n, taps, tap_count);
+  }
+
+  inline void accumulate_u8(const uint8_t *src, uint16_t *acc, size_t n) {
+    GST_KIT_SIMD_DISPATCH(accumulate_u8, src, acc, n);
+  }
+
+  inline uint64_t sad_u8(const uint8_t *a, const uint8_t *b, size_t n) {
+    GST_KIT_SIMD_DISPATCH(sad_u8, a, b, n);
+  }
+
+  inline float dot_f32(const float *a, const float *b, size_t n) {
+    GST_KIT_SIMD_DISPATCH(dot_f32, a, b, n);
+  }
+
+#undef GST_KIT_SIMD_DISPATCH
+} // namespace Simd
@@ -0,0 +1,250 @@
+#include "thread-policy.hpp"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#ifdef __linux__
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Linux limits thread names to 15 characters plus the terminator
+static const size_t MAX_THREAD_NAME = 15;
+
+static const std::map<std::string, int> SCHED_POLICIES = {
+#ifdef __linux__
+  {"other", SCHED_OTHER}, {"batch", SCHED_BATCH}, {"idle", SCHED_IDLE},
+  {"fifo", SCHED_FIFO},   {"rr", SCHED_RR},
+#endif
+};
+
+const ThreadPolicy &ThreadPolicySet::for_element(const std::string &element) const {
+  auto it = elements.find(element);
+  return it != elements.end() ? it->second : defaults;
+}
+
+namespace ThreadControl {
+  bool supported() {
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  long current_thread_id() {
+#ifdef __linux__
+    return static_cast<long>(syscall(SYS_gettid));
+#else
+    return 0;
+#endif
+  }
+
+#ifdef __linux__
+  static std::string failure(const char *what) {
+    return std::string(what) + ": " + std::strerror(errno);
+  }
+
+  static std::string comm_path(long tid) {
+    return "/proc/self/task/" + std::to_string(tid) + "/comm";
+  }
+#endif
+
+  std::vector<std::string>
+  apply(long tid, const ThreadPolicy &policy, const std::string &element) {
+    std::vector<std::string> errors;
+#ifdef __linux__
+    if (!policy.cpus.empty()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (int cpu : policy.cpus) {
+        CPU_SET(cpu, &set);
+      }
+      if (sched_setaffinity(static_cast<pid_t>(tid), sizeof(set), &set) != 0) {
+        errors.push_back(failure("sched_setaffinity"));
+      }
+    }
+
+    if (!policy.policy.empty()) {
+      struct sched_param param = {};
+      int sched_policy = SCHED_POLICIES.at(policy.policy);
+      if (sched_policy == SCHED_FIFO || sched_policy == SCHED_RR) {
+        param.sched_priority = policy.priority;
+      }
+      if (sched_setscheduler(static_cast<pid_t>(tid), sched_policy, &param) != 0) {
+        errors.push_back(failure("sched_setscheduler"));
+      }
+    }
+
+    // On Linux the nice value is per thread
+    if (policy.has_nice && setpriority(PRIO_PROCESS, static_cast<id_t>(tid), policy.nice) != 0) {
+      errors.push_back(failure("setpriority"));
+    }
+
+    if (!policy.name_prefix.empty()) {
+      std::string name = (policy.name_prefix + element).substr(0, MAX_THREAD_NAME);
+      FILE *comm = std::fopen(comm_path(tid).c_str(), "w");
+      if (!comm || std::fputs(name.c_str(), comm) < 0) {
+        errors.push_back(failure("set thread name"));
+      }
+      if (comm) {
+        std::fclose(comm);
+      }
+    }
+#endif
+    return errors;
+  }
+
+  static bool parse_policy(const Napi::Object &object, ThreadPolicy &policy, std::string &error) {
+    Napi::Value cpus = object.Get("cpus");
+    if (cpus.IsArray()) {
+      Napi::Array array = cpus.As<Napi::Array>();
+      for (uint32_t i = 0; i < array.Length(); i++) {
+        Napi::Value cpu = array.Get(i);
+#ifdef __linux__
+        const int max_cpu = CPU_SETSIZE;
+#else
+        const int max_cpu = 1024;
+#endif
+        if (!cpu.IsNumber() || cpu.As<Napi::Number>().Int32Value() < 0
+            || cpu.As<Napi::Number>().Int32Value() >= max_cpu) {
+          error = "cpus must be an array of CPU indices";
+          return false;
+        }
+        policy.cpus.push_back(cpu.As<Napi::Number>().Int32Value());
+      }
+    } else if (!cpus.IsUndefined()) {
+      error = "cpus must be an array of CPU indices";
+      return false;
+    }
+
+    Napi::Value nice = object.Get("nice");
+    if (nice.IsNumber()) {
+      policy.has_nice = true;
+      policy.nice = nice.As<Napi::Number>().Int32Value();
+      if (policy.nice < -20 || policy.nice > 19) {
+        error = "nice must be between -20 and 19";
+        return false;
+      }
+    }
+
+    Napi::Value sched_policy = object.Get("policy");
+    if (sched_policy.IsString()) {
+      policy.policy = sched_policy.As<Napi::String>().Utf8Value();
+      if (!SCHED_POLICIES.count(policy.policy)) {
+        error = "policy must be 'other', 'batch', 'idle', 'fifo' or 'rr'";
+        return false;
+      }
+    }
+
+    Napi::Value priority = object.Get("priority");
+    if (priority.IsNumber()) {
+      policy.priority = priority.As<Napi::Number>().Int32Value();
+    }
+    if (policy.policy == "fifo" || policy.policy == "rr") {
+      if (policy.priority < 1 || policy.priority > 99) {
+        error = "priority must be between 1 and 99 for 'fifo' and 'rr'";
+        return false;
+      }
+    }
+
+    Napi::Value name_prefix = object.Get("namePrefix");
+    if (name_prefix.IsString()) {
+      policy.name_prefix = name_prefix.As<Napi::String>().Utf8Value();
+    }
+
+    return true;
+  }
+
+  ThreadPolicySet from_js(const Napi::Object &object, std::string &error) {
+    ThreadPolicySet set;
+    if (!parse_policy(object, set.defaults, error)) {
+      return set;
+    }
+
+    Napi::Value elements = object.Get("elements");
+    if (elements.IsObject()) {
+      Napi::Object elements_obj = elements.As<Napi::Object>();
+      Napi::Array names = elements_obj.GetPropertyNames();
+      for (uint32_t i = 0; i < names.Length(); i++) {
+        std::string name = names.Get(i).As<Napi::String>().Utf8Value();
+        Napi::Value element_policy = elements_obj.Get(name);
+        if (!element_policy.IsObject()) {
+          error = "elements." + name + " must be an object";
+          return set;
+        }
+        if (!parse_policy(element_policy.As<Napi::Object>(), set.elements[name], error)) {
+          error = "elements." + name + ": " + error;
+          return set;
+        }
+      }
+    }
+
+    return set;
+  }
+
+  Napi::Object to_js(const Napi::Env &env, const ThreadAssignment &assignment) {
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("tid", Napi::Number::New(env, static_cast<double>(assignment.tid)));
+    result.Set("element", Napi::String::New(env, assignment.element));
+    result.Set("pad", Napi::String::New(env, assignment.pad));
+
+#ifdef __linux__
+    pid_t tid = static_cast<pid_t>(assignment.tid);
+
+    char name[64] = {0};
+    FILE *comm = std::fopen(comm_path(assignment.tid).c_str(), "r");
+    if (comm) {
+      if (std::fgets(name, sizeof(name), comm)) {
+        name[std::strcspn(name, "\n")] = '\0';
+      }
+      std::fclose(comm);
+    }
+    result.Set("name", Napi::String::New(env, name));
+
+    Napi::Array cpus = Napi::Array::New(env);
+    cpu_set_t set;
+    if (sched_getaffinity(tid, sizeof(set), &set) == 0) {
+      uint32_t index = 0;
+      for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+          cpus.Set(index++, Napi::Number::New(env, cpu));
+        }
+      }
+    }
+    result.Set("cpus", cpus);
+
+    errno = 0;
+    int nice = getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+    result.Set("nice", errno == 0 ? Napi::Number::New(env, nice) : env.Null());
+
+    int sched_policy = sched_getscheduler(tid);
+    std::string policy_name;
+    for (auto &[policy_key, value] : SCHED_POLICIES) {
+      // SCHED_RESET_ON_FORK may be or-ed into the returned policy
+      if (value == (sched_policy & ~SCHED_RESET_ON_FORK)) {
+        policy_name = policy_key;
+      }
+    }
+    result.Set(
+      "policy", policy_name.empty() ? env.Null() : Napi::String::New(env, policy_name)
+    );
+
+    struct sched_param param = {};
+    if (sched_getparam(tid, &param) == 0) {
+      result.Set("priority", Napi::Number::New(env, param.sched_priority));
+    } else {
+      result.Set("priority", env.Null());
+    }
+#endif
+
+    Napi::Array errors = Napi::Array::New(env, assignment.errors.size());
+    for (size_t i = 0; i < assignment.errors.size(); i++) {
+      errors.Set(static_cast<uint32_t>(i), Napi::String::New(env, assignment.errors[i]));
+    }
+    result.Set("errors", errors);
+
+    return result;
+  }
+} // namespace ThreadControl
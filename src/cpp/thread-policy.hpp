@@ -0,0 +1,49 @@
+#pragma once
+
+#include <map>
+#include <napi.h>
+#include <string>
+#include <vector>
+
+// Scheduling settings applied to a streaming thread. Unset fields leave the thread as is.
+struct ThreadPolicy {
+  std::vector<int> cpus;
+  bool has_nice = false;
+  int nice = 0;
+  std::string policy;
+  int priority = 0;
+  std::string name_prefix;
+};
+
+// A default policy plus per-element overrides, keyed by the element owning the task
+struct ThreadPolicySet {
+  ThreadPolicy defaults;
+  std::map<std::string, ThreadPolicy> elements;
+
+  const ThreadPolicy &for_element(const std::string &element) const;
+};
+
+// A streaming thread currently running a task of the pipeline
+struct ThreadAssignment {
+  long tid = 0;
+  std::string element;
+  std::string pad;
+  // Errors from the last policy application (e.g. missing CAP_SYS_NICE for "fifo")
+  std::vector<std::string> errors;
+};
+
+namespace ThreadControl {
+  // Per-thread affinity, niceness and scheduling are only implemented on Linux
+  bool supported();
+  long current_thread_id();
+
+  // Apply a policy to a thread of this process, returns the failures
+  std::vector<std::string>
+  apply(long tid, const ThreadPolicy &policy, const std::string &element);
+
+  // Parse { cpus, nice, policy, priority, namePrefix, elements }; sets error on invalid input
+  ThreadPolicySet from_js(const Napi::Object &object, std::string &error);
+
+  // The assignment with the thread's live settings read back from the kernel
+  Napi::Object to_js(const Napi::Env &env, const ThreadAssignment &assignment);
+} // namespace ThreadControl
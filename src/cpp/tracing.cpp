@@ -0,0 +1,492 @@
+#include "tracing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+// Process-wide tracer state shared by all sessions. Creating a tracer can itself log to
+// GST_TRACER, so the tracer list and the session list are guarded separately.
+static std::mutex tracers_mutex;
+static std::set<std::string> running_tracers;
+static bool log_function_installed = false;
+static bool forward_to_default = false; // The default handler was installed when we took over
+static std::mutex sessions_mutex;
+static std::vector<TracerSession *> sessions;
+
+// Debug settings in place before the first session, put back after the last one
+static bool saved_debug_active = false;
+static std::atomic<int> saved_tracer_threshold{GST_LEVEL_NONE};
+
+// Element addresses logged by latency and proctime, unambiguous across pipelines
+static const char *const ELEMENT_ID_FIELDS[] = {"element-id", "src-element-id", "sink-element-id"};
+// Element names, for records of other tracers that carry no address
+static const char *const ELEMENT_FIELDS[] = {"element", "src-element", "sink-element"};
+
+// Formatted like the tracers format them
+static std::string element_id(gpointer element) {
+  gchar *id = g_strdup_printf("%p", element);
+  std::string result = id;
+  g_free(id);
+  return result;
+}
+
+static GstDebugCategory *tracer_category() {
+  GstDebugCategory *category = nullptr;
+  GST_DEBUG_CATEGORY_GET(category, "GST_TRACER");
+  return category;
+}
+
+// Fields that identify a record rather than measure something
+static bool is_identity_field(const std::string &name) {
+  if (name == "ts" || name == "thread-id") {
+    return true;
+  }
+  auto ends_with = [&name](const char *suffix) {
+    size_t len = std::strlen(suffix);
+    return name.size() >= len && name.compare(name.size() - len, len, suffix) == 0;
+  };
+  return ends_with("-id") || ends_with("-ix");
+}
+
+// interlatency logs times as strings formatted with GST_TIME_FORMAT
+static bool parse_time_string(const char *str, guint64 *out) {
+  guint hours, minutes, seconds, nanoseconds;
+  if (sscanf(str, "%u:%u:%u.%u", &hours, &minutes, &seconds, &nanoseconds) != 4) {
+    return false;
+  }
+  *out = ((static_cast<guint64>(hours) * 60 + minutes) * 60 + seconds) * GST_SECOND + nanoseconds;
+  return true;
+}
+
+static bool numeric_field(const GValue *value, guint64 *out) {
+  GType type = G_VALUE_TYPE(value);
+  if (type == G_TYPE_UINT64) {
+    *out = g_value_get_uint64(value);
+  } else if (type == G_TYPE_INT64) {
+    gint64 v = g_value_get_int64(value);
+    if (v < 0) return false;
+    *out = static_cast<guint64>(v);
+  } else if (type == G_TYPE_UINT) {
+    *out = g_value_get_uint(value);
+  } else if (type == G_TYPE_INT) {
+    gint v = g_value_get_int(value);
+    if (v < 0) return false;
+    *out = static_cast<guint64>(v);
+  } else if (type == G_TYPE_DOUBLE) {
+    gdouble v = g_value_get_double(value);
+    if (v < 0) return false;
+    *out = static_cast<guint64>(v + 0.5);
+  } else if (type == G_TYPE_STRING) {
+    const gchar *str = g_value_get_string(value);
+    return str && parse_time_string(str, out);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+static std::string element_key(const GstStructure *record) {
+  const gchar *src = gst_structure_get_string(record, "src-element");
+  const gchar *sink = gst_structure_get_string(record, "sink-element");
+  if (src && sink) {
+    // End-to-end latency is reported per source/sink pair
+    return std::string(src) + "->" + sink;
+  }
+
+  const gchar *element = gst_structure_get_string(record, "element");
+  if (element) {
+    return element;
+  }
+
+  const gchar *from_pad = gst_structure_get_string(record, "from_pad");
+  const gchar *to_pad = gst_structure_get_string(record, "to_pad");
+  if (from_pad && to_pad) {
+    return std::string(from_pad) + "->" + to_pad;
+  }
+
+  for (const char *field : {"pad", "name"}) {
+    const gchar *value = gst_structure_get_string(record, field);
+    if (value) {
+      return value;
+    }
+  }
+
+  // The stats tracer refers to elements by index only
+  guint ix;
+  if (gst_structure_get_uint(record, "element-ix", &ix)) {
+    return "#" + std::to_string(ix);
+  }
+
+  return "";
+}
+
+static void tracer_log_function(
+  GstDebugCategory *category, GstDebugLevel level, const gchar *file, const gchar *function,
+  gint line, GObject *object, GstDebugMessage *message, gpointer user_data
+) {
+  // Messages keep going to the default handler we replaced, records only at the level the
+  // debug settings asked for before tracing started
+  bool is_record = std::strcmp(gst_debug_category_get_name(category), "GST_TRACER") == 0;
+  if (forward_to_default && (!is_record || level <= saved_tracer_threshold.load())) {
+    gst_debug_log_default(category, level, file, function, line, object, message, nullptr);
+  }
+  if (!is_record) {
+    return;
+  }
+
+  const gchar *text = gst_debug_message_get(message);
+  if (!text) {
+    return;
+  }
+
+  GstStructure *record = gst_structure_from_string(text, nullptr);
+  if (!record) {
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(sessions_mutex);
+    for (TracerSession *session : sessions) {
+      session->handle_record(record);
+    }
+  }
+
+  gst_structure_free(record);
+}
+
+static void collect_elements(
+  GstBin *bin, std::set<std::string> &ids, std::set<std::string> &names, bool add
+) {
+  GstIterator *it = gst_bin_iterate_recurse(bin);
+  GValue item = G_VALUE_INIT;
+  bool done = false;
+
+  while (!done) {
+    switch (gst_iterator_next(it, &item)) {
+      case GST_ITERATOR_OK: {
+        GstObject *element = GST_OBJECT(g_value_get_object(&item));
+        if (add) {
+          ids.insert(element_id(element));
+          names.insert(GST_OBJECT_NAME(element));
+        } else {
+          ids.erase(element_id(element));
+          names.erase(GST_OBJECT_NAME(element));
+        }
+        g_value_reset(&item);
+        break;
+      }
+      case GST_ITERATOR_RESYNC:
+        gst_iterator_resync(it);
+        break;
+      default:
+        done = true;
+        break;
+    }
+  }
+
+  g_value_unset(&item);
+  gst_iterator_free(it);
+}
+
+static bool
+start_tracer(const std::string &name, const std::string &params, std::string &error) {
+  if (running_tracers.count(name)) {
+    return true;
+  }
+
+  GstPluginFeature *feature = gst_registry_lookup_feature(gst_registry_get(), name.c_str());
+  if (!feature || !GST_IS_TRACER_FACTORY(feature)) {
+    if (feature) {
+      gst_object_unref(feature);
+    }
+    error = "Tracer not found: " + name;
+    return false;
+  }
+
+  GstPluginFeature *loaded = gst_plugin_feature_load(feature);
+  gst_object_unref(feature);
+  if (!loaded) {
+    error = "Failed to load tracer: " + name;
+    return false;
+  }
+
+  GType type = gst_tracer_factory_get_tracer_type(GST_TRACER_FACTORY(loaded));
+  gst_object_unref(loaded);
+
+  // Tracers register their hooks on construction and stay alive for the process lifetime
+  GstTracer *tracer = GST_TRACER(
+    g_object_new(type, "params", params.empty() ? nullptr : params.c_str(), nullptr)
+  );
+  gst_object_ref_sink(tracer);
+
+  running_tracers.insert(name);
+  return true;
+}
+
+std::shared_ptr<TracerSession> TracerSession::start(
+  GstPipeline *pipeline, const std::vector<std::string> &tracers,
+  const std::map<std::string, std::string> &params, std::string &error
+) {
+#ifdef GST_DISABLE_GST_DEBUG
+  error = "GStreamer was built without the debug system, tracer records are unavailable";
+  return nullptr;
+#else
+  std::shared_ptr<TracerSession> session(new TracerSession());
+  session->pipeline_name = GST_OBJECT_NAME(pipeline);
+  session->element_ids.insert(element_id(pipeline));
+  collect_elements(GST_BIN(pipeline), session->element_ids, session->element_names, true);
+
+  // Elements added later (addBin(), decodebin pads) are attributed as well, removed ones no
+  // longer are, their addresses may be reused by another pipeline
+  session->pipeline = GST_PIPELINE(gst_object_ref(pipeline));
+  auto free_weak = [](gpointer data, GClosure *) {
+    delete static_cast<std::weak_ptr<TracerSession> *>(data);
+  };
+  session->element_added_handler = g_signal_connect_data(
+    pipeline, "deep-element-added", G_CALLBACK(on_element_added),
+    new std::weak_ptr<TracerSession>(session), free_weak, static_cast<GConnectFlags>(0)
+  );
+  session->element_removed_handler = g_signal_connect_data(
+    pipeline, "deep-element-removed", G_CALLBACK(on_element_removed),
+    new std::weak_ptr<TracerSession>(session), free_weak, static_cast<GConnectFlags>(0)
+  );
+
+  std::lock_guard<std::mutex> lock(tracers_mutex);
+
+  for (const std::string &name : tracers) {
+    auto it = params.find(name);
+    std::string tracer_params = it != params.end() ? it->second : "";
+    // Per-element latency is what makes the latency tracer useful for finding bottlenecks
+    if (name == "latency" && tracer_params.empty()) {
+      tracer_params = "flags=pipeline+element";
+    }
+    if (!start_tracer(name, tracer_params, error)) {
+      return nullptr;
+    }
+  }
+
+  if (!log_function_installed) {
+    // Takes the default handler's place so records are not printed, and passes everything
+    // else on to it. Handlers installed by the application are left alone.
+    gst_debug_add_log_function(tracer_log_function, nullptr, nullptr);
+    forward_to_default = gst_debug_remove_log_function(gst_debug_log_default) > 0;
+    log_function_installed = true;
+  }
+
+  std::lock_guard<std::mutex> sessions_lock(sessions_mutex);
+  if (sessions.empty()) {
+    GstDebugCategory *category = tracer_category();
+    saved_debug_active = gst_debug_is_active();
+    saved_tracer_threshold = category ? gst_debug_category_get_threshold(category) : GST_LEVEL_NONE;
+    gst_debug_set_active(TRUE);
+    gst_debug_set_threshold_for_name("GST_TRACER", GST_LEVEL_TRACE);
+  }
+  sessions.push_back(session.get());
+  return session;
+#endif
+}
+
+TracerSession::~TracerSession() {
+  if (pipeline) {
+    g_signal_handler_disconnect(pipeline, element_added_handler);
+    g_signal_handler_disconnect(pipeline, element_removed_handler);
+    gst_object_unref(pipeline);
+  }
+
+  std::lock_guard<std::mutex> lock(sessions_mutex);
+  sessions.erase(std::remove(sessions.begin(), sessions.end(), this), sessions.end());
+
+  // Stop formatting records nobody listens to, and give GST_DEBUG its settings back
+  if (sessions.empty()) {
+    gst_debug_unset_threshold_for_name("GST_TRACER");
+    GstDebugCategory *category = tracer_category();
+    GstDebugLevel threshold = static_cast<GstDebugLevel>(saved_tracer_threshold.load());
+    if (category && gst_debug_category_get_threshold(category) != threshold) {
+      gst_debug_category_set_threshold(category, threshold);
+    }
+    gst_debug_set_active(saved_debug_active);
+  }
+}
+
+void TracerSession::on_element_added(
+  GstBin *, GstBin *, GstElement *element, gpointer user_data
+) {
+  std::shared_ptr<TracerSession> session =
+    static_cast<std::weak_ptr<TracerSession> *>(user_data)->lock();
+  if (!session) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(session->mutex);
+  session->element_ids.insert(element_id(element));
+  session->element_names.insert(GST_OBJECT_NAME(element));
+  if (GST_IS_BIN(element)) {
+    collect_elements(GST_BIN(element), session->element_ids, session->element_names, true);
+  }
+}
+
+void TracerSession::on_element_removed(
+  GstBin *, GstBin *, GstElement *element, gpointer user_data
+) {
+  std::shared_ptr<TracerSession> session =
+    static_cast<std::weak_ptr<TracerSession> *>(user_data)->lock();
+  if (!session) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(session->mutex);
+  session->element_ids.erase(element_id(element));
+  session->element_names.erase(GST_OBJECT_NAME(element));
+  if (GST_IS_BIN(element)) {
+    collect_elements(GST_BIN(element), session->element_ids, session->element_names, false);
+  }
+}
+
+// interlatency names pads "<element>_<pad>", and both names may contain underscores
+bool TracerSession::owns_pad(const gchar *pad_name) {
+  std::string name = pad_name;
+  for (size_t pos = name.find('_'); pos != std::string::npos; pos = name.find('_', pos + 1)) {
+    if (element_names.count(name.substr(0, pos))) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool TracerSession::belongs_to_pipeline(const GstStructure *record) {
+  bool attributable = false;
+  for (const char *field : ELEMENT_ID_FIELDS) {
+    const gchar *id = gst_structure_get_string(record, field);
+    if (id) {
+      attributable = true;
+      if (element_ids.count(id)) {
+        return true;
+      }
+    }
+  }
+  if (attributable) {
+    // Another pipeline's element, even if it has the same name as one of ours
+    return false;
+  }
+
+  for (const char *field : ELEMENT_FIELDS) {
+    const gchar *name = gst_structure_get_string(record, field);
+    if (name) {
+      attributable = true;
+      if (element_names.count(name)) {
+        return true;
+      }
+    }
+  }
+
+  for (const char *field : {"from_pad", "to_pad"}) {
+    const gchar *name = gst_structure_get_string(record, field);
+    if (name) {
+      attributable = true;
+      if (owns_pad(name)) {
+        return true;
+      }
+    }
+  }
+
+  for (const char *field : {"element-ix", "peer-element-ix"}) {
+    guint ix;
+    if (gst_structure_get_uint(record, field, &ix)) {
+      attributable = true;
+      if (element_indices.count(ix)) {
+        return true;
+      }
+    }
+  }
+
+  // Records that name no element, pad or index at all are process-wide, keep them
+  return !attributable;
+}
+
+void TracerSession::handle_record(const GstStructure *record) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  // Tracers log a "<name>.class" description of each record type when they start
+  const gchar *record_name = gst_structure_get_name(record);
+
+  // The stats tracer introduces each element with its index once, later records carry the
+  // index only. Parents are introduced before their children, so starting from the top-level
+  // pipeline the elements are recognized by their parent's index rather than by name.
+  if (std::strcmp(record_name, "new-element") == 0) {
+    guint ix, parent_ix;
+    if (!gst_structure_get_uint(record, "ix", &ix)
+        || !gst_structure_get_uint(record, "parent-ix", &parent_ix)) {
+      return;
+    }
+    bool ours;
+    if (parent_ix == G_MAXUINT) {
+      const gchar *name = gst_structure_get_string(record, "name");
+      ours = name && pipeline_name == name;
+    } else {
+      ours = element_indices.count(parent_ix) > 0;
+    }
+    if (ours) {
+      element_indices.insert(ix);
+    }
+    return;
+  }
+  if (std::strcmp(record_name, "new-pad") == 0) {
+    return;
+  }
+  if (g_str_has_suffix(record_name, ".class") || !belongs_to_pipeline(record)) {
+    return;
+  }
+
+  auto &fields = stats[record_name][element_key(record)];
+
+  gint n_fields = gst_structure_n_fields(record);
+  for (gint i = 0; i < n_fields; i++) {
+    std::string field = gst_structure_nth_field_name(record, i);
+    if (is_identity_field(field)) {
+      continue;
+    }
+
+    guint64 value;
+    if (!numeric_field(gst_structure_get_value(record, field.c_str()), &value)) {
+      continue;
+    }
+
+    auto &histogram = fields[field];
+    if (!histogram) {
+      histogram = std::make_unique<Histogram>();
+    }
+    histogram->record(value);
+  }
+}
+
+void TracerSession::reset() {
+  std::lock_guard<std::mutex> lock(mutex);
+  stats.clear();
+}
+
+Napi::Object TracerSession::to_js(const Napi::Env &env) {
+  std::lock_guard<std::mutex> lock(mutex);
+
+  Napi::Object result = Napi::Object::New(env);
+  for (auto &[record_name, elements] : stats) {
+    Napi::Object record_obj = Napi::Object::New(env);
+    for (auto &[element, fields] : elements) {
+      Napi::Object element_obj = Napi::Object::New(env);
+      for (auto &[field, histogram] : fields) {
+        Napi::Object field_obj = Napi::Object::New(env);
+        field_obj.Set("count", Napi::Number::New(env, static_cast<double>(histogram->count())));
+        field_obj.Set("min", Napi::Number::New(env, static_cast<double>(histogram->min())));
+        field_obj.Set("max", Napi::Number::New(env, static_cast<double>(histogram->max())));
+        field_obj.Set("mean", Napi::Number::New(env, histogram->mean()));
+        field_obj.Set("p50", Napi::Number::New(env, histogram->percentile(50)));
+        field_obj.Set("p95", Napi::Number::New(env, histogram->percentile(95)));
+        field_obj.Set("p99", Napi::Number::New(env, histogram->percentile(99)));
+        element_obj.Set(field, field_obj);
+      }
+      record_obj.Set(element.empty() ? "*" : element, element_obj);
+    }
+    result.Set(record_name, record_obj);
+  }
+
+  return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "histogram.hpp"
+#include <gst/gst.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <napi.h>
+#include <set>
+#include <string>
+#include <vector>
+
+// Collects GStreamer tracer records (latency, proctime, interlatency, queuelevels, stats, ...)
+// for one pipeline and aggregates every numeric field per record type and element.
+//
+// Tracers are instantiated once per process and cannot be unregistered, so enabling a
+// tracer for one pipeline makes it run for all of them. Records are captured by a native
+// log handler and attributed to a session by the element addresses they carry (latency,
+// proctime), the stats tracer's element indices, or failing those the element and pad names
+// they carry (interlatency). Records that name nothing at all (rusage) are process-wide and
+// kept by every session.
+class TracerSession {
+public:
+  // Instantiate the given tracers (if not yet running) and start collecting records for the
+  // elements of the pipeline. Returns nullptr and sets error on failure.
+  static std::shared_ptr<TracerSession> start(
+    GstPipeline *pipeline, const std::vector<std::string> &tracers,
+    const std::map<std::string, std::string> &params, std::string &error
+  );
+
+  ~TracerSession();
+
+  // Aggregated stats as { record: { element: { field: { count, min, max, mean, p50, ... } } } }
+  Napi::Object to_js(const Napi::Env &env);
+  void reset();
+
+  void handle_record(const GstStructure *record);
+
+private:
+  TracerSession() = default;
+  bool belongs_to_pipeline(const GstStructure *record);
+  bool owns_pad(const gchar *pad_name);
+  static void on_element_added(GstBin *, GstBin *, GstElement *element, gpointer user_data);
+  static void on_element_removed(GstBin *, GstBin *, GstElement *element, gpointer user_data);
+
+  GstPipeline *pipeline = nullptr;
+  std::string pipeline_name;
+  gulong element_added_handler = 0;
+  gulong element_removed_handler = 0;
+
+  std::mutex mutex;
+  // Refreshed as elements are added to and removed from the pipeline
+  std::set<std::string> element_ids; // Addresses as the tracers print them
+  std::set<std::string> element_names; // For records that carry names only
+  std::set<guint> element_indices; // Stats tracer indices of the pipeline's elements
+  // record name -> element key -> field name -> histogram
+  std::map<std::string, std::map<std::string, std::map<std::string, std::unique_ptr<Histogram>>>>
+    stats;
+};
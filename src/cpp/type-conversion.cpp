@@ -1,202 +1,388 @@
 #include "type-conversion.hpp"
+#include <cstring>
+#include <gst/audio/audio.h>
 #include <gst/gst.h>
 
+// Typed array holding one sample of a raw audio format in host byte order, if any
+static bool audio_array_type(const GstAudioFormatInfo *finfo, napi_typedarray_type *type) {
+  if (GST_AUDIO_FORMAT_INFO_WIDTH(finfo) != GST_AUDIO_FORMAT_INFO_DEPTH(finfo)
+      && GST_AUDIO_FORMAT_INFO_WIDTH(finfo) != 32) {
+    return false;
+  }
+  if (GST_AUDIO_FORMAT_INFO_WIDTH(finfo) > 8
+      && GST_AUDIO_FORMAT_INFO_ENDIANNESS(finfo) != G_BYTE_ORDER) {
+    return false;
+  }
+
+  bool is_signed = GST_AUDIO_FORMAT_INFO_IS_SIGNED(finfo);
+  switch (GST_AUDIO_FORMAT_INFO_WIDTH(finfo)) {
+    case 8:
+      *type = is_signed ? napi_int8_array : napi_uint8_array;
+      return true;
+    case 16:
+      *type = is_signed ? napi_int16_array : napi_uint16_array;
+      return true;
+    case 32:
+      *type = GST_AUDIO_FORMAT_INFO_IS_FLOAT(finfo) ? napi_float32_array
+              : is_signed                           ? napi_int32_array
+                                                    : napi_uint32_array;
+      return true;
+    case 64:
+      if (GST_AUDIO_FORMAT_INFO_IS_FLOAT(finfo)) {
+        *type = napi_float64_array;
+        return true;
+      }
+      return false;
+    default:
+      return false;
+  }
+}
+
+// View of `length` samples at `offset` in the sample's Buffer. Misaligned data is copied so
+// the typed array can be created at all.
+static Napi::Value audio_array(
+  const Napi::Env &env, Napi::Buffer<uint8_t> &buffer, napi_typedarray_type type, size_t offset,
+  size_t length, size_t bytes_per_sample
+) {
+  Napi::ArrayBuffer array_buffer = buffer.ArrayBuffer();
+  size_t byte_offset = buffer.ByteOffset() + offset;
+  if (byte_offset % bytes_per_sample != 0) {
+    array_buffer = Napi::ArrayBuffer::New(env, length * bytes_per_sample);
+    std::memcpy(array_buffer.Data(), buffer.Data() + offset, length * bytes_per_sample);
+    byte_offset = 0;
+  }
+
+  napi_value array;
+  napi_status status = napi_create_typedarray(env, type, length, array_buffer, byte_offset, &array);
+  NAPI_THROW_IF_FAILED(env, status, Napi::Value());
+  return Napi::Value(env, array);
+}
+
+// { format, rate, channels, layout, frames, data | channelData } over the sample's Buffer
+static void add_audio_view(
+  const Napi::Env &env, Napi::Object &result, Napi::Buffer<uint8_t> &buffer, GstBuffer *gst_buffer,
+  GstCaps *caps
+) {
+  GstAudioInfo info;
+  napi_typedarray_type type;
+  if (!gst_audio_info_from_caps(&info, caps) || !audio_array_type(info.finfo, &type)) {
+    return;
+  }
+
+  size_t channels = static_cast<size_t>(GST_AUDIO_INFO_CHANNELS(&info));
+  size_t bytes_per_sample = static_cast<size_t>(GST_AUDIO_INFO_WIDTH(&info)) / 8;
+  size_t frames = buffer.Length() / GST_AUDIO_INFO_BPF(&info);
+  bool interleaved = GST_AUDIO_INFO_LAYOUT(&info) == GST_AUDIO_LAYOUT_INTERLEAVED;
+
+  // Planar buffers may carry channel offsets that differ from tightly packed planes
+  GstAudioMeta *meta = interleaved ? nullptr : gst_buffer_get_audio_meta(gst_buffer);
+  if (meta) {
+    frames = meta->samples;
+  }
+
+  Napi::Object audio = Napi::Object::New(env);
+  audio.Set("format", Napi::String::New(env, GST_AUDIO_INFO_NAME(&info)));
+  audio.Set("rate", Napi::Number::New(env, GST_AUDIO_INFO_RATE(&info)));
+  audio.Set("channels", Napi::Number::New(env, channels));
+  audio.Set("layout", Napi::String::New(env, interleaved ? "interleaved" : "non-interleaved"));
+  audio.Set("frames", Napi::Number::New(env, static_cast<double>(frames)));
+
+  // Like unconvertible fields, a view that can't be created is left out rather than failing
+  // the whole sample
+  if (interleaved) {
+    Napi::Value data = audio_array(env, buffer, type, 0, frames * channels, bytes_per_sample);
+    if (data.IsEmpty()) {
+      env.GetAndClearPendingException();
+      return;
+    }
+    audio.Set("data", data);
+  } else {
+    Napi::Array channel_data = Napi::Array::New(env, channels);
+    for (size_t c = 0; c < channels; c++) {
+      size_t offset = meta ? meta->offsets[c] : c * frames * bytes_per_sample;
+      if (offset + frames * bytes_per_sample > buffer.Length()) {
+        return;
+      }
+      Napi::Value data = audio_array(env, buffer, type, offset, frames, bytes_per_sample);
+      if (data.IsEmpty()) {
+        env.GetAndClearPendingException();
+        return;
+      }
+      channel_data.Set(static_cast<uint32_t>(c), data);
+    }
+    audio.Set("channelData", channel_data);
+  }
+
+  result.Set("audio", audio);
+}
+
 namespace TypeConversion {
+  static Napi::Value read_string(const Napi::Env &env, const GValue *gvalue) {
+    const gchar *str = g_value_get_string(gvalue);
+    return str ? Napi::String::New(env, str) : env.Null();
+  }
+
+  static Napi::Value read_boolean(const Napi::Env &env, const GValue *gvalue) {
+    return Napi::Boolean::New(env, g_value_get_boolean(gvalue));
+  }
+
+  static Napi::Value read_int(const Napi::Env &env, const GValue *gvalue) {
+    return Napi::Number::New(env, g_value_get_int(gvalue));
+  }
+
+  static Napi::Value read_uint(const Napi::Env &env, const GValue *gvalue) {
+    return Napi::Number::New(env, g_value_get_uint(gvalue));
+  }
+
+  static Napi::Value read_float(const Napi::Env &env, const GValue *gvalue) {
+    return Napi::Number::New(env, g_value_get_float(gvalue));
+  }
+
+  static Napi::Value read_double(const Napi::Env &env, const GValue *gvalue) {
+    return Napi::Number::New(env, g_value_get_double(gvalue));
+  }
+
+  static Napi::Value read_uint64(const Napi::Env &env, const GValue *gvalue) {
+    return Napi::BigInt::New(env, g_value_get_uint64(gvalue));
+  }
+
+  static bool
+  write_string(const Napi::Env &env, const Napi::Value &js_value, GType type, GValue *out) {
+    if (!js_value.IsString()) {
+      return false;
+    }
+    g_value_init(out, G_TYPE_STRING);
+    g_value_set_string(out, js_value.As<Napi::String>().Utf8Value().c_str());
+    return true;
+  }
+
+  static bool
+  write_boolean(const Napi::Env &env, const Napi::Value &js_value, GType type, GValue *out) {
+    if (!js_value.IsBoolean()) {
+      return false;
+    }
+    g_value_init(out, G_TYPE_BOOLEAN);
+    g_value_set_boolean(out, js_value.As<Napi::Boolean>().Value());
+    return true;
+  }
+
+  static bool
+  write_int(const Napi::Env &env, const Napi::Value &js_value, GType type, GValue *out) {
+    if (!js_value.IsNumber()) {
+      return false;
+    }
+    g_value_init(out, G_TYPE_INT);
+    g_value_set_int(out, js_value.As<Napi::Number>().Int32Value());
+    return true;
+  }
+
+  static bool
+  write_uint(const Napi::Env &env, const Napi::Value &js_value, GType type, GValue *out) {
+    if (!js_value.IsNumber()) {
+      return false;
+    }
+    g_value_init(out, G_TYPE_UINT);
+    g_value_set_uint(out, js_value.As<Napi::Number>().Uint32Value());
+    return true;
+  }
+
+  static bool
+  write_double(const Napi::Env &env, const Napi::Value &js_value, GType type, GValue *out) {
+    if (!js_value.IsNumber()) {
+      return false;
+    }
+    g_value_init(out, G_TYPE_DOUBLE);
+    g_value_set_double(out, js_value.As<Napi::Number>().DoubleValue());
+    return true;
+  }
+
+  static bool
+  write_float(const Napi::Env &env, const Napi::Value &js_value, GType type, GValue *out) {
+    if (!js_value.IsNumber()) {
+      return false;
+    }
+    g_value_init(out, G_TYPE_FLOAT);
+    g_value_set_float(out, js_value.As<Napi::Number>().FloatValue());
+    return true;
+  }
+
+  static bool
+  write_uint64(const Napi::Env &env, const Napi::Value &js_value, GType type, GValue *out) {
+    if (js_value.IsNumber()) {
+      g_value_init(out, G_TYPE_UINT64);
+      g_value_set_uint64(out, static_cast<uint64_t>(js_value.As<Napi::Number>().DoubleValue()));
+      return true;
+    }
+    if (js_value.IsBigInt()) {
+      bool lossless;
+      g_value_init(out, G_TYPE_UINT64);
+      g_value_set_uint64(out, js_value.As<Napi::BigInt>().Uint64Value(&lossless));
+      return true;
+    }
+    return false;
+  }
+
+  // Conversions of the fundamental types, nullptr for everything that needs the generic path
+  static GValueReader scalar_reader(GType type) {
+    switch (type) {
+      case G_TYPE_STRING:
+        return read_string;
+      case G_TYPE_BOOLEAN:
+        return read_boolean;
+      case G_TYPE_INT:
+        return read_int;
+      case G_TYPE_UINT:
+        return read_uint;
+      case G_TYPE_FLOAT:
+        return read_float;
+      case G_TYPE_DOUBLE:
+        return read_double;
+      case G_TYPE_UINT64:
+        return read_uint64;
+      default:
+        return nullptr;
+    }
+  }
+
+  static GValueWriter scalar_writer(GType type) {
+    switch (type) {
+      case G_TYPE_STRING:
+        return write_string;
+      case G_TYPE_BOOLEAN:
+        return write_boolean;
+      case G_TYPE_INT:
+        return write_int;
+      case G_TYPE_UINT:
+        return write_uint;
+      case G_TYPE_FLOAT:
+        return write_float;
+      case G_TYPE_DOUBLE:
+        return write_double;
+      case G_TYPE_UINT64:
+        return write_uint64;
+      default:
+        return nullptr;
+    }
+  }
+
   bool js_to_gvalue(
     const Napi::Env &env, const Napi::Value &js_value, GType target_type, GValue *out_value
   ) {
+    if (GValueWriter write = scalar_writer(target_type)) {
+      return write(env, js_value, target_type, out_value);
+    }
+
     g_value_init(out_value, target_type);
 
-    switch (target_type) {
-      case G_TYPE_STRING: {
-        if (!js_value.IsString()) {
-          g_value_unset(out_value);
-          return false;
-        }
-        std::string str_value = js_value.As<Napi::String>().Utf8Value();
-        g_value_set_string(out_value, str_value.c_str());
-        return true;
+    // Handle special GStreamer types
+    if (target_type == gst_caps_get_type()) {
+      // Handle GstCaps - expect string that can be parsed into caps
+      if (!js_value.IsString()) {
+        g_value_unset(out_value);
+        return false;
       }
-      case G_TYPE_BOOLEAN: {
-        if (!js_value.IsBoolean()) {
-          g_value_unset(out_value);
-          return false;
-        }
-        g_value_set_boolean(out_value, js_value.As<Napi::Boolean>().Value());
-        return true;
+      std::string caps_str = js_value.As<Napi::String>().Utf8Value();
+      GstCaps *caps = gst_caps_from_string(caps_str.c_str());
+      if (!caps) {
+        g_value_unset(out_value);
+        return false;
       }
-      case G_TYPE_INT: {
-        if (!js_value.IsNumber()) {
-          g_value_unset(out_value);
-          return false;
+      g_value_set_boxed(out_value, caps);
+      gst_caps_unref(caps);
+      return true;
+    } else if (G_TYPE_IS_ENUM(target_type)) {
+      // Handle enum types
+      if (js_value.IsString()) {
+        std::string enum_str = js_value.As<Napi::String>().Utf8Value();
+        GEnumClass *enum_class = G_ENUM_CLASS(g_type_class_ref(target_type));
+        GEnumValue *enum_value = g_enum_get_value_by_nick(enum_class, enum_str.c_str());
+        if (!enum_value) {
+          enum_value = g_enum_get_value_by_name(enum_class, enum_str.c_str());
         }
-        g_value_set_int(out_value, js_value.As<Napi::Number>().Int32Value());
-        return true;
-      }
-      case G_TYPE_UINT: {
-        if (!js_value.IsNumber()) {
+        if (enum_value) {
+          g_value_set_enum(out_value, enum_value->value);
+          g_type_class_unref(enum_class);
+          return true;
+        } else {
+          g_type_class_unref(enum_class);
           g_value_unset(out_value);
           return false;
         }
-        g_value_set_uint(out_value, js_value.As<Napi::Number>().Uint32Value());
+      } else if (js_value.IsNumber()) {
+        g_value_set_enum(out_value, js_value.As<Napi::Number>().Int32Value());
         return true;
+      } else {
+        g_value_unset(out_value);
+        return false;
       }
-      case G_TYPE_FLOAT: {
-        if (!js_value.IsNumber()) {
-          g_value_unset(out_value);
-          return false;
+    } else if (G_TYPE_IS_FLAGS(target_type)) {
+      // Handle flags types
+      if (js_value.IsString()) {
+        std::string flags_str = js_value.As<Napi::String>().Utf8Value();
+        GFlagsClass *flags_class = G_FLAGS_CLASS(g_type_class_ref(target_type));
+        guint flags_value = 0;
+
+        // Try to parse the string as flag names
+        gchar **flag_names = g_strsplit(flags_str.c_str(), "+", -1);
+        gboolean success = TRUE;
+
+        for (gint i = 0; flag_names[i] != NULL; i++) {
+          g_strstrip(flag_names[i]); // Remove whitespace
+          GFlagsValue *flag_val = g_flags_get_value_by_nick(flags_class, flag_names[i]);
+          if (!flag_val) {
+            flag_val = g_flags_get_value_by_name(flags_class, flag_names[i]);
+          }
+          if (flag_val) {
+            flags_value |= flag_val->value;
+          } else {
+            success = FALSE;
+            break;
+          }
         }
-        g_value_set_float(out_value, js_value.As<Napi::Number>().FloatValue());
-        return true;
-      }
-      case G_TYPE_DOUBLE: {
-        if (!js_value.IsNumber()) {
+
+        g_strfreev(flag_names);
+        g_type_class_unref(flags_class);
+
+        if (success) {
+          g_value_set_flags(out_value, flags_value);
+          return true;
+        } else {
           g_value_unset(out_value);
           return false;
         }
-        g_value_set_double(out_value, js_value.As<Napi::Number>().DoubleValue());
+      } else if (js_value.IsNumber()) {
+        g_value_set_flags(out_value, js_value.As<Napi::Number>().Uint32Value());
         return true;
+      } else {
+        g_value_unset(out_value);
+        return false;
       }
-      case G_TYPE_UINT64: {
-        if (js_value.IsNumber()) {
-          g_value_set_uint64(
-            out_value, static_cast<uint64_t>(js_value.As<Napi::Number>().DoubleValue())
-          );
-          return true;
-        } else if (js_value.IsBigInt()) {
-          bool lossless;
-          g_value_set_uint64(out_value, js_value.As<Napi::BigInt>().Uint64Value(&lossless));
+    } else {
+      // For other types, try to convert from string if possible
+      if (js_value.IsString() && g_value_type_transformable(G_TYPE_STRING, target_type)) {
+        GValue string_value = G_VALUE_INIT;
+        g_value_init(&string_value, G_TYPE_STRING);
+        std::string str_value = js_value.As<Napi::String>().Utf8Value();
+        g_value_set_string(&string_value, str_value.c_str());
+
+        if (g_value_transform(&string_value, out_value)) {
+          g_value_unset(&string_value);
           return true;
         } else {
+          g_value_unset(&string_value);
           g_value_unset(out_value);
           return false;
         }
-      }
-      default: {
-        // Handle special GStreamer types
-        if (target_type == gst_caps_get_type()) {
-          // Handle GstCaps - expect string that can be parsed into caps
-          if (!js_value.IsString()) {
-            g_value_unset(out_value);
-            return false;
-          }
-          std::string caps_str = js_value.As<Napi::String>().Utf8Value();
-          GstCaps *caps = gst_caps_from_string(caps_str.c_str());
-          if (!caps) {
-            g_value_unset(out_value);
-            return false;
-          }
-          g_value_set_boxed(out_value, caps);
-          gst_caps_unref(caps);
-          return true;
-        } else if (G_TYPE_IS_ENUM(target_type)) {
-          // Handle enum types
-          if (js_value.IsString()) {
-            std::string enum_str = js_value.As<Napi::String>().Utf8Value();
-            GEnumClass *enum_class = G_ENUM_CLASS(g_type_class_ref(target_type));
-            GEnumValue *enum_value = g_enum_get_value_by_nick(enum_class, enum_str.c_str());
-            if (!enum_value) {
-              enum_value = g_enum_get_value_by_name(enum_class, enum_str.c_str());
-            }
-            if (enum_value) {
-              g_value_set_enum(out_value, enum_value->value);
-              g_type_class_unref(enum_class);
-              return true;
-            } else {
-              g_type_class_unref(enum_class);
-              g_value_unset(out_value);
-              return false;
-            }
-          } else if (js_value.IsNumber()) {
-            g_value_set_enum(out_value, js_value.As<Napi::Number>().Int32Value());
-            return true;
-          } else {
-            g_value_unset(out_value);
-            return false;
-          }
-        } else if (G_TYPE_IS_FLAGS(target_type)) {
-          // Handle flags types
-          if (js_value.IsString()) {
-            std::string flags_str = js_value.As<Napi::String>().Utf8Value();
-            GFlagsClass *flags_class = G_FLAGS_CLASS(g_type_class_ref(target_type));
-            guint flags_value = 0;
-
-            // Try to parse the string as flag names
-            gchar **flag_names = g_strsplit(flags_str.c_str(), "+", -1);
-            gboolean success = TRUE;
-
-            for (gint i = 0; flag_names[i] != NULL; i++) {
-              g_strstrip(flag_names[i]); // Remove whitespace
-              GFlagsValue *flag_val = g_flags_get_value_by_nick(flags_class, flag_names[i]);
-              if (!flag_val) {
-                flag_val = g_flags_get_value_by_name(flags_class, flag_names[i]);
-              }
-              if (flag_val) {
-                flags_value |= flag_val->value;
-              } else {
-                success = FALSE;
-                break;
-              }
-            }
-
-            g_strfreev(flag_names);
-            g_type_class_unref(flags_class);
-
-            if (success) {
-              g_value_set_flags(out_value, flags_value);
-              return true;
-            } else {
-              g_value_unset(out_value);
-              return false;
-            }
-          } else if (js_value.IsNumber()) {
-            g_value_set_flags(out_value, js_value.As<Napi::Number>().Uint32Value());
-            return true;
-          } else {
-            g_value_unset(out_value);
-            return false;
-          }
-        } else {
-          // For other types, try to convert from string if possible
-          if (js_value.IsString() && g_value_type_transformable(G_TYPE_STRING, target_type)) {
-            GValue string_value = G_VALUE_INIT;
-            g_value_init(&string_value, G_TYPE_STRING);
-            std::string str_value = js_value.As<Napi::String>().Utf8Value();
-            g_value_set_string(&string_value, str_value.c_str());
-
-            if (g_value_transform(&string_value, out_value)) {
-              g_value_unset(&string_value);
-              return true;
-            } else {
-              g_value_unset(&string_value);
-              g_value_unset(out_value);
-              return false;
-            }
-          } else {
-            g_value_unset(out_value);
-            return false;
-          }
-        }
+      } else {
+        g_value_unset(out_value);
+        return false;
       }
     }
   };
 
   Napi::Value gvalue_to_js(const Napi::Env &env, const GValue *gvalue) {
-    auto g_value_type = G_VALUE_TYPE(gvalue);
-    if (g_value_type == G_TYPE_STRING) {
-      return Napi::String::New(env, g_value_get_string(gvalue));
-    } else if (g_value_type == G_TYPE_BOOLEAN) {
-      return Napi::Boolean::New(env, g_value_get_boolean(gvalue));
-    } else if (g_value_type == G_TYPE_INT) {
-      return Napi::Number::New(env, g_value_get_int(gvalue));
-    } else if (g_value_type == G_TYPE_UINT) {
-      return Napi::Number::New(env, g_value_get_uint(gvalue));
-    } else if (g_value_type == G_TYPE_FLOAT) {
-      return Napi::Number::New(env, g_value_get_float(gvalue));
-    } else if (g_value_type == G_TYPE_DOUBLE) {
-      return Napi::Number::New(env, g_value_get_double(gvalue));
-    } else if (g_value_type == G_TYPE_UINT64) {
-      return Napi::BigInt::New(env, g_value_get_uint64(gvalue));
+    if (GValueReader read = scalar_reader(G_VALUE_TYPE(gvalue))) {
+      return read(env, gvalue);
     } else if (GST_VALUE_HOLDS_ARRAY(gvalue)) {
       int size = gst_value_array_get_size(gvalue);
       Napi::Array array = Napi::Array::New(env, size);
@@ -349,6 +535,17 @@ namespace TypeConversion {
     return result;
   }
 
+  GValueReader reader_for_type(GType type) {
+    // Enums, flags, caps, structures and arrays need the generic conversion
+    GValueReader read = scalar_reader(type);
+    return read ? read : gvalue_to_js;
+  }
+
+  GValueWriter writer_for_type(GType type) {
+    GValueWriter write = scalar_writer(type);
+    return write ? write : js_to_gvalue;
+  }
+
   std::string get_conversion_error_message(GType target_type, const Napi::Value &js_value) {
     std::string js_type;
     if (js_value.IsString())
@@ -405,6 +602,12 @@ namespace TypeConversion {
         Napi::Buffer<uint8_t> buffer = Napi::Buffer<uint8_t>::Copy(env, map.data, map.size);
         result.Set("buffer", buffer);
         gst_buffer_unmap(buf, &map);
+
+        // Raw audio also gets typed views of the same memory
+        GstCaps *caps = gst_sample_get_caps(sample);
+        if (caps) {
+          add_audio_view(env, result, buffer, buf, caps);
+        }
       }
 
       // Add flags from buffer
@@ -33,6 +33,27 @@ namespace TypeConversion {
    */
   Napi::Value gvalue_to_js_with_type(const Napi::Env &env, const GValue *gvalue);
 
+  // Conversion functions specialized for one GType, see reader_for_type/writer_for_type
+  using GValueReader = Napi::Value (*)(const Napi::Env &env, const GValue *gvalue);
+  using GValueWriter = bool (*)(
+    const Napi::Env &env, const Napi::Value &js_value, GType target_type, GValue *out_value
+  );
+
+  /**
+   * Resolve the GValue to JavaScript conversion for a GType once, so hot paths can skip the
+   * type dispatch of gvalue_to_js
+   * @param type The GType of the values that will be converted
+   * @return Conversion function with the same results as gvalue_to_js
+   */
+  GValueReader reader_for_type(GType type);
+
+  /**
+   * Resolve the JavaScript to GValue conversion for a GType once
+   * @param type The GType of the values that will be produced
+   * @return Conversion function with the same contract as js_to_gvalue
+   */
+  GValueWriter writer_for_type(GType type);
+
   /**
    * Get a human-readable error message for type conversion failures
    * @param target_type The GType that conversion failed for
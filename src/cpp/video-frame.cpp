@@ -0,0 +1,166 @@
+#include "video-frame.hpp"
+#include "type-conversion.hpp"
+#include <algorithm>
+#include <gst/video/video.h>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+// V8 refuses two live external ArrayBuffers over the same memory, which happens when one
+// buffer reaches several app sinks. Addresses still exposed are copied instead.
+static std::mutex exposed_mutex;
+static std::set<const void *> exposed_planes;
+
+// A mapped frame shared by its plane ArrayBuffers and release(). The mapping holds a
+// reference to the buffer, so pooled memory cannot be recycled underneath JS.
+struct MappedFrame {
+  GstVideoFrame frame;
+  bool mapped = false;
+  std::vector<const void *> exposed;
+  std::vector<Napi::Reference<Napi::ArrayBuffer>> views;
+
+  void unmap() {
+    if (mapped) {
+      gst_video_frame_unmap(&frame);
+      mapped = false;
+    }
+  }
+
+  // Lets the next frame in the same memory be exposed without copying
+  void forget_exposed() {
+    std::lock_guard<std::mutex> lock(exposed_mutex);
+    for (const void *data : exposed) {
+      exposed_planes.erase(data);
+    }
+    exposed.clear();
+  }
+
+  ~MappedFrame() {
+    unmap();
+    forget_exposed();
+  }
+};
+
+// First component stored in a plane, which gives the plane's dimensions
+static guint plane_component(const GstVideoInfo *info, guint plane) {
+  for (guint comp = 0; comp < GST_VIDEO_INFO_N_COMPONENTS(info); comp++) {
+    if (GST_VIDEO_INFO_COMP_PLANE(info, comp) == plane) {
+      return comp;
+    }
+  }
+  return 0;
+}
+
+static Napi::ArrayBuffer
+plane_view(const Napi::Env &env, std::shared_ptr<MappedFrame> &handle, guint plane, size_t size) {
+  uint8_t *data = static_cast<uint8_t *>(GST_VIDEO_FRAME_PLANE_DATA(&handle->frame, plane));
+
+  bool shared;
+  {
+    std::lock_guard<std::mutex> lock(exposed_mutex);
+    shared = !exposed_planes.insert(data).second;
+  }
+  if (shared) {
+    Napi::ArrayBuffer copy = Napi::ArrayBuffer::New(env, size);
+    std::copy(data, data + size, static_cast<uint8_t *>(copy.Data()));
+    return copy;
+  }
+
+  handle->exposed.push_back(data);
+  Napi::ArrayBuffer view = Napi::ArrayBuffer::New(
+    env, data, size,
+    [](Napi::Env, void *, std::shared_ptr<MappedFrame> *hint) { delete hint; },
+    new std::shared_ptr<MappedFrame>(handle)
+  );
+  handle->views.push_back(Napi::Weak(view));
+  return view;
+}
+
+namespace VideoFrame {
+  Napi::Value to_js(const Napi::Env &env, GstSample *sample, std::string &error) {
+    GstBuffer *buffer = gst_sample_get_buffer(sample);
+    GstCaps *caps = gst_sample_get_caps(sample);
+
+    GstVideoInfo info;
+    if (!buffer || !caps || !gst_video_info_from_caps(&info, caps)) {
+      error = "Sample is not raw video";
+      return Napi::Value();
+    }
+
+    // Only a buffer nobody else holds may be written through the views. Shared buffers are
+    // mapped for reading and the frame says so, since JS has no read-only typed arrays.
+    auto handle = std::make_shared<MappedFrame>();
+    bool writable = gst_buffer_is_writable(buffer)
+                    && gst_video_frame_map(&handle->frame, &info, buffer, GST_MAP_READWRITE);
+    if (!writable && !gst_video_frame_map(&handle->frame, &info, buffer, GST_MAP_READ)) {
+      error = "Failed to map video frame";
+      return Napi::Value();
+    }
+    handle->mapped = true;
+
+    // Layout comes from the video meta when upstream padded the planes, not from the caps
+    const GstVideoInfo *layout = &handle->frame.info;
+    Napi::Object result = Napi::Object::New(env);
+    result.Set("format", Napi::String::New(env, GST_VIDEO_INFO_NAME(layout)));
+    result.Set("width", Napi::Number::New(env, GST_VIDEO_INFO_WIDTH(layout)));
+    result.Set("height", Napi::Number::New(env, GST_VIDEO_INFO_HEIGHT(layout)));
+    result.Set("size", Napi::Number::New(env, static_cast<double>(GST_VIDEO_INFO_SIZE(layout))));
+    if (GST_BUFFER_PTS_IS_VALID(buffer)) {
+      result.Set("pts", Napi::Number::New(env, static_cast<double>(GST_BUFFER_PTS(buffer))));
+    }
+    if (GST_BUFFER_DURATION_IS_VALID(buffer)) {
+      result.Set(
+        "duration", Napi::Number::New(env, static_cast<double>(GST_BUFFER_DURATION(buffer)))
+      );
+    }
+    result.Set("flags", Napi::Number::New(env, static_cast<uint32_t>(GST_BUFFER_FLAGS(buffer))));
+    result.Set("writable", Napi::Boolean::New(env, writable));
+    result.Set("caps", TypeConversion::gst_structure_to_js(env, gst_caps_get_structure(caps, 0)));
+
+    Napi::Array planes = Napi::Array::New(env, GST_VIDEO_FRAME_N_PLANES(&handle->frame));
+    for (guint p = 0; p < GST_VIDEO_FRAME_N_PLANES(&handle->frame); p++) {
+      guint comp = plane_component(layout, p);
+      gint stride = GST_VIDEO_FRAME_PLANE_STRIDE(&handle->frame, p);
+      gint height = GST_VIDEO_FRAME_COMP_HEIGHT(&handle->frame, comp);
+
+      // Without a video meta every plane lives in the first mapping; the last row of a plane
+      // may be shorter than the stride
+      const GstMapInfo &map = handle->frame.meta ? handle->frame.map[p] : handle->frame.map[0];
+      const uint8_t *data =
+        static_cast<const uint8_t *>(GST_VIDEO_FRAME_PLANE_DATA(&handle->frame, p));
+      size_t available = static_cast<size_t>(map.data + map.size - data);
+      size_t size = std::min(static_cast<size_t>(stride) * height, available);
+
+      Napi::ArrayBuffer view = plane_view(env, handle, p, size);
+      Napi::Object plane = Napi::Object::New(env);
+      plane.Set("data", Napi::Uint8Array::New(env, size, view, 0));
+      plane.Set("stride", Napi::Number::New(env, stride));
+      plane.Set(
+        "offset",
+        Napi::Number::New(env, static_cast<double>(GST_VIDEO_INFO_PLANE_OFFSET(layout, p)))
+      );
+      plane.Set("width", Napi::Number::New(env, GST_VIDEO_FRAME_COMP_WIDTH(&handle->frame, comp)));
+      plane.Set("height", Napi::Number::New(env, height));
+      planes.Set(p, plane);
+    }
+    result.Set("planes", planes);
+
+    // Detach the views before unmapping so JS can't reach the memory afterwards
+    auto release = [handle](const Napi::CallbackInfo &info) -> Napi::Value {
+      for (Napi::Reference<Napi::ArrayBuffer> &view : handle->views) {
+        if (!view.IsEmpty() && !view.Value().IsEmpty() && !view.Value().IsDetached()) {
+          view.Value().Detach();
+        }
+      }
+      handle->views.clear();
+      // Detached views no longer claim their memory, no need to wait for them to be collected
+      handle->forget_exposed();
+      handle->unmap();
+      return info.Env().Undefined();
+    };
+    result.Set("release", Napi::Function::New(env, release, "release"));
+
+    return result;
+  }
+} // namespace VideoFrame
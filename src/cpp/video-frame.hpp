@@ -0,0 +1,16 @@
+#pragma once
+
+#include <gst/gst.h>
+#include <napi.h>
+#include <string>
+
+namespace VideoFrame {
+  /**
+   * Map the raw video buffer of a sample and expose its planes to JS without copying
+   * @param env The N-API environment
+   * @param sample Sample with raw video caps, the frame keeps its own reference
+   * @param error Set when the sample cannot be mapped as a video frame
+   * @return Frame object with per-plane views and release(), or an empty value on error
+   */
+  Napi::Value to_js(const Napi::Env &env, GstSample *sample, std::string &error);
+} // namespace VideoFrame
@@ -0,0 +1,67 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+
+const pullSample = async (description: string) => {
+  const pipeline = new Pipeline(`${description} ! appsink name=sink`);
+  const sink = pipeline.getElementByName("sink");
+
+  if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+  await pipeline.play();
+  const sample = await sink.getSample();
+  await pipeline.stop();
+
+  return sample;
+};
+
+describe("AppSink audio samples", () => {
+  it("should view interleaved float audio as a Float32Array", async () => {
+    const sample = await pullSample(
+      "audiotestsrc samplesperbuffer=480 ! audio/x-raw,format=F32LE,channels=2,rate=48000"
+    );
+    const audio = sample?.audio;
+
+    expect(audio?.format).toBe("F32LE");
+    expect(audio?.rate).toBe(48000);
+    expect(audio?.channels).toBe(2);
+    expect(audio?.layout).toBe("interleaved");
+    expect(audio?.frames).toBe(480);
+    expect(audio?.data).toBeInstanceOf(Float32Array);
+    expect(audio?.data?.length).toBe(960);
+
+    // Same memory as the byte buffer, not a copy
+    expect(audio?.data?.buffer).toBe(sample?.buffer?.buffer);
+    expect(audio?.data?.[2]).toBe(sample?.buffer?.readFloatLE(8));
+  });
+
+  it("should view 16-bit audio as an Int16Array", async () => {
+    const sample = await pullSample(
+      "audiotestsrc samplesperbuffer=256 ! audio/x-raw,format=S16LE,channels=1"
+    );
+
+    expect(sample?.audio?.data).toBeInstanceOf(Int16Array);
+    expect(sample?.audio?.data?.length).toBe(256);
+    expect(sample?.audio?.data?.[10]).toBe(sample?.buffer?.readInt16LE(20));
+  });
+
+  it("should give planar audio one array per channel", async () => {
+    const sample = await pullSample(
+      "audiotestsrc samplesperbuffer=128 ! audio/x-raw,channels=2 ! audioconvert " +
+        "! audio/x-raw,format=F32LE,layout=non-interleaved"
+    );
+    const audio = sample?.audio;
+
+    expect(audio?.layout).toBe("non-interleaved");
+    expect(audio?.data).toBeUndefined();
+    expect(audio?.channelData).toHaveLength(2);
+    expect(audio?.channelData?.[0]).toBeInstanceOf(Float32Array);
+    expect(audio?.channelData?.[1]?.length).toBe(128);
+    expect(audio?.channelData?.[1]?.[0]).toBe(sample?.buffer?.readFloatLE(128 * 4));
+  });
+
+  it("should leave video samples alone", async () => {
+    const sample = await pullSample("videotestsrc num-buffers=1");
+
+    expect(sample?.audio).toBeUndefined();
+  });
+});
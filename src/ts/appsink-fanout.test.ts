@@ -0,0 +1,200 @@
+import { describe, expect, it } from "vitest";
+import { type GStreamerSample, Pipeline } from ".";
+import { getAppSink, sleep, waitForEos } from "./test-utils";
+
+// Plays to end of stream and gives queued callbacks time to run
+const playToEnd = async (pipeline: InstanceType<typeof Pipeline>) => {
+  await pipeline.play();
+  await waitForEos(pipeline);
+  await sleep(200);
+};
+
+const busyWait = (ms: number) => {
+  const until = performance.now() + ms;
+  while (performance.now() < until);
+};
+
+describe("AppSink sample fan-out", () => {
+  it("should deliver the same sample object to every subscriber", async () => {
+    const frames = 10;
+    const pipeline = new Pipeline(
+      `videotestsrc num-buffers=${frames} ! videoconvert ! appsink name=sink sync=false`
+    );
+    const sink = getAppSink(pipeline);
+
+    const received: GStreamerSample[][] = [[], [], []];
+    const unsubscribes = received.map(samples => sink.onSample(sample => samples.push(sample)));
+
+    await playToEnd(pipeline);
+    unsubscribes.forEach(unsubscribe => unsubscribe());
+    await pipeline.stop();
+
+    for (const samples of received) expect(samples).toHaveLength(frames);
+    for (let i = 0; i < frames; i++) {
+      expect(received[1][i]).toBe(received[0][i]);
+      expect(received[2][i]).toBe(received[0][i]);
+    }
+  });
+
+  it("should share the subscription between element handles", async () => {
+    const frames = 5;
+    const pipeline = new Pipeline(
+      `videotestsrc num-buffers=${frames} ! videoconvert ! appsink name=sink sync=false`
+    );
+
+    const first: GStreamerSample[] = [];
+    const second: GStreamerSample[] = [];
+    const unsubscribeFirst = getAppSink(pipeline).onSample(sample => first.push(sample));
+    const unsubscribeSecond = getAppSink(pipeline).onSample(sample => second.push(sample));
+
+    await playToEnd(pipeline);
+    unsubscribeFirst();
+    unsubscribeSecond();
+    await pipeline.stop();
+
+    expect(first).toHaveLength(frames);
+    expect(second).toEqual(first);
+    expect(second[0]).toBe(first[0]);
+  });
+
+  it("should limit a subscriber to maxFps of stream time", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=30 ! video/x-raw,framerate=30/1 ! videoconvert ! " +
+        "appsink name=sink sync=false"
+    );
+    const sink = getAppSink(pipeline);
+
+    let all = 0;
+    let limited = 0;
+    const unsubscribeAll = sink.onSample(() => all++);
+    const unsubscribeLimited = sink.onSample(() => limited++, { maxFps: 5 });
+
+    await playToEnd(pipeline);
+    unsubscribeAll();
+    unsubscribeLimited();
+    await pipeline.stop();
+
+    expect(all).toBe(30);
+    expect(limited).toBeGreaterThanOrEqual(4);
+    expect(limited).toBeLessThanOrEqual(6);
+  });
+
+  it("should drop samples for a busy subscriber according to its policy", async () => {
+    const frames = 30;
+    const pipeline = new Pipeline(
+      `videotestsrc num-buffers=${frames} ! videoconvert ! appsink name=sink sync=false`
+    );
+    const sink = getAppSink(pipeline);
+
+    const all: GStreamerSample[] = [];
+    const newest: GStreamerSample[] = [];
+    const oldest: GStreamerSample[] = [];
+    const unsubscribes = [
+      sink.onSample(sample => {
+        all.push(sample);
+        // Holds up the JS thread so the other subscribers fall behind
+        if (all.length === 1) busyWait(500);
+      }),
+      sink.onSample(sample => newest.push(sample), { maxPending: 1 }),
+      sink.onSample(sample => oldest.push(sample), { maxPending: 1, drop: "oldest" }),
+    ];
+
+    await playToEnd(pipeline);
+    unsubscribes.forEach(unsubscribe => unsubscribe());
+    await pipeline.stop();
+
+    expect(all).toHaveLength(frames);
+    expect(newest.length).toBeLessThan(frames);
+    expect(oldest.length).toBeLessThan(frames);
+    // Dropping the newest keeps the first sample, dropping the oldest keeps the last
+    expect(newest[0]).toBe(all[0]);
+    expect(oldest.at(-1)).toBe(all.at(-1));
+  });
+
+  it("should keep other subscribers running after one unsubscribes", async () => {
+    const frames = 10;
+    const pipeline = new Pipeline(
+      `videotestsrc num-buffers=${frames} ! videoconvert ! appsink name=sink sync=false`
+    );
+    const sink = getAppSink(pipeline);
+
+    let kept = 0;
+    let removed = 0;
+    const unsubscribeKept = sink.onSample(() => kept++);
+    const unsubscribeRemoved = sink.onSample(() => {
+      removed++;
+      unsubscribeRemoved();
+    });
+
+    await playToEnd(pipeline);
+    unsubscribeKept();
+    unsubscribeRemoved();
+    await pipeline.stop();
+
+    expect(kept).toBe(frames);
+    expect(removed).toBe(1);
+  });
+
+  it("should deliver only the newest sample to latest-only subscribers", async () => {
+    const frames = 30;
+    const pipeline = new Pipeline(
+      `videotestsrc num-buffers=${frames} ! videoconvert ! appsink name=sink sync=false`
+    );
+    const sink = getAppSink(pipeline);
+
+    const all: GStreamerSample[] = [];
+    const latest: GStreamerSample[] = [];
+    const unsubscribeAll = sink.onSample(sample => all.push(sample));
+    const unsubscribeLatest = sink.onSample(sample => latest.push(sample), {
+      maxFps: 20,
+      latestOnly: true,
+    });
+
+    await playToEnd(pipeline);
+    unsubscribeAll();
+    unsubscribeLatest();
+    await pipeline.stop();
+
+    expect(all).toHaveLength(frames);
+    expect(latest.length).toBeGreaterThan(0);
+    expect(latest.length).toBeLessThan(frames);
+    // Whatever was skipped, the last frame of the stream is delivered
+    expect(latest.at(-1)).toEqual(all.at(-1));
+  });
+
+  it("should deliver latest-only samples on a fixed cadence", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc is-live=true num-buffers=60 ! video/x-raw,framerate=60/1 ! videoconvert ! " +
+        "appsink name=sink"
+    );
+    const sink = getAppSink(pipeline);
+
+    const times: number[] = [];
+    const unsubscribe = sink.onSample(() => times.push(performance.now()), {
+      maxFps: 5,
+      latestOnly: true,
+    });
+
+    await playToEnd(pipeline);
+    unsubscribe();
+    await pipeline.stop();
+
+    // One second of video at 5 deliveries per second
+    expect(times.length).toBeGreaterThanOrEqual(4);
+    expect(times.length).toBeLessThanOrEqual(7);
+    for (let i = 1; i < times.length; i++) {
+      expect(times[i] - times[i - 1]).toBeGreaterThanOrEqual(190);
+    }
+  });
+
+  it("should reject invalid subscription options", () => {
+    const pipeline = new Pipeline("videotestsrc ! appsink name=sink");
+    const sink = getAppSink(pipeline);
+
+    expect(() => sink.onSample(() => {}, { maxFps: 0 })).toThrow(/maxFps/);
+    expect(() => sink.onSample(() => {}, { maxPending: 0 })).toThrow(/maxPending/);
+    expect(() =>
+      sink.onSample(() => {}, { drop: "middle" as unknown as "newest" })
+    ).toThrow(/drop/);
+  });
+});
@@ -0,0 +1,96 @@
+import { describe, expect, it } from "vitest";
+import { createAppSinkPipeline } from "./test-utils";
+
+const RGBA = "videotestsrc num-buffers=1 ! video/x-raw,format=RGBA,width=320,height=240";
+
+describe("AppSink getRegions", () => {
+  it("should pack the requested regions into one buffer", async () => {
+    const { pipeline, sink } = createAppSinkPipeline(RGBA);
+
+    await pipeline.play();
+    const batch = await sink.getRegions([
+      { x: 0, y: 0, width: 16, height: 8 },
+      { x: 100, y: 50, width: 32, height: 20 },
+    ]);
+    await pipeline.stop();
+
+    expect(batch?.buffer.length).toBe(16 * 8 * 4 + 32 * 20 * 4);
+    expect(batch?.regions).toEqual([
+      { format: "RGBA", width: 16, height: 8, offset: 0, size: 512, strides: [64] },
+      { format: "RGBA", width: 32, height: 20, offset: 512, size: 2560, strides: [128] },
+    ]);
+    expect(batch?.pts).toBe(0);
+  });
+
+  it("should copy the same pixels as the full frame", async () => {
+    const full = createAppSinkPipeline(RGBA);
+    await full.pipeline.play();
+    const sample = await full.sink.getSample();
+    await full.pipeline.stop();
+
+    const { pipeline, sink } = createAppSinkPipeline(RGBA);
+    await pipeline.play();
+    const batch = await sink.getRegions([{ x: 40, y: 30, width: 10, height: 5 }]);
+    await pipeline.stop();
+
+    const frame = sample?.buffer ?? Buffer.alloc(0);
+    for (let row = 0; row < 5; row++) {
+      const start = ((30 + row) * 320 + 40) * 4;
+      expect(batch?.buffer.subarray(row * 40, row * 40 + 40)).toEqual(
+        frame.subarray(start, start + 40)
+      );
+    }
+  });
+
+  it("should scale and convert regions", async () => {
+    const { pipeline, sink } = createAppSinkPipeline(
+      "videotestsrc num-buffers=1 ! video/x-raw,format=I420,width=640,height=480"
+    );
+
+    await pipeline.play();
+    const batch = await sink.getRegions([{ x: 64, y: 64, width: 200, height: 100 }], {
+      format: "RGB",
+      scale: 0.5,
+    });
+    await pipeline.stop();
+
+    const region = batch?.regions[0];
+    expect(region?.format).toBe("RGB");
+    expect(region?.width).toBe(100);
+    expect(region?.height).toBe(50);
+    expect(batch?.buffer.length).toBe(region?.size);
+  });
+
+  it("should reject regions outside the frame", async () => {
+    const { pipeline, sink } = createAppSinkPipeline(RGBA);
+
+    await pipeline.play();
+    await expect(sink.getRegions([{ x: 300, y: 0, width: 64, height: 8 }])).rejects.toThrow(
+      "outside the 320x240 frame"
+    );
+    await pipeline.stop();
+  });
+
+  it("should reject regions whose extent overflows", async () => {
+    const { pipeline, sink } = createAppSinkPipeline(RGBA);
+
+    await pipeline.play();
+    // x + width wraps around a 32-bit int
+    await expect(
+      sink.getRegions([{ x: 10, y: 0, width: 2 ** 31 - 1, height: 8 }])
+    ).rejects.toThrow("outside the 320x240 frame");
+    // Once the caps are known a region starting past the frame fails right away
+    expect(() => sink.getRegions([{ x: 320, y: 0, width: 1, height: 1 }])).toThrow(
+      "starts outside the 320x240 frame"
+    );
+    await pipeline.stop();
+  });
+
+  it("should validate arguments", () => {
+    const { sink } = createAppSinkPipeline(RGBA);
+
+    expect(() => sink.getRegions([{ x: 0, y: 0, width: 0, height: 8 }])).toThrow("width");
+    expect(() => sink.getRegions([], { scale: 2 })).toThrow("scale");
+    expect(() => sink.getRegions([], { format: "NOPE" })).toThrow("Unknown video format");
+  });
+});
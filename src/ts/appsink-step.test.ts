@@ -0,0 +1,109 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+
+describe("AppSink Frame Stepping", () => {
+  it("should pull the preroll sample of a paused pipeline", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=30 ! video/x-raw,framerate=30/1 ! appsink name=sink"
+    );
+    const sink = pipeline.getElementByName("sink");
+
+    if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+    await pipeline.pause();
+
+    const preroll = await sink.getPreroll();
+
+    await pipeline.stop();
+
+    expect(preroll).not.toBeNull();
+    expect(preroll?.buffer).toBeDefined();
+  });
+
+  it("should resolve with the next frame after stepping", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=30 ! video/x-raw,framerate=30/1 ! appsink name=sink"
+    );
+    const sink = pipeline.getElementByName("sink");
+
+    if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+    await pipeline.pause();
+    await sink.getPreroll();
+
+    const frames = [];
+    for (let i = 0; i < 3; i++) {
+      const frame = await sink.step(1);
+      expect(frame).not.toBeNull();
+      frames.push(frame);
+    }
+
+    const position = pipeline.queryPosition();
+
+    await pipeline.stop();
+
+    expect(frames).toHaveLength(3);
+    if (position !== -1) {
+      // Three frames at 30fps is 0.1s
+      expect(position).toBeCloseTo(0.1, 1);
+    }
+  });
+
+  it("should step by duration", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=90 ! video/x-raw,framerate=30/1 ! appsink name=sink"
+    );
+    const sink = pipeline.getElementByName("sink");
+
+    if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+    await pipeline.pause();
+
+    const frame = await sink.step(1, { format: "time" });
+    const position = pipeline.queryPosition();
+
+    await pipeline.stop();
+
+    expect(frame).not.toBeNull();
+    if (position !== -1) {
+      expect(position).toBeGreaterThanOrEqual(0.9);
+      expect(position).toBeLessThan(1.5);
+    }
+  });
+
+  it("should resolve null when stepping past the end of stream", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=2 ! video/x-raw,framerate=30/1 ! appsink name=sink"
+    );
+    const sink = pipeline.getElementByName("sink");
+
+    if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+    await pipeline.pause();
+
+    const frame = await sink.step(10, { timeoutMs: 200 });
+
+    await pipeline.stop();
+
+    expect(frame).toBeNull();
+  });
+
+  it("should throw error for invalid step arguments", () => {
+    const pipeline = new Pipeline("videotestsrc ! appsink name=sink");
+    const sink = pipeline.getElementByName("sink");
+
+    if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+    expect(() => sink.step(0)).toThrow("Step amount must be > 0");
+    expect(() => sink.step(0.5)).toThrow("whole number of buffers");
+    expect(() => sink.step(1, { rate: -1 })).toThrow("Step rate must be > 0");
+    expect(() => {
+      // @ts-expect-error Testing invalid format
+      sink.step(1, { format: "frames" });
+    }).toThrow("Step format must be 'buffers' or 'time'");
+    expect(() => {
+      // @ts-expect-error Testing invalid argument type
+      sink.step("1");
+    }).toThrow("step() requires a number argument");
+  });
+});
@@ -0,0 +1,113 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { createAppSinkPipeline, getAppSink } from "./test-utils";
+
+describe("AppSink getVideoFrame", () => {
+  it("should expose planes with their layout", async () => {
+    const { pipeline, sink } = createAppSinkPipeline(
+      "videotestsrc num-buffers=1 ! video/x-raw,format=I420,width=320,height=240"
+    );
+
+    await pipeline.play();
+    const frame = await sink.getVideoFrame();
+    await pipeline.stop();
+
+    expect(frame).not.toBeNull();
+    expect(frame?.format).toBe("I420");
+    expect(frame?.width).toBe(320);
+    expect(frame?.height).toBe(240);
+    expect(frame?.size).toBe(320 * 240 * 1.5);
+    expect(frame?.pts).toBe(0);
+    expect(frame?.caps.format).toBe("I420");
+    expect(typeof frame?.writable).toBe("boolean");
+
+    expect(frame?.planes.map(plane => [plane.width, plane.height, plane.stride])).toEqual([
+      [320, 240, 320],
+      [160, 120, 160],
+      [160, 120, 160],
+    ]);
+    expect(frame?.planes.map(plane => plane.offset)).toEqual([0, 76800, 96000]);
+    expect(frame?.planes[0]?.data).toBeInstanceOf(Uint8Array);
+    expect(frame?.planes[0]?.data.length).toBe(76800);
+
+    frame?.release();
+  });
+
+  it("should view the same bytes as getSample()", async () => {
+    const description = "videotestsrc num-buffers=1 ! video/x-raw,format=RGBA,width=64,height=48";
+
+    const first = createAppSinkPipeline(description);
+    await first.pipeline.play();
+    const sample = await first.sink.getSample();
+    await first.pipeline.stop();
+
+    const second = createAppSinkPipeline(description);
+    await second.pipeline.play();
+    const frame = await second.sink.getVideoFrame();
+    await second.pipeline.stop();
+
+    expect(frame?.planes[0]?.stride).toBe(64 * 4);
+    expect(Buffer.from(frame?.planes[0]?.data ?? [])).toEqual(sample?.buffer);
+
+    frame?.release();
+  });
+
+  it("should detach the views on release", async () => {
+    const { pipeline, sink } = createAppSinkPipeline(
+      "videotestsrc ! video/x-raw,format=NV12,width=64,height=48"
+    );
+
+    await pipeline.play();
+    const frame = await sink.getVideoFrame();
+    await pipeline.stop();
+
+    const [luma, chroma] = frame?.planes ?? [];
+    expect(luma?.data.length).toBe(64 * 48);
+    expect(chroma?.data.length).toBe(64 * 24);
+
+    frame?.release();
+    expect(luma?.data.length).toBe(0);
+    expect(chroma?.data.length).toBe(0);
+
+    // Releasing twice is harmless
+    frame?.release();
+  });
+
+  it("should not copy frames recycled from the pool after release", async () => {
+    // One buffer in flight at a time, so the pool keeps handing out the same memory
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=10 ! video/x-raw,format=I420,width=64,height=48 ! " +
+        "appsink name=sink max-buffers=1"
+    );
+    const sink = getAppSink(pipeline);
+
+    await pipeline.play();
+    // Kept reachable so the views are not collected in between
+    const frames: unknown[] = [];
+    for (let i = 0; i < 10; i++) {
+      const frame = await sink.getVideoFrame();
+      frames.push(frame);
+      const luma = frame?.planes[0]?.data;
+      frame?.release();
+      // Only zero-copy views are detached, a copy keeps its bytes
+      expect(luma?.length).toBe(0);
+    }
+    await pipeline.stop();
+  });
+
+  it("should reject samples that are not raw video", async () => {
+    const { pipeline, sink } = createAppSinkPipeline("audiotestsrc");
+
+    await pipeline.play();
+    await expect(sink.getVideoFrame()).rejects.toThrow("not raw video");
+    await pipeline.stop();
+  });
+
+  it("should throw on elements that are not app sinks", () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink name=sink");
+    const sink = pipeline.getElementByName("sink");
+
+    // @ts-expect-error Testing runtime error for non-AppSink element
+    expect(() => sink?.getVideoFrame()).toThrow("app-sink-element");
+  });
+});
@@ -0,0 +1,79 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { sleep, waitForEos } from "./test-utils";
+
+const getAppSource = (pipeline: InstanceType<typeof Pipeline>) => {
+  const src = pipeline.getElementByName("src");
+  if (src?.type !== "app-src-element") throw new Error("Expected app source element");
+  return src;
+};
+
+describe("AppSrc allocator", () => {
+  it("should push buffers from the arena", async () => {
+    const pipeline = new Pipeline("appsrc name=src ! appsink name=sink sync=false");
+    const src = getAppSource(pipeline);
+    const sink = pipeline.getElementByName("sink");
+    if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+    src.setAllocator({ alignment: 64 });
+    await pipeline.play();
+
+    const data = Buffer.from(Array.from({ length: 1000 }, (_, i) => i % 256));
+    src.push(data);
+    const sample = await sink.getSample(1000);
+    await pipeline.stop();
+
+    expect(sample?.buffer?.equals(data)).toBe(true);
+    expect(src.getAllocatorStats()).toMatchObject({ alignment: 64, allocations: 1, slabs: 1 });
+  });
+
+  it("should recycle memory and report statistics", async () => {
+    const pipeline = new Pipeline("appsrc name=src ! fakesink sync=false");
+    const src = getAppSource(pipeline);
+
+    src.setAllocator({ alignment: "page" });
+    await pipeline.play();
+
+    // Pushing one at a time lets each buffer come back before the next one is needed
+    for (let i = 0; i < 20; i++) {
+      src.push(Buffer.alloc(3000, i));
+      await sleep(10);
+    }
+    src.endOfStream();
+    await waitForEos(pipeline);
+    await pipeline.stop();
+
+    const stats = src.getAllocatorStats();
+    expect(stats?.alignment).toBeGreaterThanOrEqual(4096);
+    expect(stats?.allocations).toBe(20);
+    expect(stats?.recycled).toBeGreaterThan(10);
+    expect(stats?.slabs).toBe(1);
+    expect(stats?.bytesReserved).toBe(2 * 1024 * 1024);
+    expect(stats?.bytesInUse).toBe(0);
+    expect(stats?.peakBytesInUse).toBeGreaterThanOrEqual(stats?.alignment ?? 0);
+  });
+
+  it("should be shared by every handle of the element and removable", () => {
+    const pipeline = new Pipeline("appsrc name=src ! fakesink");
+    const src = getAppSource(pipeline);
+
+    expect(src.getAllocatorStats()).toBeNull();
+    src.setAllocator({ hugePages: true });
+    expect(getAppSource(pipeline).getAllocatorStats()?.alignment).toBe(64);
+
+    src.setAllocator(null);
+    expect(src.getAllocatorStats()).toBeNull();
+  });
+
+  it("should validate arguments", () => {
+    const pipeline = new Pipeline("appsrc name=src ! fakesink");
+    const src = getAppSource(pipeline);
+
+    // @ts-expect-error Testing a missing argument
+    expect(() => src.setAllocator()).toThrow("options object or null");
+    expect(() => src.setAllocator({ alignment: 48 })).toThrow("power of two");
+    expect(() => src.setAllocator({ alignment: 1 << 30 })).toThrow("power of two");
+    // @ts-expect-error Testing an invalid alignment
+    expect(() => src.setAllocator({ alignment: "huge" })).toThrow("power of two");
+  });
+});
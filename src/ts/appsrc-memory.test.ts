@@ -0,0 +1,104 @@
+import { mkdtempSync, readFileSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { arePluginsAvailable, waitForEos } from "./test-utils";
+
+const getAppElements = (pipeline: InstanceType<typeof Pipeline>) => {
+  const src = pipeline.getElementByName("src");
+  const sink = pipeline.getElementByName("sink");
+  if (src?.type !== "app-src-element" || sink?.type !== "app-sink-element") {
+    throw new Error("Expected app source and sink");
+  }
+  return { src, sink };
+};
+
+describe("AppSrc memory source", () => {
+  it("should serve the memory in blocks until end of stream", async () => {
+    const data = Buffer.alloc(10000);
+    for (let i = 0; i < data.length; i++) data[i] = i % 251;
+
+    const pipeline = new Pipeline("appsrc name=src ! appsink name=sink sync=false");
+    const { src, sink } = getAppElements(pipeline);
+    src.setMemorySource(data, { blockSize: 4000 });
+
+    await pipeline.play();
+    const chunks: Buffer[] = [];
+    while (true) {
+      const sample = await sink.getSample(1000);
+      if (!sample?.buffer) break;
+      chunks.push(sample.buffer);
+    }
+    await pipeline.stop();
+
+    expect(chunks.map(chunk => chunk.length)).toEqual([4000, 4000, 2000]);
+    expect(Buffer.concat(chunks).equals(data)).toBe(true);
+  });
+
+  it("should accept ArrayBuffers and typed array views", async () => {
+    const bytes = new Uint8Array([0, 1, 2, 3, 4, 5, 6, 7, 8, 9]);
+
+    const pipeline = new Pipeline("appsrc name=src ! appsink name=sink sync=false");
+    const { src, sink } = getAppElements(pipeline);
+    src.setMemorySource(bytes.subarray(2, 8));
+
+    await pipeline.play();
+    const sample = await sink.getSample(1000);
+    await pipeline.stop();
+
+    expect([...(sample?.buffer ?? [])]).toEqual([2, 3, 4, 5, 6, 7]);
+    expect(() => src.setMemorySource(bytes.buffer)).not.toThrow();
+  });
+
+  it.skipIf(!arePluginsAvailable(["jpegenc", "jpegdec", "matroskamux", "matroskademux"]))(
+    "should let a demuxer seek through in-memory media",
+    async () => {
+      const path = join(mkdtempSync(join(tmpdir(), "gst-kit-")), "clip.mkv");
+      const recorder = new Pipeline(
+        "videotestsrc num-buffers=90 ! video/x-raw,width=64,height=48,framerate=30/1 " +
+          `! jpegenc ! matroskamux ! filesink location=${path}`
+      );
+      await recorder.play();
+      await waitForEos(recorder);
+      await recorder.stop();
+
+      const pipeline = new Pipeline(
+        "appsrc name=src ! matroskademux ! jpegdec ! appsink name=sink sync=false"
+      );
+      const { src, sink } = getAppElements(pipeline);
+      src.setMemorySource(readFileSync(path));
+
+      await pipeline.pause();
+      expect(pipeline.seek(2)).toBe(true);
+      await pipeline.play();
+
+      const sample = await sink.getSample(2000);
+      const rest: number[] = [];
+      while (true) {
+        const next = await sink.getSample(1000);
+        if (!next) break;
+        rest.push(next.pts ?? 0);
+      }
+      await pipeline.stop();
+
+      // Every frame is a keyframe, so the demuxer lands exactly on 2 seconds
+      expect((sample?.pts ?? 0) / 1e9).toBeCloseTo(2, 1);
+      expect(rest.length).toBe(29);
+    }
+  );
+
+  it("should validate arguments", () => {
+    const pipeline = new Pipeline("appsrc name=src ! fakesink");
+    const src = pipeline.getElementByName("src");
+    if (src?.type !== "app-src-element") throw new Error("Expected app source element");
+
+    // @ts-expect-error Testing an invalid argument
+    expect(() => src.setMemorySource(42)).toThrow("Buffer, typed array or ArrayBuffer");
+    expect(() => src.setMemorySource(Buffer.alloc(0))).toThrow("non-empty");
+    expect(() => src.setMemorySource(Buffer.alloc(8), { blockSize: 0 })).toThrow("blockSize");
+    expect(() => src.setMemorySource(Buffer.alloc(8), { caps: "not caps (" })).toThrow(
+      "Invalid caps"
+    );
+  });
+});
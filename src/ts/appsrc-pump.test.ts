@@ -0,0 +1,82 @@
+import { closeSync, mkdtempSync, openSync, writeFileSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { isWindows } from "./test-utils";
+
+const getAppElements = (pipeline: InstanceType<typeof Pipeline>) => {
+  const src = pipeline.getElementByName("src");
+  const sink = pipeline.getElementByName("sink");
+  if (src?.type !== "app-src-element" || sink?.type !== "app-sink-element") {
+    throw new Error("Expected app source and sink");
+  }
+  return { src, sink };
+};
+
+describe("AppSrc pumpFrom", () => {
+  it("should pump a file descriptor until end of file", async () => {
+    const data = Buffer.alloc(300000);
+    for (let i = 0; i < data.length; i++) data[i] = i % 253;
+    const path = join(mkdtempSync(join(tmpdir(), "gst-kit-")), "input.bin");
+    writeFileSync(path, data);
+    const fd = openSync(path, "r");
+
+    const pipeline = new Pipeline("appsrc name=src ! appsink name=sink sync=false");
+    const { src, sink } = getAppElements(pipeline);
+
+    await pipeline.play();
+    const pump = src.pumpFrom(fd, { chunkSize: 65536, readahead: 131072 });
+
+    const chunks: Buffer[] = [];
+    while (true) {
+      const sample = await sink.getSample(2000);
+      if (!sample?.buffer) break;
+      chunks.push(sample.buffer);
+    }
+    const result = await pump.done;
+    await pipeline.stop();
+    closeSync(fd);
+
+    expect(result).toEqual({ bytes: 300000, buffers: 5, stopped: false });
+    expect(chunks.map(chunk => chunk.length)).toEqual([65536, 65536, 65536, 65536, 37856]);
+    expect(Buffer.concat(chunks).equals(data)).toBe(true);
+  });
+
+  it.skipIf(isWindows)("should stop an endless source", async () => {
+    const fd = openSync("/dev/zero", "r");
+
+    // A bounded sink, so the backpressure reaches the app source
+    const pipeline = new Pipeline("appsrc name=src ! appsink name=sink sync=false max-buffers=4");
+    const { src, sink } = getAppElements(pipeline);
+
+    await pipeline.play();
+    const pump = src.pumpFrom(fd, { chunkSize: 4096, readahead: 16384 });
+
+    for (let i = 0; i < 10; i++) {
+      const sample = await sink.getSample(2000);
+      expect(sample?.buffer?.length).toBe(4096);
+    }
+    pump.stop();
+    const result = await pump.done;
+    await pipeline.stop();
+    closeSync(fd);
+
+    // Reading pauses at the readahead, so little more than what was pulled has been read
+    expect(result.stopped).toBe(true);
+    expect(result.buffers).toBeGreaterThanOrEqual(10);
+    expect(result.bytes).toBeLessThan(10 * 4096 + 16384 + 8 * 4096);
+  });
+
+  it("should validate arguments", () => {
+    const pipeline = new Pipeline("appsrc name=src ! fakesink");
+    const src = pipeline.getElementByName("src");
+    if (src?.type !== "app-src-element") throw new Error("Expected app source element");
+
+    // @ts-expect-error Testing an invalid descriptor
+    expect(() => src.pumpFrom("0")).toThrow("file descriptor");
+    expect(() => src.pumpFrom(-1)).toThrow("file descriptor");
+    expect(() => src.pumpFrom(0, { chunkSize: 0 })).toThrow("chunkSize");
+    expect(() => src.pumpFrom(0, { readahead: 0 })).toThrow("readahead");
+  });
+});
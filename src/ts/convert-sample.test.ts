@@ -0,0 +1,68 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, convertSample, type GStreamerSample } from ".";
+
+const grabFrame = async (caps: string): Promise<GStreamerSample> => {
+  const pipeline = new Pipeline(`videotestsrc num-buffers=1 ! ${caps} ! appsink name=sink`);
+  const sink = pipeline.getElementByName("sink");
+
+  if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+  await pipeline.play();
+  const sample = await sink.getSample();
+  await pipeline.stop();
+
+  if (!sample) throw new Error("Expected a sample");
+  return sample;
+};
+
+describe("convertSample", () => {
+  it("should convert and scale a frame", async () => {
+    const sample = await grabFrame("video/x-raw,format=I420,width=320,height=240");
+
+    const result = await convertSample(sample, { format: "RGBA", width: 160, height: 120 });
+
+    expect(result.buffer?.length).toBe(160 * 120 * 4);
+    expect(result.caps?.name).toBe("video/x-raw");
+    expect(result.caps?.format).toBe("RGBA");
+    expect(result.caps?.width).toBe(160);
+    expect(result.caps?.height).toBe(120);
+    expect(result.caps?.framerate).toBe(sample.caps?.framerate);
+  });
+
+  it("should keep the aspect ratio when only one dimension is given", async () => {
+    const sample = await grabFrame("video/x-raw,format=RGBA,width=320,height=240");
+
+    const result = await convertSample(sample, { width: 64 });
+
+    expect(result.caps?.format).toBe("RGBA");
+    expect(result.caps?.height).toBe(48);
+    expect(result.buffer?.length).toBe(64 * 48 * 4);
+  });
+
+  it("should crop before scaling", async () => {
+    // The first SMPTE bar is white, so the crop holds nothing but white pixels
+    const sample = await grabFrame("video/x-raw,format=RGBA,width=320,height=240");
+
+    const result = await convertSample(sample, {
+      format: "GRAY8",
+      crop: { x: 0, y: 0, width: 40, height: 100 },
+    });
+
+    expect(result.caps?.width).toBe(40);
+    expect(result.caps?.height).toBe(100);
+    expect(Math.min(...(result.buffer ?? []))).toBeGreaterThan(180);
+  });
+
+  it("should reject invalid options", async () => {
+    const sample = await grabFrame("video/x-raw,format=I420,width=320,height=240");
+
+    expect(() => convertSample(sample, { format: "NOPE" })).toThrow("Unknown video format");
+    expect(() => convertSample(sample, { crop: { x: 300, width: 40 } })).toThrow("crop");
+    // Each sum would wrap around a 32-bit int
+    expect(() =>
+      convertSample(sample, { crop: { x: 2 ** 31 - 1, width: 2 ** 31 - 1 } })
+    ).toThrow("crop");
+    expect(() => convertSample(sample, { crop: { y: 100, height: 2 ** 31 - 1 } })).toThrow("crop");
+    expect(() => convertSample({ buffer: Buffer.alloc(4) })).toThrow("buffer and caps");
+  });
+});
@@ -0,0 +1,60 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, type AudioLevels } from ".";
+import { collectUntilEos } from "./test-utils";
+
+const measure = (source: string, format: string, intervalMs?: number) => {
+  const pipeline = new Pipeline(
+    `${source} num-buffers=200 ! audio/x-raw,format=${format},rate=48000,channels=2 ` +
+      "! identity name=meter ! fakesink sync=false"
+  );
+  const meter = pipeline.getElementByName("meter");
+
+  return collectUntilEos<AudioLevels>(pipeline, push =>
+    meter?.addAudioMeter("src", push, { intervalMs })
+  );
+};
+
+describe("Element Audio Meter", () => {
+  it.each(["S16LE", "S32LE", "F32LE"])("should measure a sine wave in %s", async format => {
+    const results = await measure("audiotestsrc wave=sine freq=997 volume=0.5", format);
+    const last = results.at(-1);
+
+    expect(results.length).toBeGreaterThan(10);
+    expect(last?.peak).toHaveLength(2);
+    expect(last?.peak[0]).toBeCloseTo(-6.02, 1);
+    expect(last?.rms[0]).toBeCloseTo(-9.03, 1);
+    expect(last?.truePeak[0]).toBeGreaterThanOrEqual(last?.peak[0] ?? 0);
+    expect(last?.truePeak[0]).toBeLessThan(-5.5);
+    // Two channels at -9.03 LUFS each add up to -6.02 LUFS
+    expect(last?.momentary).toBeCloseTo(-6.02, 0);
+    expect(last?.shortTerm).toBeCloseTo(-6.02, 0);
+  });
+
+  it("should report silence as -Infinity", async () => {
+    const results = await measure("audiotestsrc wave=silence", "F32LE");
+    const last = results.at(-1);
+
+    expect(last?.peak[0]).toBe(-Infinity);
+    expect(last?.rms[1]).toBe(-Infinity);
+    expect(last?.momentary).toBe(-Infinity);
+  });
+
+  it("should deliver one result per window", async () => {
+    const results = await measure("audiotestsrc", "F32LE", 500);
+
+    // 200 buffers of 1024 samples at 48kHz are about 4.3 seconds
+    expect(results.length).toBeGreaterThanOrEqual(7);
+    expect(results.length).toBeLessThanOrEqual(9);
+    expect(results[0]?.duration).toBeGreaterThanOrEqual(0.5);
+    expect(results[0]?.momentary).not.toBeNull();
+    expect(results[0]?.shortTerm).toBeNull();
+  });
+
+  it("should reject invalid arguments", () => {
+    const pipeline = new Pipeline("audiotestsrc ! identity name=meter ! fakesink");
+    const meter = pipeline.getElementByName("meter");
+
+    expect(() => meter?.addAudioMeter("no_such_pad", () => {})).toThrow("Failed to get pad");
+    expect(() => meter?.addAudioMeter("src", () => {}, { intervalMs: 0 })).toThrow("intervalMs");
+  });
+});
@@ -0,0 +1,85 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, hammingDistance, type FingerprintBatch } from ".";
+import { collectUntilEos, sleep } from "./test-utils";
+
+const fingerprint = (description: string, options?: Record<string, unknown>) => {
+  const pipeline = new Pipeline(`${description} ! identity name=hash ! fakesink sync=false`);
+  const hash = pipeline.getElementByName("hash");
+
+  return collectUntilEos<FingerprintBatch>(pipeline, push =>
+    hash?.addFingerprinter("src", push, options)
+  );
+};
+
+describe("Element Fingerprinter", () => {
+  it("should deliver hashes in batches", async () => {
+    const batches = await fingerprint("videotestsrc num-buffers=25 ! video/x-raw,format=I420", {
+      batchSize: 10,
+    });
+
+    expect(batches.map(batch => batch.hashes.length)).toEqual([10, 10, 5]);
+    expect(batches[0]?.hashes).toBeInstanceOf(BigUint64Array);
+    expect(batches[0]?.pts).toBeInstanceOf(Float64Array);
+    expect(batches[0]?.pts[1]).toBeGreaterThan(batches[0]?.pts[0] ?? 0);
+  });
+
+  it.each(["phash", "dhash"])("should give identical frames the same %s", async algorithm => {
+    const batches = await fingerprint(
+      "videotestsrc pattern=smpte num-buffers=5 ! video/x-raw,format=RGBx",
+      { algorithm }
+    );
+    const hashes = batches.flatMap(batch => Array.from(batch.hashes));
+
+    expect(hashes).toHaveLength(5);
+    expect(new Set(hashes).size).toBe(1);
+  });
+
+  it("should tell different pictures apart", async () => {
+    const raw = "video/x-raw,format=I420";
+    const [smpte] = await fingerprint(`videotestsrc pattern=smpte num-buffers=1 ! ${raw}`);
+    const [checkers] = await fingerprint(`videotestsrc pattern=checkers-8 num-buffers=1 ! ${raw}`);
+    // Same picture at twice the resolution
+    const [scaled] = await fingerprint(
+      `videotestsrc pattern=smpte num-buffers=1 ! ${raw} ! videoscale ! ${raw},width=640,height=480`
+    );
+
+    const a = smpte?.hashes[0] ?? 0n;
+    expect(hammingDistance(a, checkers?.hashes[0] ?? 0n)).toBeGreaterThan(10);
+    expect(hammingDistance(a, scaled?.hashes[0] ?? 0n)).toBeLessThanOrEqual(6);
+  });
+
+  it("should hand out the partial batch on unsubscribe", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc is-live=true ! video/x-raw,format=I420,framerate=30/1 " +
+        "! identity name=hash ! fakesink"
+    );
+    const hash = pipeline.getElementByName("hash");
+    const batches: FingerprintBatch[] = [];
+
+    const stop = hash?.addFingerprinter("src", batch => batches.push(batch), { batchSize: 1000 });
+    await pipeline.play();
+    await sleep(300);
+    stop?.();
+    await sleep(50);
+    await pipeline.stop();
+
+    expect(batches).toHaveLength(1);
+    expect(batches[0]?.hashes.length).toBeGreaterThan(0);
+  });
+
+  it("should count differing bits", () => {
+    expect(hammingDistance(0n, 0n)).toBe(0);
+    expect(hammingDistance(0b1011n, 0b0001n)).toBe(2);
+    expect(hammingDistance(0xffffffffffffffffn, 0n)).toBe(64);
+  });
+
+  it("should reject invalid options", () => {
+    const pipeline = new Pipeline("videotestsrc ! identity name=hash ! fakesink");
+    const hash = pipeline.getElementByName("hash");
+
+    expect(() => hash?.addFingerprinter("src", () => {}, { algorithm: "md5" as "phash" })).toThrow(
+      "algorithm"
+    );
+    expect(() => hash?.addFingerprinter("src", () => {}, { batchSize: 0 })).toThrow("batchSize");
+  });
+});
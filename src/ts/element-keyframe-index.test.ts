@@ -0,0 +1,151 @@
+import { mkdtempSync, readFileSync, writeFileSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+import { describe, expect, it } from "vitest";
+import { Pipeline, loadKeyframeIndex } from ".";
+import { arePluginsAvailable, waitForEos } from "./test-utils";
+
+const tempPath = (name: string) => join(mkdtempSync(join(tmpdir(), "gst-kit-")), name);
+
+// Raw frames carry no DELTA_UNIT flag, so every buffer counts as a keyframe
+const STREAM = "videotestsrc num-buffers=90 ! video/x-raw,width=160,height=120,framerate=30/1";
+const FRAME_SIZE = 160 * 120 * 1.5;
+
+describe("Element KeyframeIndexer", () => {
+  it("should index keyframe times and byte offsets", async () => {
+    const pipeline = new Pipeline(`${STREAM} ! identity name=tap ! fakesink sync=false`);
+    const indexer = pipeline.getElementByName("tap")?.addKeyframeIndexer("src");
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    await pipeline.stop();
+
+    // Raw video offsets are frame numbers, so positions come from the running byte count
+    const index = indexer?.getIndex();
+    expect(index?.count).toBe(90);
+    expect(index?.pts[45]).toBeCloseTo(1.5, 6);
+    expect(index?.offsets[45]).toBe(45 * FRAME_SIZE);
+    expect(index?.sizes[45]).toBe(FRAME_SIZE);
+
+    indexer?.clear();
+    expect(indexer?.getIndex().count).toBe(0);
+    indexer?.stop();
+  });
+
+  it("should save and load a sidecar file", async () => {
+    const pipeline = new Pipeline(`${STREAM} ! identity name=tap ! fakesink sync=false`);
+    const indexer = pipeline.getElementByName("tap")?.addKeyframeIndexer("src");
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    await pipeline.stop();
+
+    const path = tempPath("stream.gkfi");
+    const result = await indexer?.save(path);
+    expect(result).toEqual({ entries: 90, bytes: 16 + 90 * 20 });
+    expect(readFileSync(path).subarray(0, 4).toString()).toBe("GKFI");
+
+    const loaded = await loadKeyframeIndex(path);
+    const index = indexer?.getIndex();
+    expect(loaded.count).toBe(90);
+    expect(loaded.pts).toEqual(index?.pts);
+    expect(loaded.offsets).toEqual(index?.offsets);
+    expect(loaded.sizes).toEqual(index?.sizes);
+    indexer?.stop();
+  });
+
+  it.skipIf(!arePluginsAvailable(["x264enc", "h264parse"]))(
+    "should point at keyframes in the recorded file",
+    async () => {
+      const path = tempPath("stream.h264");
+      const pipeline = new Pipeline(
+        "videotestsrc num-buffers=120 ! video/x-raw,width=160,height=120,framerate=30/1 " +
+          "! x264enc key-int-max=30 ! h264parse ! video/x-h264,stream-format=byte-stream " +
+          `! filesink name=sink location=${path}`
+      );
+      const indexer = pipeline.getElementByName("sink")?.addKeyframeIndexer("sink");
+
+      await pipeline.play();
+      await waitForEos(pipeline);
+      await pipeline.stop();
+
+      // One keyframe per second of video
+      const index = indexer?.getIndex();
+      expect(index?.count).toBeGreaterThanOrEqual(4);
+      expect(index?.pts[1]).toBeCloseTo(1, 3);
+
+      // Every entry starts with an Annex B start code
+      const data = readFileSync(path);
+      for (const offset of index?.offsets ?? []) {
+        expect(data.readUInt32BE(offset) === 1 || data.readUIntBE(offset, 3) === 1).toBe(true);
+      }
+      indexer?.stop();
+    }
+  );
+
+  it("should seek to the keyframe before a position", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=300 ! video/x-raw,framerate=30/1 ! fakesink"
+    );
+    const index = {
+      count: 3,
+      pts: new Float64Array([0, 1, 2]),
+      offsets: new Float64Array([0, 1000, 2000]),
+      sizes: new Float64Array([100, 100, 100]),
+    };
+
+    await pipeline.play();
+
+    // The sizes array has the wrong type
+    // @ts-expect-error Testing an invalid index
+    expect(() => pipeline.seek(1.5, { index })).toThrow("keyframe index");
+
+    const valid = { ...index, sizes: new Uint32Array([100, 100, 100]) };
+    expect(pipeline.seek(1.5, { index: valid })).toBe(true);
+    await pipeline.pause();
+
+    const position = pipeline.queryPosition();
+    if (position !== -1) {
+      expect(position).toBeCloseTo(1, 1);
+    }
+
+    const empty = {
+      count: 0,
+      pts: new Float64Array(),
+      offsets: new Float64Array(),
+      sizes: new Uint32Array(),
+    };
+    expect(pipeline.seek(1.5, { index: empty })).toBe(false);
+    // @ts-expect-error Testing an invalid format
+    expect(() => pipeline.seek(1.5, { index: valid, format: "frames" })).toThrow("format");
+
+    await pipeline.stop();
+  });
+
+  it("should validate arguments", async () => {
+    const pipeline = new Pipeline("videotestsrc ! identity name=tap ! fakesink");
+    const tap = pipeline.getElementByName("tap");
+
+    expect(() => tap?.addKeyframeIndexer("nope")).toThrow("Failed to get pad");
+
+    const indexer = tap?.addKeyframeIndexer("src");
+    // @ts-expect-error Testing a missing path
+    expect(() => indexer?.save()).toThrow("file path");
+    indexer?.stop();
+
+    const path = tempPath("broken.gkfi");
+    writeFileSync(path, "not an index");
+    await expect(loadKeyframeIndex(path)).rejects.toThrow("not a keyframe index");
+
+    // A header claiming far more entries than follow it
+    const header = Buffer.alloc(16);
+    header.write("GKFI");
+    header.writeUInt16LE(1, 4);
+    header.writeUInt16LE(20, 6);
+    header.writeUInt32LE(0xffffffff, 8);
+    writeFileSync(path, Buffer.concat([header, Buffer.alloc(20)]));
+    await expect(loadKeyframeIndex(path)).rejects.toThrow("is truncated");
+
+    await expect(loadKeyframeIndex(tempPath("missing.gkfi"))).rejects.toThrow("Failed to open");
+  });
+});
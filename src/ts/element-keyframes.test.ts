@@ -0,0 +1,59 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { waitForEos } from "./test-utils";
+
+describe("Element Keyframes", () => {
+  it("should apply keyframed values while streaming", async () => {
+    const pipeline = new Pipeline(
+      "audiotestsrc num-buffers=50 ! volume name=vol ! fakesink sync=false"
+    );
+    const volume = pipeline.getElementByName("vol");
+
+    volume?.setKeyframes(
+      "volume",
+      [
+        { time: 0, value: 0.25 },
+        { time: 0.1, value: 0.75 },
+      ],
+      { mode: "none" }
+    );
+    await pipeline.play();
+    const message = await waitForEos(pipeline);
+    await pipeline.stop();
+
+    expect(message?.type).toBe("eos");
+    expect(volume?.getElementProperty("volume")?.value).toBeCloseTo(0.75);
+  });
+
+  it("should replace and clear keyframes", async () => {
+    const pipeline = new Pipeline(
+      "audiotestsrc num-buffers=50 ! volume name=vol ! fakesink sync=false"
+    );
+    const volume = pipeline.getElementByName("vol");
+
+    volume?.setKeyframes("volume", [{ time: 0, value: 0.5 }]);
+    volume?.setKeyframes("volume", [{ time: 0, value: 0.1 }], { replace: true });
+    await pipeline.play();
+    await waitForEos(pipeline);
+    await pipeline.stop();
+
+    expect(volume?.getElementProperty("volume")?.value).toBeCloseTo(0.1);
+    expect(volume?.clearKeyframes("volume")).toBe(true);
+    expect(volume?.clearKeyframes("volume")).toBe(false);
+  });
+
+  it("should reject invalid input", () => {
+    const pipeline = new Pipeline("audiotestsrc ! volume name=vol ! fakesink");
+    const volume = pipeline.getElementByName("vol");
+
+    expect(() => volume?.setKeyframes("no-such-property", [])).toThrow("not found");
+    expect(() => volume?.setKeyframes("name", [])).toThrow("not controllable");
+    expect(() => volume?.setKeyframes("volume", [{ time: -1, value: 1 }])).toThrow();
+    expect(() => volume?.setKeyframes("volume", [], { mode: "bezier" as "linear" })).toThrow(
+      "Interpolation mode"
+    );
+    expect(() => volume?.setKeyframes("volume", [], { pad: "no_such_pad" })).toThrow(
+      "Failed to get pad"
+    );
+  });
+});
@@ -0,0 +1,70 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, type MotionEvent } from ".";
+import { collectUntilEos, sleep } from "./test-utils";
+
+describe("Element Motion Detector", () => {
+  it.each(["I420", "NV12", "GRAY8", "RGBx"])("should detect motion in %s", async format => {
+    const pipeline = new Pipeline(
+      "videotestsrc pattern=ball num-buffers=30 " +
+        `! video/x-raw,format=${format},width=320,height=240 ` +
+        "! identity name=analyze ! fakesink sync=false"
+    );
+    const analyze = pipeline.getElementByName("analyze");
+
+    const events = await collectUntilEos<MotionEvent>(pipeline, push =>
+      analyze?.addMotionDetector("src", push, { motionThreshold: 0.005 })
+    );
+
+    const start = events.find(event => event.type === "motion-start");
+    expect(start).toBeDefined();
+    expect(start?.columns).toBe(20);
+    expect(start?.rows).toBe(15);
+    expect(start?.mask).toHaveLength(300);
+    expect(start?.mask?.some(block => block === 1)).toBe(true);
+  });
+
+  it("should stay quiet on a static picture", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc pattern=smpte num-buffers=30 ! video/x-raw,format=I420 " +
+        "! identity name=analyze ! fakesink sync=false"
+    );
+    const analyze = pipeline.getElementByName("analyze");
+
+    const events = await collectUntilEos<MotionEvent>(pipeline, push =>
+      analyze?.addMotionDetector("src", push)
+    );
+
+    expect(events).toEqual([]);
+  });
+
+  it("should report scene changes", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc name=src pattern=black ! video/x-raw,format=I420,framerate=30/1 " +
+        "! identity name=analyze ! fakesink"
+    );
+    const source = pipeline.getElementByName("src");
+    const analyze = pipeline.getElementByName("analyze");
+    const events: MotionEvent[] = [];
+
+    const stop = analyze?.addMotionDetector("src", event => events.push(event));
+    await pipeline.play();
+    await sleep(300);
+    source?.setElementProperty("pattern", "white");
+    await sleep(300);
+    stop?.();
+    await pipeline.stop();
+
+    const cut = events.find(event => event.type === "scene-change");
+    expect(cut?.score).toBeGreaterThan(0.9);
+  });
+
+  it("should reject invalid options", () => {
+    const pipeline = new Pipeline("videotestsrc ! identity name=analyze ! fakesink");
+    const analyze = pipeline.getElementByName("analyze");
+
+    expect(() => analyze?.addMotionDetector("src", () => {}, { sceneThreshold: 2 })).toThrow(
+      "between 0 and 1"
+    );
+    expect(() => analyze?.addMotionDetector("sink_9", () => {})).toThrow("Failed to get pad");
+  });
+});
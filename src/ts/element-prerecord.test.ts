@@ -0,0 +1,118 @@
+import { mkdtempSync, statSync } from "node:fs";
+import { tmpdir } from "node:os";
+import { join } from "node:path";
+import { describe, expect, it } from "vitest";
+import { GstBufferFlags, Pipeline } from ".";
+import { arePluginsAvailable, waitForEos } from "./test-utils";
+
+// Raw frames carry no DELTA_UNIT flag, so every buffer counts as a keyframe
+const STREAM = "videotestsrc num-buffers=90 ! video/x-raw,width=160,height=120,framerate=30/1";
+
+describe("Element PreRecordBuffer", () => {
+  it("should keep the last N seconds", async () => {
+    const pipeline = new Pipeline(`${STREAM} ! identity name=tap ! fakesink sync=false`);
+    const ring = pipeline.getElementByName("tap")?.addPreRecordBuffer("src", { seconds: 1 });
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    await pipeline.stop();
+
+    // The shortest run of frames covering a second
+    const stats = ring?.getStats();
+    expect(stats?.duration).toBeCloseTo(1, 3);
+    expect(stats?.buffers).toBe(30);
+    expect(stats?.bytes).toBe(30 * 160 * 120 * 1.5);
+
+    ring?.clear();
+    expect(ring?.getStats()).toEqual({ buffers: 0, bytes: 0, duration: 0 });
+    ring?.stop();
+  });
+
+  it("should cap the stored bytes", async () => {
+    const pipeline = new Pipeline(`${STREAM} ! identity name=tap ! fakesink sync=false`);
+    const ring = pipeline
+      .getElementByName("tap")
+      ?.addPreRecordBuffer("src", { seconds: 60, maxBytes: 200000 });
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    await pipeline.stop();
+
+    const stats = ring?.getStats();
+    expect(stats?.bytes).toBeLessThanOrEqual(200000);
+    expect(stats?.buffers).toBe(6);
+    ring?.stop();
+  });
+
+  it("should flush to a file", async () => {
+    const pipeline = new Pipeline(`${STREAM} ! identity name=tap ! fakesink sync=false`);
+    const ring = pipeline.getElementByName("tap")?.addPreRecordBuffer("src", { seconds: 2 });
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    await pipeline.stop();
+
+    const path = join(mkdtempSync(join(tmpdir(), "gst-kit-")), "prerecord.yuv");
+    const result = await ring?.flushTo(path);
+
+    expect(result?.buffers).toBe(ring?.getStats().buffers);
+    expect(statSync(path).size).toBe(result?.bytes);
+    ring?.stop();
+  });
+
+  it.skipIf(!arePluginsAvailable(["x264enc", "h264parse"]))(
+    "should start at a keyframe when flushing into an app source",
+    async () => {
+      const pipeline = new Pipeline(
+        "videotestsrc num-buffers=120 ! video/x-raw,width=160,height=120,framerate=30/1 " +
+          "! x264enc key-int-max=30 ! h264parse ! identity name=tap ! fakesink sync=false"
+      );
+      const ring = pipeline.getElementByName("tap")?.addPreRecordBuffer("src", { seconds: 1 });
+
+      await pipeline.play();
+      await waitForEos(pipeline);
+      await pipeline.stop();
+
+      // Keyframes every second, so keeping one second needs up to two GOPs
+      const stats = ring?.getStats();
+      expect(stats?.duration).toBeGreaterThanOrEqual(1);
+      expect(stats?.duration).toBeLessThan(2);
+
+      const replay = new Pipeline("appsrc name=src ! appsink name=sink");
+      const src = replay.getElementByName("src");
+      const sink = replay.getElementByName("sink");
+      if (src?.type !== "app-src-element" || sink?.type !== "app-sink-element") {
+        throw new Error("Expected app source and sink");
+      }
+
+      await replay.play();
+      const result = await ring?.flushTo(src);
+      const first = await sink.getSample();
+      await replay.stop();
+
+      expect(result?.buffers).toBe(stats?.buffers);
+      expect((first?.flags ?? 0) & GstBufferFlags.GST_BUFFER_FLAG_DELTA_UNIT).toBe(0);
+      expect(first?.caps?.name).toBe("video/x-h264");
+      // Rebased from the 2-3s the buffers had in the recording pipeline
+      expect(first?.pts).toBeLessThan(0.1e9);
+      ring?.stop();
+    }
+  );
+
+  it("should validate arguments", () => {
+    const pipeline = new Pipeline("videotestsrc ! identity name=tap ! fakesink");
+    const tap = pipeline.getElementByName("tap");
+
+    expect(() => tap?.addPreRecordBuffer("nope")).toThrow("Failed to get pad");
+    expect(() => tap?.addPreRecordBuffer("src", { seconds: 0 })).toThrow("seconds");
+
+    const ring = tap?.addPreRecordBuffer("src");
+    // @ts-expect-error Testing invalid flush target
+    expect(() => ring?.flushTo(42)).toThrow("file path or an app-src-element");
+    expect(() =>
+      // @ts-expect-error Testing a look-alike that is not an element
+      ring?.flushTo({ type: "app-src-element" })
+    ).toThrow("not an app-src-element");
+    ring?.stop();
+  });
+});
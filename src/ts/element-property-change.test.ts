@@ -0,0 +1,95 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, type GStreamerPropertyReturnValue } from ".";
+import { sleep } from "./test-utils";
+
+type Changes = Record<string, GStreamerPropertyReturnValue>;
+
+describe("Element Property Change Notifications", () => {
+  it("should report property changes", async () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+    const changes: Changes[] = [];
+
+    const unsubscribe = element?.onPropertyChange(["pattern"], change => changes.push(change));
+    element?.setElementProperty("pattern", "ball");
+    await sleep(50);
+    unsubscribe?.();
+
+    expect(changes).toEqual([{ pattern: "ball" }]);
+  });
+
+  it("should coalesce bursts into one delivery", async () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+    const changes: Changes[] = [];
+
+    const unsubscribe = element?.onPropertyChange(["pattern", "num-buffers"], change =>
+      changes.push(change)
+    );
+    element?.setElementProperty("pattern", "ball");
+    element?.setElementProperty("pattern", "snow");
+    element?.setElementProperty("num-buffers", 5);
+    await sleep(50);
+    unsubscribe?.();
+
+    expect(changes).toEqual([{ pattern: "snow", "num-buffers": 5 }]);
+  });
+
+  it("should report changes from streaming threads", async () => {
+    const pipeline = new Pipeline("videotestsrc num-buffers=20 ! fakesink name=sink silent=false");
+    const sink = pipeline.getElementByName("sink");
+    const changes: Changes[] = [];
+
+    const unsubscribe = sink?.onPropertyChange(["last-message"], change => changes.push(change));
+    await pipeline.play();
+    await sleep(300);
+    unsubscribe?.();
+    await pipeline.stop();
+
+    expect(changes.length).toBeGreaterThan(0);
+    expect(typeof changes.at(-1)?.["last-message"]).toBe("string");
+  });
+
+  it("should respect minIntervalMs", async () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+    const changes: Changes[] = [];
+
+    const unsubscribe = element?.onPropertyChange(["num-buffers"], change => changes.push(change), {
+      minIntervalMs: 200,
+    });
+    element?.setElementProperty("num-buffers", 1);
+    await sleep(20);
+    element?.setElementProperty("num-buffers", 2);
+    await sleep(20);
+    element?.setElementProperty("num-buffers", 3);
+    await sleep(50);
+
+    // The first change is delivered right away, the rest wait for the interval
+    expect(changes).toEqual([{ "num-buffers": 1 }]);
+
+    await sleep(250);
+    unsubscribe?.();
+    expect(changes).toEqual([{ "num-buffers": 1 }, { "num-buffers": 3 }]);
+  });
+
+  it("should stop after unsubscribe", async () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+    const changes: Changes[] = [];
+
+    const unsubscribe = element?.onPropertyChange(["pattern"], change => changes.push(change));
+    unsubscribe?.();
+    element?.setElementProperty("pattern", "ball");
+    await sleep(50);
+
+    expect(changes).toEqual([]);
+  });
+
+  it("should throw on unknown properties", () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+
+    expect(() => element?.onPropertyChange(["no-such-property"], () => {})).toThrow("not found");
+  });
+});
@@ -0,0 +1,94 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { sleep } from "./test-utils";
+
+describe("Element Property Handles", () => {
+  it("should get and set through a handle", () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+    const pattern = element?.property("pattern");
+
+    expect(pattern?.name).toBe("pattern");
+    expect(pattern?.readable).toBe(true);
+    expect(pattern?.writable).toBe(true);
+
+    pattern?.set("ball");
+    expect(pattern?.get()).toBe("ball");
+    expect(element?.getElementProperty("pattern")?.value).toBe("ball");
+  });
+
+  it("should return plain values of every primitive type", () => {
+    const pipeline = new Pipeline("videotestsrc name=target num-buffers=42 is-live=true ! fakesink");
+    const element = pipeline.getElementByName("target");
+
+    expect(element?.property("num-buffers")?.get()).toBe(42);
+    expect(element?.property("is-live")?.get()).toBe(true);
+    expect(element?.property("num-buffers")?.type).toBe("gint");
+  });
+
+  it("should return null for unknown properties", () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    expect(pipeline.getElementByName("target")?.property("no-such-property")).toBeNull();
+  });
+
+  it("should reject values of the wrong type", () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const numBuffers = pipeline.getElementByName("target")?.property("num-buffers");
+
+    expect(() => numBuffers?.set("many")).toThrow("Expected number value");
+  });
+
+  it("should reject values out of the property's range", () => {
+    const pipeline = new Pipeline("audiotestsrc ! volume name=target ! fakesink");
+    const volume = pipeline.getElementByName("target")?.property("volume");
+
+    volume?.set(2);
+    expect(() => volume?.set(100)).toThrow("out of range");
+    expect(volume?.get()).toBe(2);
+  });
+
+  it("should notify listeners of values set through a handle", async () => {
+    const pipeline = new Pipeline("audiotestsrc ! volume name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+    const changes: Record<string, unknown>[] = [];
+
+    const unsubscribe = element?.onPropertyChange(["volume"], change => changes.push(change));
+    element?.property("volume")?.set(0.5);
+    await sleep(50);
+    unsubscribe?.();
+
+    expect(changes).toEqual([{ volume: 0.5 }]);
+  });
+
+  it("should get several properties at once", () => {
+    const pipeline = new Pipeline("videotestsrc name=target num-buffers=7 pattern=snow ! fakesink");
+    const values = pipeline
+      .getElementByName("target")
+      ?.getProperties(["num-buffers", "pattern", "no-such-property"]);
+
+    expect(values).toEqual({ "num-buffers": 7, pattern: "snow", "no-such-property": null });
+  });
+
+  it("should set several properties at once", () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+
+    element?.setProperties({ pattern: "ball", "num-buffers": 10, "is-live": true });
+
+    expect(element?.getProperties(["pattern", "num-buffers", "is-live"])).toEqual({
+      pattern: "ball",
+      "num-buffers": 10,
+      "is-live": true,
+    });
+  });
+
+  it("should not set anything when one value is invalid", () => {
+    const pipeline = new Pipeline("videotestsrc name=target ! fakesink");
+    const element = pipeline.getElementByName("target");
+
+    expect(() => element?.setProperties({ pattern: "ball", "num-buffers": "ten" })).toThrow(
+      "num-buffers"
+    );
+    expect(element?.property("pattern")?.get()).toBe("smpte");
+  });
+});
@@ -0,0 +1,77 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, encodeSample, type GStreamerSample } from ".";
+import { arePluginsAvailable } from "./test-utils";
+
+const grabFrame = async (caps: string): Promise<GStreamerSample> => {
+  const pipeline = new Pipeline(`videotestsrc num-buffers=1 ! ${caps} ! appsink name=sink`);
+  const sink = pipeline.getElementByName("sink");
+
+  if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+  await pipeline.play();
+  const sample = await sink.getSample();
+  await pipeline.stop();
+
+  if (!sample) throw new Error("Expected a sample");
+  return sample;
+};
+
+const RAW = "video/x-raw,format=I420,width=320,height=240";
+
+describe("encodeSample", () => {
+  it.skipIf(!arePluginsAvailable(["jpegenc"]))("should encode JPEG", async () => {
+    const sample = await grabFrame(RAW);
+
+    const jpeg = await encodeSample(sample);
+
+    expect(jpeg).toBeInstanceOf(Buffer);
+    expect(jpeg.subarray(0, 2)).toEqual(Buffer.from([0xff, 0xd8]));
+    expect(jpeg.length).toBeLessThan(sample.buffer?.length ?? 0);
+  });
+
+  it.skipIf(!arePluginsAvailable(["jpegenc"]))("should honor the quality", async () => {
+    const sample = await grabFrame(RAW);
+
+    const low = await encodeSample(sample, { codec: "jpeg", quality: 10 });
+    const high = await encodeSample(sample, { codec: "jpeg", quality: 95 });
+
+    expect(low.length).toBeLessThan(high.length);
+  });
+
+  it.skipIf(!arePluginsAvailable(["pngenc"]))("should encode PNG from any format", async () => {
+    const sample = await grabFrame(RAW);
+
+    const png = await encodeSample(sample, { codec: "png" });
+
+    expect(png.subarray(0, 4)).toEqual(Buffer.from([0x89, 0x50, 0x4e, 0x47]));
+  });
+
+  it.skipIf(!arePluginsAvailable(["webpenc"]))("should encode WebP", async () => {
+    const sample = await grabFrame(RAW);
+
+    const webp = await encodeSample(sample, { codec: "webp", quality: 50 });
+
+    expect(webp.subarray(0, 4).toString()).toBe("RIFF");
+    expect(webp.subarray(8, 12).toString()).toBe("WEBP");
+  });
+
+  it.skipIf(!arePluginsAvailable(["jpegenc"]))("should encode concurrently", async () => {
+    const small = await grabFrame(RAW);
+    const large = await grabFrame("video/x-raw,format=RGBA,width=640,height=480");
+
+    // Pooled pipelines renegotiate when consecutive frames differ in format and size
+    const results = await Promise.all(
+      Array.from({ length: 8 }, (_, i) => encodeSample(i % 2 ? small : large))
+    );
+
+    expect(results.every(jpeg => jpeg[0] === 0xff && jpeg[1] === 0xd8)).toBe(true);
+  });
+
+  it("should reject invalid options", async () => {
+    const sample = await grabFrame(RAW);
+
+    // @ts-expect-error Testing unsupported codec
+    expect(() => encodeSample(sample, { codec: "gif" })).toThrow("Unknown codec");
+    expect(() => encodeSample(sample, { quality: 101 })).toThrow("quality");
+  });
+});
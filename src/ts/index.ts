@@ -14,6 +14,29 @@ export type GStreamerPropertyValue =
   | GStreamerPropertyPrimitiveValue
   | GStreamerPropertyPrimitiveValue[];
 
+// Typed view matching a raw audio format (e.g. Int16Array for S16LE, Float32Array for F32LE)
+export type AudioSampleArray =
+  | Int8Array
+  | Uint8Array
+  | Int16Array
+  | Uint16Array
+  | Int32Array
+  | Uint32Array
+  | Float32Array
+  | Float64Array;
+
+// Raw audio in a sample, viewing the same memory as GStreamerSample.buffer. Only present for
+// formats with a matching typed array in host byte order (not packed 24-bit or byte-swapped).
+export type AudioSampleData = {
+  format: string; // e.g. "S16LE", "F32LE"
+  rate: number;
+  channels: number;
+  layout: "interleaved" | "non-interleaved";
+  frames: number; // Samples per channel
+  data?: AudioSampleArray; // Interleaved samples, frames * channels long
+  channelData?: AudioSampleArray[]; // One array per channel for non-interleaved audio
+};
+
 // Sample object returned for GST_VALUE_HOLDS_SAMPLE properties
 export type GStreamerSample = {
   buffer?: Buffer;
@@ -23,6 +46,7 @@ export type GStreamerSample = {
     // Additional structure fields (format, width, height, framerate, etc.)
     [key: string]: GStreamerPropertyValue | undefined;
   };
+  audio?: AudioSampleData; // Typed views for audio/x-raw samples
 };
 
 // GStreamer message object returned by busPop
@@ -111,10 +135,155 @@ export type BufferData = {
   rtp?: RTPData;
 };
 
+// Handle returned by element.property(), resolved once and reusable for fast repeated access.
+// get() returns the plain value, without the { type, value } wrapper of getElementProperty().
+export type PropertyHandle = {
+  readonly name: string;
+  readonly type: string; // GType name, e.g. "gint", "GstCaps"
+  readonly readable: boolean;
+  readonly writable: boolean;
+  get: () => GStreamerPropertyReturnValue;
+  set: (value: GStreamerPropertyValue) => void; // Throws for values out of the property's range
+};
+
+// One window of audio levels from ElementBase.addAudioMeter(), dB values are -Infinity for silence
+export type AudioLevels = {
+  pts?: number; // End of the last buffer in the window (nanoseconds)
+  duration: number; // Seconds of audio in the window
+  peak: Float64Array; // Sample peak per channel (dBFS)
+  rms: Float64Array; // RMS per channel (dBFS)
+  truePeak: Float64Array; // Oversampled peak per channel (dBTP)
+  momentary: number | null; // EBU R128 momentary loudness, 400ms window (LUFS)
+  shortTerm: number | null; // EBU R128 short-term loudness, 3s window (LUFS)
+};
+
+// Options for ElementBase.addMotionDetector()
+export type MotionDetectorOptions = {
+  analysisWidth?: number; // Frames are downscaled to about this width (default 160)
+  blockSize?: number; // Block edge in analysis pixels for the motion mask (default 8)
+  pixelThreshold?: number; // Mean luma difference (0-1) that marks a block as moving (default 0.06)
+  motionThreshold?: number; // Fraction of moving blocks that starts motion (default 0.02)
+  sceneThreshold?: number; // Luma histogram distance (0-1) that counts as a cut (default 0.5)
+  holdMs?: number; // Quiet time before motion ends (default 1000)
+};
+
+export type MotionEvent = {
+  type: "motion-start" | "motion-end" | "scene-change";
+  pts?: number; // Presentation timestamp of the frame (nanoseconds)
+  score: number; // Fraction of moving blocks, or the histogram distance for scene changes
+  difference: number; // Mean luma difference to the previous frame (0-1)
+  // Present on "motion-start": one byte per block in row-major order, 1 for moving blocks
+  mask?: Buffer;
+  columns?: number;
+  rows?: number;
+};
+
+// Options for ElementBase.addFingerprinter()
+export type FingerprintOptions = {
+  algorithm?: "phash" | "dhash"; // DCT-based pHash or gradient-based dHash (default "phash")
+  batchSize?: number; // Frames per callback, the rest comes at EOS or on unsubscribe (default 30)
+};
+
+// 64-bit perceptual hashes of consecutive frames and their presentation timestamps
+export type FingerprintBatch = {
+  hashes: BigUint64Array;
+  pts: Float64Array; // Nanoseconds, -1 for frames without a timestamp
+};
+
+// Options for ElementBase.addPreRecordBuffer()
+export type PreRecordOptions = {
+  seconds?: number; // Media time kept, counted from the oldest keyframe (default 30)
+  // Hard cap, whole GOPs are dropped to stay below it (default 256 MiB, 0 for none)
+  maxBytes?: number;
+};
+
+export type PreRecordStats = {
+  buffers: number;
+  bytes: number;
+  duration: number; // Seconds
+};
+
+// Rolling native buffer of the most recent encoded data on a pad
+export type PreRecordBuffer = {
+  // Write the buffered data to a file, or push it into an app source with timestamps starting
+  // at 0, from a native thread
+  flushTo: (target: string | AppSrcElement) => Promise<PreRecordStats>;
+  getStats: () => PreRecordStats;
+  clear: () => void;
+  stop: () => void; // Remove the probe and drop the buffered data
+};
+
+// Keyframe positions of an encoded stream, one typed array per field
+export type KeyframeIndex = {
+  count: number;
+  pts: Float64Array; // Stream time in seconds
+  offsets: Float64Array; // Byte position in the recorded stream
+  sizes: Uint32Array; // Size of the keyframe buffer in bytes
+};
+
+// Native index of the keyframes passing a pad
+export type KeyframeIndexer = {
+  getIndex: () => KeyframeIndex;
+  // Write the index to a compact binary sidecar file, read it back with loadKeyframeIndex()
+  save: (path: string) => Promise<{ entries: number; bytes: number }>;
+  clear: () => void;
+  stop: () => void; // Remove the probe, the collected index stays available
+};
+
+// Options for Pipeline.seek()
+export type SeekOptions = {
+  index?: KeyframeIndex; // Snap to the keyframe at or before the position
+  format?: "time" | "bytes"; // Seek to the keyframe's time or byte offset (default "time")
+};
+
+// A point on a property automation curve, time is stream time in seconds
+export type Keyframe = {
+  time: number;
+  value: number | boolean;
+};
+
+// Options for ElementBase.setKeyframes()
+export type KeyframeOptions = {
+  // Interpolation between keyframes (default "linear"), "none" holds each value until the next
+  mode?: "none" | "linear" | "cubic" | "cubic-monotonic";
+  // Automate a property of this pad instead of the element, e.g. "sink_0" of a compositor
+  pad?: string;
+  // Drop existing keyframes of the property first (default false)
+  replace?: boolean;
+};
+
 export type ElementBase = {
   getElementProperty: (key: string) => GStreamerPropertyResult;
   setElementProperty: (key: string, value: GStreamerPropertyValue) => void;
+  property: (key: string) => PropertyHandle | null;
+  // Plain values like PropertyHandle.get(), not GStreamerPropertyResult objects
+  getProperties: (keys: string[]) => Record<string, GStreamerPropertyReturnValue>;
+  setProperties: (values: Record<string, GStreamerPropertyValue>) => void;
+  onPropertyChange: (
+    keys: string[],
+    callback: (changes: Record<string, GStreamerPropertyReturnValue>) => void,
+    options?: { minIntervalMs?: number }
+  ) => () => void;
+  setKeyframes: (key: string, keyframes: Keyframe[], options?: KeyframeOptions) => void;
+  clearKeyframes: (key: string, options?: { pad?: string }) => boolean;
   addPadProbe: (padName: string, callback: (bufferData: BufferData) => void) => () => void;
+  addAudioMeter: (
+    padName: string,
+    callback: (levels: AudioLevels) => void,
+    options?: { intervalMs?: number }
+  ) => () => void;
+  addMotionDetector: (
+    padName: string,
+    callback: (event: MotionEvent) => void,
+    options?: MotionDetectorOptions
+  ) => () => void;
+  addFingerprinter: (
+    padName: string,
+    callback: (batch: FingerprintBatch) => void,
+    options?: FingerprintOptions
+  ) => () => void;
+  addPreRecordBuffer: (padName: string, options?: PreRecordOptions) => PreRecordBuffer;
+  addKeyframeIndexer: (padName: string) => KeyframeIndexer;
   setPad: (attribute: string, padName: string) => void;
   getPad: (padName: string) => GstPad | null;
 };
@@ -123,18 +292,312 @@ type Element = {
   readonly type: "element";
 } & ElementBase;
 
+// Options for AppSinkElement.step()
+export type StepOptions = {
+  // "buffers" steps a number of frames, "time" steps a duration in seconds (default "buffers")
+  format?: "buffers" | "time";
+  // Playback rate applied while stepping (default 1.0)
+  rate?: number;
+  // How long to wait for the frame the step lands on (default 1000ms)
+  timeoutMs?: number;
+};
+
+// One plane of a mapped video frame, data views the frame memory directly
+export type VideoFramePlane = {
+  data: Uint8Array;
+  stride: number; // Bytes per row, including padding
+  offset: number; // Byte offset of the plane in the buffer
+  width: number; // Pixels of the plane's first component (subsampled for chroma planes)
+  height: number;
+};
+
+// Raw video frame mapped in place. The plane views become detached (zero length) after
+// release(), which unmaps the frame. They may only be written to when `writable` is true,
+// otherwise the memory is shared with the pipeline and must be treated as read-only.
+export type VideoFrame = {
+  format: string; // GStreamer video format name, e.g. "I420"
+  width: number;
+  height: number;
+  size: number; // Frame size in bytes
+  pts?: number; // Presentation timestamp (nanoseconds)
+  duration?: number; // Nanoseconds
+  flags: number;
+  writable: boolean; // Whether the frame was mapped for writing, see above
+  caps: {
+    name?: string;
+    [key: string]: GStreamerPropertyValue | undefined;
+  };
+  planes: VideoFramePlane[];
+  release(): void;
+};
+
+// Source rectangle in pixels for AppSinkElement.getRegions()
+export type RegionRect = { x: number; y: number; width: number; height: number };
+
+export type RegionOptions = {
+  timeoutMs?: number; // How long to wait for the next sample (default 1000)
+  format?: string; // Output video format (default: the sample's format)
+  scale?: number; // Downscale factor in (0, 1] applied to every region (default 1)
+};
+
+// One extracted region, laid out like a GStreamer frame of its own within the packed buffer
+export type RegionLayout = {
+  format: string;
+  width: number;
+  height: number;
+  offset: number; // Byte offset in RegionBatch.buffer
+  size: number;
+  strides: number[]; // Bytes per row of each plane
+};
+
+export type RegionBatch = {
+  buffer: Buffer; // All regions packed back to back, in request order
+  regions: RegionLayout[];
+  pts?: number; // Presentation timestamp (nanoseconds)
+  flags: number;
+};
+
+// Options for AppSinkElement.onSample(), each subscriber has its own
+export type SampleSubscriptionOptions = {
+  maxFps?: number; // Samples per second at most, of stream time or wall-clock with latestOnly
+  maxPending?: number; // Samples waiting for the callback at most (default no limit)
+  drop?: "newest" | "oldest"; // Which sample to drop when maxPending is reached (default newest)
+  latestOnly?: boolean; // Deliver only the newest sample, every 1/maxFps seconds (default false)
+};
+
 export type AppSinkElement = {
   readonly type: "app-sink-element";
   getSample(timeoutMs?: number): Promise<GStreamerSample | null>;
-  onSample(callback: (sample: GStreamerSample) => void): () => void;
+  onSample(
+    callback: (sample: GStreamerSample) => void,
+    options?: SampleSubscriptionOptions
+  ): () => void;
+  getPreroll(timeoutMs?: number): Promise<GStreamerSample | null>;
+  getVideoFrame(timeoutMs?: number): Promise<VideoFrame | null>;
+  getRegions(rects: RegionRect[], options?: RegionOptions): Promise<RegionBatch | null>;
+  step(amount: number, options?: StepOptions): Promise<GStreamerSample | null>;
 } & ElementBase;
 
+// Options for AppSrcElement.setMemorySource()
+export type MemorySourceOptions = {
+  blockSize?: number; // Bytes per buffer when pushing, pulling demuxers pick their own (64 KiB)
+  caps?: string; // Caps of the data, downstream typefinds it when not given
+};
+
+// Options for AppSrcElement.setAllocator()
+export type AllocatorOptions = {
+  alignment?: number | "page"; // Power of two up to the page size (default 64)
+  hugePages?: boolean; // Back slabs with huge pages where the system allows it (default false)
+};
+
+export type AllocatorStats = {
+  alignment: number;
+  allocations: number;
+  recycled: number; // Allocations served from a free list instead of new memory
+  slabs: number;
+  largeAllocations: number; // Buffers beyond the largest size class, not recycled
+  bytesInUse: number; // Rounded up to the size class
+  peakBytesInUse: number;
+  bytesReserved: number; // Slab memory, kept until the allocator is replaced and drained
+  hugePageBytes: number; // Slab memory backed by or advised to use huge pages
+};
+
+// Options for AppSrcElement.pumpFrom()
+export type PumpOptions = {
+  chunkSize?: number; // Bytes per read and at most per buffer (default 65536)
+  readahead?: number; // Bytes queued in the app source before reading pauses (default 1 MiB)
+  endOfStream?: boolean; // Send EOS at end of file (default true)
+};
+
+export type PumpResult = {
+  bytes: number;
+  buffers: number;
+  stopped: boolean; // Ended by stop() or a stopping pipeline instead of end of file
+};
+
+// A native thread reading a file descriptor into an app source
+export type Pump = {
+  done: Promise<PumpResult>; // Rejects on read errors
+  // On Windows, a read blocked on a console only ends once the console delivers input
+  stop: () => void;
+};
+
 export type AppSrcElement = {
   readonly type: "app-src-element";
   push(buffer: Buffer, pts?: Buffer | number): void;
   endOfStream(): void;
+  // Serve a whole file from memory as a seekable (random-access) stream, without copying
+  setMemorySource(
+    data: Buffer | ArrayBuffer | ArrayBufferView,
+    options?: MemorySourceOptions
+  ): void;
+  // Read a file, pipe or socket descriptor on a native thread, the data never enters JS
+  pumpFrom(fd: number, options?: PumpOptions): Pump;
+  // Aligned, recycled memory for push(), null returns to the default allocator
+  setAllocator(options: AllocatorOptions | null): void;
+  getAllocatorStats(): AllocatorStats | null;
 } & ElementBase;
 
+// Options accepted by the Pipeline constructor
+export type PipelineOptions = {
+  // Process as fast as possible: disables sync and QoS on every sink and runs without a clock
+  offline?: boolean;
+};
+
+// Wall-clock throughput returned by getThroughput()
+export type ThroughputReport = {
+  wallSeconds: number; // Time spent in PLAYING
+  mediaSeconds: number; // Media time processed, -1 if unknown
+  realtimeFactor: number; // mediaSeconds / wallSeconds
+  finished: boolean; // True once the pipeline reached end of stream
+};
+
+// Options for Pipeline.link()
+export type LinkOptions = {
+  // Pad names, or request pad templates such as "src_%u"; free or request pads are used if omitted
+  srcPad?: string;
+  sinkPad?: string;
+  timeoutMs?: number;
+};
+
+// Options for Pipeline.removeElement()
+export type RemoveElementOptions = {
+  // Send EOS into the element after detaching it and wait for its sinks to finish (default false)
+  eos?: boolean;
+  // Bounds the idle wait and the drain. A drain that times out still removes the element, but
+  // the promise rejects.
+  timeoutMs?: number;
+};
+
+// Options for Pipeline.enableTracers()
+export type TracerOptions = {
+  // Parameter string per tracer, e.g. { latency: "flags=pipeline+element" }
+  params?: Record<string, string>;
+};
+
+// Distribution of one numeric tracer field (times in nanoseconds)
+export type TracerFieldStats = {
+  count: number;
+  min: number;
+  max: number;
+  mean: number;
+  p50: number;
+  p95: number;
+  p99: number;
+};
+
+// Aggregated tracer records: record name -> element (or "src->sink" pair) -> field -> stats
+export type TracerStats = Record<string, Record<string, Record<string, TracerFieldStats>>>;
+
+// Per-buffer processing time distribution of one element (nanoseconds)
+export type ProcessingStats = {
+  count: number;
+  totalNs: number;
+  mean: number;
+  p50: number;
+  p95: number;
+  p99: number;
+  max: number;
+};
+
+// One element in a profiler snapshot
+export type ElementProfile = {
+  name: string;
+  factory: string;
+  type: "source" | "sink" | "element";
+  buffersIn: number;
+  buffersOut: number;
+  bytesIn: number;
+  bytesOut: number;
+  buffersPerSecond: number; // Output rate, input rate for sinks
+  bytesPerSecond: number;
+  processing: ProcessingStats | null; // Null when no in-to-out time was measured (sources, sinks)
+  share: number; // Fraction of all measured processing time (0-1)
+  threads: { name: string; buffers: number; busyNs: number }[];
+};
+
+export type ProfileSnapshot = {
+  elapsedSeconds: number;
+  elements: ElementProfile[]; // Ranked by total processing time, most expensive first
+};
+
+// Handle returned by Pipeline.startProfiler()
+export type Profiler = {
+  snapshot(): ProfileSnapshot;
+  stop(): void;
+};
+
+// Options for Pipeline.monitorQueues()
+export type QueueMonitorOptions = {
+  intervalMs?: number; // Sampling period (default 1000)
+  historyLength?: number; // Fill samples kept per queue (default 60)
+  saturation?: number; // Fill ratio at which a queue counts as saturated (default 0.9)
+};
+
+// Fill level of one queue, or of one multiqueue single queue ("mq0:src_0")
+export type QueueLevel = {
+  name: string;
+  element: string;
+  factory: "queue" | "queue2" | "multiqueue";
+  fill: number; // 0-1, against the most constrained of the limits
+  level: { buffers: number; bytes: number; time: number }; // time in nanoseconds
+  limits: { buffers: number; bytes: number; time: number }; // 0 means unlimited
+  underruns: number; // Totals since monitoring started (queue and multiqueue only)
+  overruns: number;
+  history: Float64Array; // Fill ratios, oldest first
+};
+
+// One batch delivered by Pipeline.monitorQueues()
+export type QueueReport = {
+  timestamp: number; // Milliseconds since the epoch
+  queues: QueueLevel[];
+  // The saturated queue closest to the sinks and the first element it feeds
+  bottleneck: { queue: string; suspect: string | null; fill: number } | null;
+};
+
+// Scheduling settings for streaming threads (Linux only)
+export type ThreadSettings = {
+  cpus?: number[]; // CPU affinity
+  nice?: number; // -20 to 19
+  policy?: "other" | "batch" | "idle" | "fifo" | "rr";
+  priority?: number; // 1-99, for "fifo" and "rr"
+  namePrefix?: string; // Threads are named prefix + element name (15 characters max)
+};
+
+export type ThreadPolicy = ThreadSettings & {
+  // Per-element settings replacing the defaults for threads owned by that element
+  elements?: Record<string, ThreadSettings>;
+};
+
+// A running streaming thread with its settings as reported by the kernel
+export type ThreadAssignment = {
+  tid: number;
+  element: string; // Element owning the task
+  pad: string; // Pad running the task, empty for element tasks
+  name: string;
+  cpus: number[];
+  nice: number | null;
+  policy: "other" | "batch" | "idle" | "fifo" | "rr" | null;
+  priority: number | null;
+  errors: string[]; // Settings that could not be applied (e.g. missing CAP_SYS_NICE)
+};
+
+// Options for convertSample(), the source frame is kept when nothing is given
+export type ConvertSampleOptions = {
+  format?: string; // GStreamer video format name, e.g. "RGBA" or "NV12"
+  // A single dimension scales the other one to keep the aspect ratio of the source area
+  width?: number;
+  height?: number;
+  crop?: { x?: number; y?: number; width?: number; height?: number }; // Source area in pixels
+  threads?: number; // Converter threads (default: number of processors)
+};
+
+// Options for encodeSample()
+export type EncodeSampleOptions = {
+  codec?: "jpeg" | "png" | "webp"; // WebP needs webpenc from gst-plugins-bad (default "jpeg")
+  quality?: number; // 0-100, ignored for PNG (default 85)
+};
+
 interface Pipeline {
   play(timeoutMs?: number): Promise<StateChangeResult>;
   pause(timeoutMs?: number): Promise<StateChangeResult>;
@@ -144,12 +607,24 @@ interface Pipeline {
   queryPosition(): number;
   queryDuration(): number;
   busPop(timeoutMs?: number): Promise<GstMessage | null>;
-  seek(positionSeconds: number): boolean;
+  seek(positionSeconds: number, options?: SeekOptions): boolean;
   endOfStream(): boolean;
+  getThroughput(): ThroughputReport;
+  addBin(description: string, name?: string): Element;
+  link(source: string, sink: string, options?: LinkOptions): Promise<boolean>;
+  unlink(source: string, sink: string, options?: { timeoutMs?: number }): Promise<boolean>;
+  removeElement(name: string, options?: RemoveElementOptions): Promise<boolean>;
+  enableTracers(tracers: string[], options?: TracerOptions): void;
+  getTracerStats(options?: { reset?: boolean }): TracerStats;
+  disableTracers(): void;
+  startProfiler(): Profiler;
+  monitorQueues(callback: (report: QueueReport) => void, options?: QueueMonitorOptions): () => void;
+  setThreadPolicy(policy: ThreadPolicy | null): void;
+  getThreadAssignments(): ThreadAssignment[];
 }
 
 interface PipelineConstructor {
-  new (pipeline: string): Pipeline;
+  new (pipeline: string, options?: PipelineOptions): Pipeline;
   elementExists(elementName: string): boolean;
 }
 
@@ -159,6 +634,9 @@ interface NativeAddon {
   GStreamerPropertyValue: GStreamerPropertyValue;
   GStreamerSample: GStreamerSample;
   GStreamerPropertyReturnValue: GStreamerPropertyReturnValue;
+  convertSample(sample: GStreamerSample, options?: ConvertSampleOptions): Promise<GStreamerSample>;
+  encodeSample(sample: GStreamerSample, options?: EncodeSampleOptions): Promise<Buffer>;
+  loadKeyframeIndex(path: string): Promise<KeyframeIndex>;
 }
 
 // Create require function for ESM
@@ -187,8 +665,22 @@ export const GstBufferFlags = {
   GST_BUFFER_FLAG_LAST: 1048576,
 } as const;
 
-const { Pipeline: PipelineClass } = nativeAddon;
+/**
+ * Number of differing bits between two fingerprints. Near-duplicate frames are usually
+ * within a distance of 10.
+ * */
+export const hammingDistance = (a: bigint, b: bigint): number => {
+  let bits = BigInt.asUintN(64, a ^ b);
+  let count = 0;
+  while (bits) {
+    bits &= bits - 1n;
+    count++;
+  }
+  return count;
+};
+
+const { Pipeline: PipelineClass, convertSample, encodeSample, loadKeyframeIndex } = nativeAddon;
 
-export { PipelineClass as Pipeline };
+export { PipelineClass as Pipeline, convertSample, encodeSample, loadKeyframeIndex };
 
-export default { ...nativeAddon, GstBufferFlags };
+export default { ...nativeAddon, GstBufferFlags, hammingDistance };
@@ -0,0 +1,52 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { waitForEos } from "./test-utils";
+
+describe("Pipeline Offline Mode", () => {
+  it("should disable sync and qos on sinks", () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink name=sink sync=true qos=true", {
+      offline: true,
+    });
+    const sink = pipeline.getElementByName("sink");
+
+    expect(sink?.getElementProperty("sync")?.value).toBe(false);
+    expect(sink?.getElementProperty("qos")?.value).toBe(false);
+  });
+
+  it("should leave sinks untouched without the option", () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink name=sink sync=true");
+    const sink = pipeline.getElementByName("sink");
+
+    expect(sink?.getElementProperty("sync")?.value).toBe(true);
+  });
+
+  it("should process faster than realtime", async () => {
+    // Five seconds of media at 30fps
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=150 ! video/x-raw,width=64,height=48,framerate=30/1 ! fakesink sync=true",
+      { offline: true }
+    );
+
+    await pipeline.play();
+    const message = await waitForEos(pipeline);
+    const report = pipeline.getThroughput();
+    await pipeline.stop();
+
+    expect(message?.type).toBe("eos");
+    expect(report.finished).toBe(true);
+    expect(report.wallSeconds).toBeLessThan(5);
+    if (report.mediaSeconds !== -1) {
+      expect(report.mediaSeconds).toBeCloseTo(5, 0);
+      expect(report.realtimeFactor).toBeGreaterThan(1);
+    }
+  });
+
+  it("should report an unfinished run before end of stream", () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink");
+    const report = pipeline.getThroughput();
+
+    expect(report.finished).toBe(false);
+    expect(report.wallSeconds).toBe(0);
+    expect(report.realtimeFactor).toBe(0);
+  });
+});
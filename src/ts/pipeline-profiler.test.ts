@@ -0,0 +1,86 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { waitForEos } from "./test-utils";
+
+describe("Pipeline Profiler", () => {
+  it("should measure every element in the pipeline", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc name=src num-buffers=50 ! video/x-raw,width=320,height=240 ! " +
+        "videoconvert name=convert ! queue name=q ! fakesink name=sink",
+      { offline: true }
+    );
+    const profiler = pipeline.startProfiler();
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    const snapshot = profiler.snapshot();
+    profiler.stop();
+    await pipeline.stop();
+
+    const byName = Object.fromEntries(snapshot.elements.map(element => [element.name, element]));
+
+    expect(snapshot.elapsedSeconds).toBeGreaterThan(0);
+    expect(byName["src"]?.type).toBe("source");
+    expect(byName["src"]?.buffersOut).toBe(50);
+    expect(byName["src"]?.processing).toBeNull();
+    expect(byName["sink"]?.type).toBe("sink");
+    expect(byName["sink"]?.buffersIn).toBe(50);
+    expect(byName["convert"]?.processing?.count).toBe(50);
+    expect(byName["convert"]?.threads.length).toBeGreaterThan(0);
+  });
+
+  it("should time elements for every profiler on the same pipeline", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=50 ! videoconvert name=convert ! fakesink",
+      { offline: true }
+    );
+    const profilers = [pipeline.startProfiler(), pipeline.startProfiler()];
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    const snapshots = profilers.map(profiler => profiler.snapshot());
+    profilers.forEach(profiler => profiler.stop());
+    await pipeline.stop();
+
+    for (const snapshot of snapshots) {
+      const convert = snapshot.elements.find(element => element.name === "convert");
+      expect(convert?.processing?.count).toBe(50);
+    }
+  });
+
+  it("should rank elements by total processing time", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc num-buffers=30 ! identity name=cheap ! " +
+        "identity name=slow sleep-time=2000 ! fakesink",
+      { offline: true }
+    );
+    const profiler = pipeline.startProfiler();
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    const { elements } = profiler.snapshot();
+    profiler.stop();
+    await pipeline.stop();
+
+    expect(elements[0]?.name).toBe("slow");
+    expect(elements[0]?.processing?.p50).toBeGreaterThan(1_000_000);
+
+    const totalShare = elements.reduce((sum, element) => sum + element.share, 0);
+    expect(totalShare).toBeCloseTo(1, 5);
+  });
+
+  it("should stop counting after stop()", async () => {
+    const pipeline = new Pipeline("videotestsrc num-buffers=20 ! fakesink name=sink", {
+      offline: true,
+    });
+    const profiler = pipeline.startProfiler();
+    profiler.stop();
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    const { elements } = profiler.snapshot();
+    await pipeline.stop();
+
+    expect(elements.find(element => element.name === "sink")?.buffersIn).toBe(0);
+  });
+});
@@ -0,0 +1,73 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, type QueueReport } from ".";
+import { sleep } from "./test-utils";
+
+const collectReports = (pipeline: InstanceType<typeof Pipeline>, intervalMs = 50) => {
+  const reports: QueueReport[] = [];
+  const stop = pipeline.monitorQueues(report => reports.push(report), { intervalMs });
+  return { reports, stop };
+};
+
+describe("Pipeline Queue Monitor", () => {
+  it("should report every queue in one batch", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc is-live=true ! queue name=q1 ! videoconvert ! queue2 name=q2 ! fakesink"
+    );
+    const { reports, stop } = collectReports(pipeline);
+
+    await pipeline.play();
+    await sleep(300);
+    stop();
+    await pipeline.stop();
+
+    expect(reports.length).toBeGreaterThan(0);
+    const names = reports.at(-1)?.queues.map(queue => queue.name);
+    expect(names).toContain("q1");
+    expect(names).toContain("q2");
+
+    const q1 = reports.at(-1)?.queues.find(queue => queue.name === "q1");
+    expect(q1?.factory).toBe("queue");
+    expect(q1?.limits.buffers).toBe(200);
+    expect(q1?.fill).toBeGreaterThanOrEqual(0);
+    expect(q1?.fill).toBeLessThanOrEqual(1);
+    expect(q1?.history.length).toBeGreaterThan(0);
+  });
+
+  it("should flag the queue in front of a slow element", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc ! queue name=q max-size-buffers=5 ! identity name=slow sleep-time=50000 ! " +
+        "fakesink sync=false"
+    );
+    const { reports, stop } = collectReports(pipeline);
+
+    await pipeline.play();
+    await sleep(500);
+    stop();
+    await pipeline.stop();
+
+    const bottleneck = reports.at(-1)?.bottleneck;
+    expect(bottleneck?.queue).toBe("q");
+    expect(bottleneck?.suspect).toBe("slow");
+    expect(reports.at(-1)?.queues[0]?.overruns).toBeGreaterThan(0);
+  });
+
+  it("should stop delivering after stop()", async () => {
+    const pipeline = new Pipeline("videotestsrc is-live=true ! queue ! fakesink");
+    const { reports, stop } = collectReports(pipeline);
+
+    await pipeline.play();
+    await sleep(150);
+    stop();
+    const count = reports.length;
+    await sleep(200);
+    await pipeline.stop();
+
+    expect(reports.length).toBe(count);
+  });
+
+  it("should validate arguments", () => {
+    const pipeline = new Pipeline("videotestsrc ! queue ! fakesink");
+    expect(() => (pipeline.monitorQueues as any)()).toThrow("callback");
+    expect(() => pipeline.monitorQueues(() => {}, { intervalMs: 0 })).toThrow("intervalMs");
+  });
+});
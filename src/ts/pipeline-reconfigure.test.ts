@@ -0,0 +1,101 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, type GStreamerSample } from ".";
+
+describe("Pipeline Reconfiguration", () => {
+  it("should add a branch to a tee while playing", async () => {
+    const pipeline = new Pipeline("videotestsrc is-live=true ! tee name=t ! queue ! fakesink");
+
+    await pipeline.play();
+
+    const bin = pipeline.addBin("queue ! appsink name=branch", "branch-bin");
+    expect(bin.type).toBe("element");
+
+    await expect(pipeline.link("t", "branch-bin")).resolves.toBe(true);
+
+    const sink = pipeline.getElementByName("branch");
+    if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+    const sample: GStreamerSample | null = await sink.getSample(2000);
+
+    await pipeline.stop();
+
+    expect(sample?.buffer).toBeDefined();
+  });
+
+  it("should remove a branch while the rest keeps playing", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc is-live=true ! tee name=t ! queue ! appsink name=main " +
+        "t. ! queue name=extra ! fakesink"
+    );
+    const main = pipeline.getElementByName("main");
+    if (main?.type !== "app-sink-element") throw new Error("Expected app sink element");
+
+    await pipeline.play();
+
+    await expect(pipeline.removeElement("extra")).resolves.toBe(true);
+    expect(pipeline.getElementByName("extra")).toBeNull();
+
+    // Drain whatever was queued before the removal, then expect new frames
+    await main.getSample(1000);
+    const sample = await main.getSample(1000);
+
+    expect(pipeline.playing()).toBe(true);
+    await pipeline.stop();
+
+    expect(sample?.buffer).toBeDefined();
+  });
+
+  it("should reject when draining a removed branch times out", async () => {
+    const pipeline = new Pipeline("videotestsrc is-live=true ! tee name=t ! queue ! fakesink");
+    // Nobody pulls from the app sink, so EOS stays stuck in the queue in front of it
+    pipeline.addBin("queue ! appsink max-buffers=1", "stuck");
+
+    await pipeline.play();
+    await expect(pipeline.link("t", "stuck")).resolves.toBe(true);
+    await new Promise(resolve => setTimeout(resolve, 200));
+
+    await expect(pipeline.removeElement("stuck", { eos: true, timeoutMs: 300 })).rejects.toThrow(
+      "Timed out draining stuck"
+    );
+    expect(pipeline.getElementByName("stuck")).toBeNull();
+    expect(pipeline.playing()).toBe(true);
+
+    await pipeline.stop();
+  });
+
+  it("should unlink and relink elements", async () => {
+    const pipeline = new Pipeline("videotestsrc is-live=true ! tee name=t ! queue ! fakesink");
+    pipeline.addBin("queue ! fakesink", "branch");
+
+    await pipeline.play();
+
+    await expect(pipeline.link("t", "branch")).resolves.toBe(true);
+    await expect(pipeline.unlink("t", "branch")).resolves.toBe(true);
+    await expect(pipeline.link("t", "branch")).resolves.toBe(true);
+
+    await pipeline.stop();
+  });
+
+  it("should reject for unknown elements", async () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink name=sink");
+
+    await expect(pipeline.link("missing", "sink")).rejects.toThrow("Element not found: missing");
+    await expect(pipeline.removeElement("missing")).rejects.toThrow("Element not found");
+  });
+
+  it("should reject unlinking elements that are not linked", async () => {
+    const pipeline = new Pipeline("videotestsrc name=src ! fakesink fakesink name=other");
+
+    await expect(pipeline.unlink("src", "other")).rejects.toThrow("src is not linked to other");
+  });
+
+  it("should throw for invalid bin descriptions", () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink");
+
+    expect(() => pipeline.addBin("nonexistentelement123")).toThrow();
+    expect(() => {
+      // @ts-expect-error Testing missing argument
+      pipeline.addBin();
+    }).toThrow("addBin() requires a string argument");
+  });
+});
@@ -0,0 +1,90 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline, type ThreadPolicy } from ".";
+
+const linuxOnly = process.platform === "linux" ? it : it.skip;
+
+// Streaming threads report themselves asynchronously once their task starts
+const settle = () => new Promise(resolve => setTimeout(resolve, 100));
+
+describe("Pipeline Thread Policy", () => {
+  linuxOnly("should track streaming threads while playing", async () => {
+    const pipeline = new Pipeline("videotestsrc is-live=true name=src ! queue name=q ! fakesink");
+
+    await pipeline.play();
+    await settle();
+    const assignments = pipeline.getThreadAssignments();
+    await pipeline.stop();
+
+    const elements = assignments.map(assignment => assignment.element);
+    expect(elements).toContain("src");
+    expect(elements).toContain("q");
+    expect(assignments[0]?.tid).toBeGreaterThan(0);
+    expect(assignments[0]?.cpus.length).toBeGreaterThan(0);
+    expect(pipeline.getThreadAssignments()).toEqual([]);
+  });
+
+  linuxOnly("should apply affinity and names to new threads", async () => {
+    const pipeline = new Pipeline("videotestsrc is-live=true name=src ! queue name=q ! fakesink");
+    pipeline.setThreadPolicy({ cpus: [0], namePrefix: "gk-" });
+
+    await pipeline.play();
+    await settle();
+    const assignments = pipeline.getThreadAssignments();
+    await pipeline.stop();
+
+    expect(assignments.length).toBeGreaterThan(0);
+    for (const assignment of assignments) {
+      expect(assignment.cpus).toEqual([0]);
+      expect(assignment.name).toBe(`gk-${assignment.element}`.slice(0, 15));
+      expect(assignment.errors).toEqual([]);
+    }
+  });
+
+  linuxOnly("should apply per-element overrides to running threads", async () => {
+    const pipeline = new Pipeline("videotestsrc is-live=true name=src ! queue name=q ! fakesink");
+
+    await pipeline.play();
+    await settle();
+    pipeline.setThreadPolicy({ nice: 5, elements: { q: { nice: 10 } } });
+    const assignments = pipeline.getThreadAssignments();
+    await pipeline.stop();
+
+    expect(assignments.find(assignment => assignment.element === "src")?.nice).toBe(5);
+    expect(assignments.find(assignment => assignment.element === "q")?.nice).toBe(10);
+  });
+
+  linuxOnly("should not carry a policy over to threads of other pipelines", async () => {
+    const description = "videotestsrc is-live=true name=src ! queue name=q ! fakesink";
+    const run = async (policy?: ThreadPolicy) => {
+      const pipeline = new Pipeline(description);
+      if (policy) pipeline.setThreadPolicy(policy);
+      await pipeline.play();
+      await settle();
+      const assignments = pipeline.getThreadAssignments();
+      await pipeline.stop();
+      return assignments;
+    };
+
+    const before = await run();
+    const configured = await run({ cpus: [0], nice: 5, namePrefix: "gk-" });
+    const after = await run();
+
+    expect(configured.every(assignment => assignment.nice === 5)).toBe(true);
+    expect(after.length).toBeGreaterThan(0);
+    for (const assignment of after) {
+      expect(assignment.cpus).toEqual(before[0]?.cpus);
+      expect(assignment.nice).toBe(before[0]?.nice);
+      expect(assignment.policy).toBe(before[0]?.policy);
+      expect(assignment.name.startsWith("gk-")).toBe(false);
+    }
+  });
+
+  linuxOnly("should validate the policy", () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink");
+
+    expect(() => pipeline.setThreadPolicy({ nice: 40 })).toThrow("nice");
+    expect(() => pipeline.setThreadPolicy({ policy: "fifo" })).toThrow("priority");
+    expect(() => pipeline.setThreadPolicy({ policy: "bogus" as any })).toThrow("policy");
+    expect(() => pipeline.setThreadPolicy(null)).not.toThrow();
+  });
+});
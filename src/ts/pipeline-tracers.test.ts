@@ -0,0 +1,130 @@
+import { describe, expect, it } from "vitest";
+import { Pipeline } from ".";
+import { waitForEos } from "./test-utils";
+
+describe("Pipeline Tracers", () => {
+  it("should aggregate per-element latency", async () => {
+    const pipeline = new Pipeline(
+      "videotestsrc name=src num-buffers=60 ! videoconvert name=convert ! fakesink name=sink",
+      { offline: true }
+    );
+    pipeline.enableTracers(["latency"]);
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    const stats = pipeline.getTracerStats();
+    await pipeline.stop();
+
+    const elementLatency = stats["element-latency"];
+    expect(elementLatency).toBeDefined();
+    expect(elementLatency?.["convert"]?.["time"]?.count).toBeGreaterThan(0);
+
+    const time = elementLatency?.["convert"]?.["time"];
+    if (time) {
+      expect(time.min).toBeLessThanOrEqual(time.p50);
+      expect(time.p50).toBeLessThanOrEqual(time.p99);
+      expect(time.p99).toBeLessThanOrEqual(time.max);
+    }
+  });
+
+  it("should only report elements of its own pipeline", async () => {
+    const first = new Pipeline("videotestsrc num-buffers=30 ! identity name=first ! fakesink", {
+      offline: true,
+    });
+    const second = new Pipeline("videotestsrc num-buffers=30 ! identity name=second ! fakesink", {
+      offline: true,
+    });
+    first.enableTracers(["latency"]);
+
+    await Promise.all([first.play(), second.play()]);
+    await Promise.all([waitForEos(first), waitForEos(second)]);
+    const stats = first.getTracerStats();
+    await Promise.all([first.stop(), second.stop()]);
+
+    expect(stats["element-latency"]?.["second"]).toBeUndefined();
+  });
+
+  it("should tell apart elements with the same name in other pipelines", async () => {
+    const first = new Pipeline("videotestsrc num-buffers=30 ! identity name=same ! fakesink", {
+      offline: true,
+    });
+    const second = new Pipeline("videotestsrc num-buffers=300 ! identity name=same ! fakesink", {
+      offline: true,
+    });
+    first.enableTracers(["latency"]);
+
+    await Promise.all([first.play(), second.play()]);
+    await Promise.all([waitForEos(first), waitForEos(second)]);
+    const stats = first.getTracerStats();
+    await Promise.all([first.stop(), second.stop()]);
+
+    // At most one record per buffer of the first pipeline
+    const count = stats["element-latency"]?.["same"]?.["time"]?.count ?? 0;
+    expect(count).toBeGreaterThan(0);
+    expect(count).toBeLessThanOrEqual(30);
+  });
+
+  it("should report elements added after tracing started", async () => {
+    const pipeline = new Pipeline("videotestsrc num-buffers=60 ! tee name=t ! fakesink", {
+      offline: true,
+    });
+    pipeline.enableTracers(["latency"]);
+    pipeline.addBin("identity name=late ! fakesink", "late-bin");
+
+    await expect(pipeline.link("t", "late-bin")).resolves.toBe(true);
+    await pipeline.play();
+    await waitForEos(pipeline);
+    const stats = pipeline.getTracerStats();
+    await pipeline.stop();
+
+    expect(stats["element-latency"]?.["late"]?.["time"]?.count).toBeGreaterThan(0);
+  });
+
+  it("should attribute pad-level records to their pipeline", async () => {
+    const first = new Pipeline("videotestsrc num-buffers=30 ! identity name=mine ! fakesink", {
+      offline: true,
+    });
+    const second = new Pipeline("videotestsrc num-buffers=30 ! identity name=theirs ! fakesink", {
+      offline: true,
+    });
+    first.enableTracers(["interlatency"]);
+
+    await Promise.all([first.play(), second.play()]);
+    await Promise.all([waitForEos(first), waitForEos(second)]);
+    const stats = first.getTracerStats();
+    await Promise.all([first.stop(), second.stop()]);
+
+    const pads = Object.keys(stats["interlatency"] ?? {});
+    expect(pads.some(key => key.includes("mine_"))).toBe(true);
+    expect(pads.some(key => key.includes("theirs_"))).toBe(false);
+  });
+
+  it("should reset stats when requested", async () => {
+    const pipeline = new Pipeline("videotestsrc num-buffers=30 ! identity name=id ! fakesink", {
+      offline: true,
+    });
+    pipeline.enableTracers(["latency"]);
+
+    await pipeline.play();
+    await waitForEos(pipeline);
+    pipeline.getTracerStats({ reset: true });
+    const stats = pipeline.getTracerStats();
+    await pipeline.stop();
+
+    expect(stats).toEqual({});
+  });
+
+  it("should return empty stats when tracers are disabled", () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink");
+    expect(pipeline.getTracerStats()).toEqual({});
+
+    pipeline.enableTracers(["latency"]);
+    pipeline.disableTracers();
+    expect(pipeline.getTracerStats()).toEqual({});
+  });
+
+  it("should throw on unknown tracers", () => {
+    const pipeline = new Pipeline("videotestsrc ! fakesink");
+    expect(() => pipeline.enableTracers(["no-such-tracer"])).toThrow("Tracer not found");
+  });
+});
@@ -20,3 +20,49 @@ export const arePluginsAvailable = (plugins: string[]) =>
   plugins.every(plugin => isPluginAvailable(plugin));
 
 export const isWindows = process.platform === "win32";
+
+export const sleep = (ms: number) => new Promise(resolve => setTimeout(resolve, ms));
+
+/**
+ * Pop bus messages until the pipeline reports EOS or an error, or the bus stays quiet for 5s
+ */
+export const waitForEos = async (pipeline: InstanceType<typeof Pipeline>) => {
+  while (true) {
+    const message = await pipeline.busPop(5000);
+    if (!message || message.type === "eos" || message.type === "error") return message;
+  }
+};
+
+/**
+ * Play a pipeline to the end while `subscribe` collects results, then give queued callbacks
+ * time to run before unsubscribing
+ */
+export const collectUntilEos = async <T>(
+  pipeline: InstanceType<typeof Pipeline>,
+  subscribe: (push: (result: T) => void) => (() => void) | undefined
+) => {
+  const results: T[] = [];
+
+  const stop = subscribe(result => results.push(result));
+  await pipeline.play();
+  await waitForEos(pipeline);
+  await sleep(50);
+  stop?.();
+  await pipeline.stop();
+
+  return results;
+};
+
+export const getAppSink = (pipeline: InstanceType<typeof Pipeline>, name = "sink") => {
+  const sink = pipeline.getElementByName(name);
+  if (sink?.type !== "app-sink-element") throw new Error("Expected app sink element");
+  return sink;
+};
+
+/**
+ * Build a pipeline from `description` ending in an app sink named "sink"
+ */
+export const createAppSinkPipeline = (description: string) => {
+  const pipeline = new Pipeline(`${description} ! appsink name=sink`);
+  return { pipeline, sink: getAppSink(pipeline) };
+};